@@ -24,10 +24,12 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 using System;
+using System.IO;
 using Xamarin.AsyncTests;
 using Xamarin.AsyncTests.Console;
 using Xamarin.WebTests.ConnectionFramework;
 using Xamarin.WebTests.TestProvider;
+using Mono.Security.NewTls.TestFramework;
 using Mono.Security.NewTls.TestProvider;
 
 [assembly: AsyncTestSuite (typeof (Mono.Security.NewTls.Tests.NewTlsTestFeatures), true)]
@@ -38,10 +40,39 @@ namespace Mono.Security.NewTls.Console
 	{
 		static void Main (string[] args)
 		{
+			// OpenSsl only accepts these before its first allocation, so this must come first.
+			if (Environment.GetEnvironmentVariable ("NEWTLS_OPENSSL_MEMORY_HOOKS") == "1")
+				NativeOpenSsl.InstallMemoryHooks ();
+
 			DependencyInjector.RegisterAssembly (typeof(NewTlsDependencyProvider).Assembly);
 			DependencyInjector.RegisterAssembly (typeof(WebDependencyProvider).Assembly);
-			DependencyInjector.RegisterCollection<IConnectionProviderFactoryExtension> (new OpenSslConnectionProviderFactory ());
+
+			// Run the OpenSsl connection tests on the native I/O thread.
+			var openSslFactory = new OpenSslConnectionProviderFactory ();
+			openSslFactory.UseAsyncIO = Environment.GetEnvironmentVariable ("NEWTLS_OPENSSL_ASYNC_IO") == "1";
+
+			// Shared with other runners which use the same name, e.g. "/newtls-4433".
+			var sessionCache = Environment.GetEnvironmentVariable ("NEWTLS_OPENSSL_SESSION_CACHE");
+			if (!string.IsNullOrEmpty (sessionCache))
+				openSslFactory.SessionCache = NativeOpenSslSessionCache.Open (sessionCache, 1024, TimeSpan.FromMinutes (5));
+
+			DependencyInjector.RegisterCollection<IConnectionProviderFactoryExtension> (openSslFactory);
+			DependencyInjector.RegisterDependency<IRenegotiationBenchmarkHost> (() => new NativeOpenSslRenegotiationBenchmark ());
+			DependencyInjector.RegisterDependency<INativePeerTestHost> (() => new NativeOpenSslTestHost ());
+
+			// Performance matrix: compare against a previous report and write a new one.
+			var baseline = Environment.GetEnvironmentVariable ("NEWTLS_PERFORMANCE_BASELINE");
+			if (!string.IsNullOrEmpty (baseline))
+				PerformanceMatrix.LoadBaseline (File.ReadAllText (baseline));
+
 			Program.Run (typeof (ConsoleDependencyProvider).Assembly, args);
+
+			if (PerformanceMatrix.Results.Count > 0) {
+				System.Console.WriteLine (PerformanceMatrix.FormatTable ());
+				var report = Environment.GetEnvironmentVariable ("NEWTLS_PERFORMANCE_REPORT");
+				if (!string.IsNullOrEmpty (report))
+					File.WriteAllText (report, PerformanceMatrix.FormatJson ());
+			}
 		}
 	}
 }
@@ -88,6 +88,14 @@ namespace Mono.Security.NewTls
 			get; set;
 		}
 
+		public int WriteCoalescingThreshold {
+			get; set;
+		}
+
+		public TimeSpan? WriteCoalescingDelay {
+			get; set;
+		}
+
 		#if INSTRUMENTATION
 
 		public Instrumentation Instrumentation {
@@ -54,6 +54,10 @@ namespace Mono.Security.NewTls.ConnectionFramework
 		Task Shutdown (IMonoSslStream stream);
 
 		Task RequestRenegotiation (IMonoSslStream stream);
+
+		int GetPendingWriteSize (IMonoSslStream stream);
+
+		long GetTransportWrites (IMonoSslStream stream);
 	}
 }
 
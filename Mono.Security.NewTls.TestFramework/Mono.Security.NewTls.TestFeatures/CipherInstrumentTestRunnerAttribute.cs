@@ -43,10 +43,20 @@ namespace Mono.Security.NewTls.TestFeatures
 		{
 		}
 
+		CipherInstrumentTestRunner CreateInstance (
+			TestContext ctx, IServer server, IClient client,
+			InstrumentationConnectionProvider provider, CipherInstrumentParameters parameters)
+		{
+			if (!CipherInstrumentTestRunner.IsSupported (parameters, client.Provider.Type, server.Provider.Type))
+				ctx.IgnoreThisTest ();
+
+			return new CipherInstrumentTestRunner (server, client, provider, parameters);
+		}
+
 		public CipherInstrumentTestRunner CreateInstance (TestContext ctx)
 		{
 			return ConnectionTestHelper.CreateTestRunner<InstrumentationConnectionProvider,CipherInstrumentParameters,CipherInstrumentTestRunner> (
-				ctx, (s, c, p, a) => new CipherInstrumentTestRunner (s, c, p, a));
+				ctx, (s, c, p, a) => CreateInstance (ctx, s, c, p, a));
 		}
 	}
 }
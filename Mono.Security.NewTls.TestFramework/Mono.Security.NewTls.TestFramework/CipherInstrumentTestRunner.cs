@@ -58,9 +58,19 @@ namespace Mono.Security.NewTls.TestFramework
 
 		protected override MonoConnectionHandler CreateConnectionHandler ()
 		{
+			if (Type == CipherInstrumentType.Performance)
+				return CreatePerformanceHandler ();
 			return new DefaultMonoConnectionHandler (this);
 		}
 
+		public static bool IsSupported (CipherInstrumentParameters parameters, ConnectionProviderType clientType, ConnectionProviderType serverType)
+		{
+			if (parameters.Type != CipherInstrumentType.Performance)
+				return true;
+
+			return IsPerformancePairingSupported (clientType, serverType);
+		}
+
 		public override Instrumentation CreateInstrument (TestContext ctx, MonoTlsSettings settings)
 		{
 			return null;
@@ -78,6 +88,9 @@ namespace Mono.Security.NewTls.TestFramework
 			case InstrumentationCategory.SelectCipher:
 				return ConnectionTypes.Select (t => Create (ctx, category, t));
 
+			case InstrumentationCategory.CipherPerformance:
+				return PerformanceTypes.Select (t => Create (ctx, category, t));
+
 			default:
 				ctx.AssertFail ("Unsupported instrumentation category: '{0}'.", category);
 				return null;
@@ -96,6 +109,10 @@ namespace Mono.Security.NewTls.TestFramework
 			CipherInstrumentType.SelectServerCipher
 		};
 
+		internal static readonly CipherInstrumentType[] PerformanceTypes = {
+			CipherInstrumentType.Performance
+		};
+
 		static IEnumerable<CipherInstrumentParameters> SelectAllCiphers (Func<ProtocolVersions,CipherSuiteCode,CipherInstrumentParameters> func)
 		{
 			foreach (var cipher in CipherList.CiphersTls10)
@@ -137,6 +154,11 @@ namespace Mono.Security.NewTls.TestFramework
 				parameters.ValidateCipherList = true;
 				break;
 
+			case CipherInstrumentType.Performance:
+				parameters.ProtocolVersion = ctx.GetParameter<ProtocolVersions> ();
+				parameters.ClientCiphers = parameters.ServerCiphers = new CipherSuiteCode[] { ctx.GetParameter<CipherSuiteCode> () };
+				break;
+
 			case CipherInstrumentType.InvalidCipher:
 				parameters.ServerCiphers = new CipherSuiteCode[] { CipherSuiteCode.TLS_DHE_RSA_WITH_AES_128_CBC_SHA };
 				parameters.ClientCiphers = new CipherSuiteCode[] { CipherSuiteCode.TLS_DHE_RSA_WITH_AES_256_CBC_SHA256 };
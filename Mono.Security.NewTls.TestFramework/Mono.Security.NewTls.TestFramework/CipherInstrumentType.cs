@@ -31,7 +31,8 @@ namespace Mono.Security.NewTls.TestFramework
 	{
 		SelectClientCipher,
 		SelectServerCipher,
-		InvalidCipher
+		InvalidCipher,
+		Performance
 	}
 }
 
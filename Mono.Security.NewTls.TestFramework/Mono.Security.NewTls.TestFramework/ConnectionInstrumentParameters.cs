@@ -43,6 +43,16 @@ namespace Mono.Security.NewTls.TestFramework
 		{
 			if (other.handshakeInstruments != null)
 				handshakeInstruments = new HashSet<HandshakeInstrumentType> (other.handshakeInstruments);
+			WriteCoalescingThreshold = other.WriteCoalescingThreshold;
+			WriteCoalescingDelay = other.WriteCoalescingDelay;
+		}
+
+		public int WriteCoalescingThreshold {
+			get; set;
+		}
+
+		public TimeSpan? WriteCoalescingDelay {
+			get; set;
 		}
 
 		HashSet<HandshakeInstrumentType> handshakeInstruments;
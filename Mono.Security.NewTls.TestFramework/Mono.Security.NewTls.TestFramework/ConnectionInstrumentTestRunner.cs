@@ -60,6 +60,8 @@ namespace Mono.Security.NewTls.TestFramework
 
 			var userSettings = new UserSettings (settings);
 			userSettings.EnableDebugging = Parameters.EnableDebugging;
+			userSettings.WriteCoalescingThreshold = Parameters.WriteCoalescingThreshold;
+			userSettings.WriteCoalescingDelay = Parameters.WriteCoalescingDelay;
 			var connectionInstrument = CreateConnectionInstrument (ctx, userSettings);
 
 			instrumentation.SettingsInstrument = connectionInstrument;
@@ -0,0 +1,98 @@
+﻿//
+// ConnectionPerformanceResult.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using Mono.Security.Interface;
+using Xamarin.WebTests.ConnectionFramework;
+
+namespace Mono.Security.NewTls.TestFramework
+{
+	public class ConnectionPerformanceResult
+	{
+		public ProtocolVersions Protocol {
+			get;
+			private set;
+		}
+
+		public CipherSuiteCode Cipher {
+			get;
+			private set;
+		}
+
+		public ConnectionProviderType ClientProvider {
+			get;
+			private set;
+		}
+
+		public ConnectionProviderType ServerProvider {
+			get;
+			private set;
+		}
+
+		public TimeSpan HandshakeTime {
+			get;
+			private set;
+		}
+
+		public long TransferredBytes {
+			get;
+			private set;
+		}
+
+		public TimeSpan TransferTime {
+			get;
+			private set;
+		}
+
+		// Bytes per second.
+		public double Throughput {
+			get { return TransferTime.Ticks > 0 ? TransferredBytes / TransferTime.TotalSeconds : 0.0; }
+		}
+
+		// Identifies the combination; results with the same key are comparable.
+		public string Key {
+			get { return string.Format ("{0}:{1}:{2}:{3}", Protocol, Cipher, ClientProvider, ServerProvider); }
+		}
+
+		public ConnectionPerformanceResult (
+			ProtocolVersions protocol, CipherSuiteCode cipher, ConnectionProviderType clientProvider, ConnectionProviderType serverProvider,
+			TimeSpan handshakeTime, long transferredBytes, TimeSpan transferTime)
+		{
+			Protocol = protocol;
+			Cipher = cipher;
+			ClientProvider = clientProvider;
+			ServerProvider = serverProvider;
+			HandshakeTime = handshakeTime;
+			TransferredBytes = transferredBytes;
+			TransferTime = transferTime;
+		}
+
+		public override string ToString ()
+		{
+			return string.Format ("[ConnectionPerformanceResult: {0}, HandshakeTime={1:F2} ms, TransferredBytes={2}, Throughput={3:F2} MB/s]",
+				Key, HandshakeTime.TotalMilliseconds, TransferredBytes, Throughput / (1024 * 1024));
+		}
+	}
+}
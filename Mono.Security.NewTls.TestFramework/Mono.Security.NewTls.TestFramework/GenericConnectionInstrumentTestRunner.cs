@@ -50,14 +50,29 @@ namespace Mono.Security.NewTls.TestFramework
 		{
 		}
 
+		new public GenericConnectionInstrumentParameters Parameters {
+			get { return (GenericConnectionInstrumentParameters)base.Parameters; }
+		}
+
 		protected override MonoConnectionHandler CreateConnectionHandler ()
 		{
-			return new ConnectionInstrumentConnectionHandler (this);
+			switch (Parameters.Type) {
+			case GenericConnectionInstrumentType.Performance:
+				return CreatePerformanceHandler ();
+			case GenericConnectionInstrumentType.WriteCoalescing:
+			case GenericConnectionInstrumentType.WriteCoalescingTimer:
+				return new WriteCoalescingConnectionHandler (this);
+			default:
+				return new ConnectionInstrumentConnectionHandler (this);
+			}
 		}
 
 		public static bool IsSupported (GenericConnectionInstrumentParameters parameters, ConnectionProviderType clientType, ConnectionProviderType serverType)
 		{
-			return true;
+			if (parameters.Type != GenericConnectionInstrumentType.Performance)
+				return true;
+
+			return IsPerformancePairingSupported (clientType, serverType);
 		}
 
 		public static IEnumerable<GenericConnectionInstrumentParameters> GetParameters (TestContext ctx, InstrumentationCategory category)
@@ -72,6 +87,8 @@ namespace Mono.Security.NewTls.TestFramework
 				yield return GenericConnectionInstrumentType.FragmentHandshakeMessages;
 				yield return GenericConnectionInstrumentType.SendBlobAfterReceivingFinish;
 				yield return GenericConnectionInstrumentType.InvalidClientCertificateV1;
+				yield return GenericConnectionInstrumentType.WriteCoalescing;
+				yield return GenericConnectionInstrumentType.WriteCoalescingTimer;
 				break;
 
 			case InstrumentationCategory.ServerConnection:
@@ -113,6 +130,10 @@ namespace Mono.Security.NewTls.TestFramework
 				yield return GenericConnectionInstrumentType.MartinTest;
 				break;
 
+			case InstrumentationCategory.ConnectionPerformance:
+				yield return GenericConnectionInstrumentType.Performance;
+				break;
+
 			default:
 				ctx.AssertFail ("Unsupported instrumentation category: '{0}'.", category);
 				break;
@@ -286,6 +307,19 @@ namespace Mono.Security.NewTls.TestFramework
 				parameters.Add (HandshakeInstrumentType.OverrideClientCertificateSelection);
 				break;
 
+			case GenericConnectionInstrumentType.Performance:
+				// Whatever the two providers negotiate by default.
+				break;
+
+			case GenericConnectionInstrumentType.WriteCoalescing:
+				parameters.WriteCoalescingThreshold = WriteCoalescingConnectionHandler.Threshold;
+				break;
+
+			case GenericConnectionInstrumentType.WriteCoalescingTimer:
+				parameters.WriteCoalescingThreshold = WriteCoalescingConnectionHandler.Threshold;
+				parameters.WriteCoalescingDelay = TimeSpan.FromMilliseconds (500);
+				break;
+
 			case GenericConnectionInstrumentType.MartinTest:
 				parameters.ClientCiphers = parameters.ServerCiphers = new CipherSuiteCode[] {
 					CipherSuiteCode.TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256
@@ -55,7 +55,12 @@ namespace Mono.Security.NewTls.TestFramework
 
 		MartinTest,
 		MartinClientPuppy,
-		MartinServerPuppy
+		MartinServerPuppy,
+
+		Performance,
+
+		WriteCoalescing,
+		WriteCoalescingTimer
 	}
 }
 
@@ -0,0 +1,93 @@
+﻿//
+// HandshakeReplayResult.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using Mono.Security.Interface;
+
+namespace Mono.Security.NewTls.TestFramework
+{
+	public class HandshakeReplayResult
+	{
+		public CipherSuiteCode Cipher {
+			get;
+			private set;
+		}
+
+		public bool IsServer {
+			get;
+			private set;
+		}
+
+		public int Iterations {
+			get;
+			private set;
+		}
+
+		public TimeSpan Elapsed {
+			get;
+			private set;
+		}
+
+		public double HandshakesPerSecond {
+			get { return Iterations / Elapsed.TotalSeconds; }
+		}
+
+		// Managed heap growth per handshake; -1 if every handshake was disturbed by a collection.
+		public long AllocatedBytesPerHandshake {
+			get;
+			private set;
+		}
+
+		// Records received from / sent to the peer in one handshake.
+		public int IncomingRecords {
+			get;
+			private set;
+		}
+
+		public int OutgoingRecords {
+			get;
+			private set;
+		}
+
+		public HandshakeReplayResult (CipherSuiteCode cipher, bool isServer, int iterations, TimeSpan elapsed,
+			long allocatedBytesPerHandshake, int incomingRecords, int outgoingRecords)
+		{
+			Cipher = cipher;
+			IsServer = isServer;
+			Iterations = iterations;
+			Elapsed = elapsed;
+			AllocatedBytesPerHandshake = allocatedBytesPerHandshake;
+			IncomingRecords = incomingRecords;
+			OutgoingRecords = outgoingRecords;
+		}
+
+		public override string ToString ()
+		{
+			return string.Format ("[HandshakeReplayResult: {0} {1}, {2} handshakes in {3} ({4:F1}/s), {5} bytes allocated per handshake, {6} records in, {7} out]",
+				Cipher, IsServer ? "server" : "client", Iterations, Elapsed, HandshakesPerSecond,
+				AllocatedBytesPerHandshake, IncomingRecords, OutgoingRecords);
+		}
+	}
+}
@@ -0,0 +1,52 @@
+﻿//
+// ICipherSuiteTestHost.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using Xamarin.AsyncTests;
+
+namespace Mono.Security.NewTls.TestFramework
+{
+	/*
+	 * Checks the cipher suite lists and the per-protocol descriptor tables which
+	 * CipherSuiteFactory builds from them.
+	 */
+	public interface ICipherSuiteTestHost : ITestInstance
+	{
+		/*
+		 * IndexOf(), Contains() and Remove() must agree with a linear scan of the list
+		 * after each kind of mutation, finding the first of several equal codes.
+		 */
+		void RunCollectionIndex (TestContext ctx);
+
+		/*
+		 * For each supported (protocol, code) pair, the descriptor must describe the
+		 * same cipher suite that CreateCipherSuite() returns.
+		 */
+		void RunDescriptors (TestContext ctx);
+
+		// Codes which the protocol doesn't support are rejected with InsuficientSecurity.
+		void RunUnsupportedCipher (TestContext ctx);
+	}
+}
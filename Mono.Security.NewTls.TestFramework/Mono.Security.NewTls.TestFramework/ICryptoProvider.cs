@@ -37,6 +37,14 @@ namespace Mono.Security.NewTls.TestFramework
 		IHashTestHost GetHashTestHost (CryptoProviderType type);
 
 		IEncryptionTestHost GetEncryptionTestHost (CryptoProviderType type, CryptoTestParameters parameters);
+
+		IEllipticCurveTestHost GetEllipticCurveTestHost (CryptoProviderType type);
+
+		IHandshakeReplayTestHost GetHandshakeReplayTestHost (CryptoProviderType type);
+
+		IRecordLayerTestHost GetRecordLayerTestHost (CryptoProviderType type);
+
+		ICipherSuiteTestHost GetCipherSuiteTestHost (CryptoProviderType type);
 	}
 }
 
@@ -44,6 +44,8 @@ namespace Mono.Security.NewTls.TestFramework
 
 		int Decrypt (IBufferOffsetSize input, IBufferOffsetSize output);
 
+		IBufferOffsetSize DecryptInPlace (IBufferOffsetSize input);
+
 		int BlockSize {
 			get;
 		}
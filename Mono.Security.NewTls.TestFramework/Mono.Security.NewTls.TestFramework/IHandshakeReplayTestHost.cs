@@ -0,0 +1,42 @@
+﻿//
+// IHandshakeReplayTestHost.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using Xamarin.AsyncTests;
+using Mono.Security.Interface;
+
+namespace Mono.Security.NewTls.TestFramework
+{
+	public interface IHandshakeReplayTestHost : ITestInstance
+	{
+		/*
+		 * Captures a TLS 1.2 handshake between two in-memory contexts whose random
+		 * number generators and clocks are fixed, then replays the records which the
+		 * client - or the server, if `server' is set - received from its peer into
+		 * `iterations' fresh contexts.  No sockets or streams are involved.
+		 */
+		HandshakeReplayResult Benchmark (CipherSuiteCode cipher, bool server, int iterations);
+	}
+}
@@ -0,0 +1,102 @@
+﻿//
+// INativePeerTestHost.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using Xamarin.AsyncTests;
+using Mono.Security.Interface;
+
+namespace Mono.Security.NewTls.TestFramework
+{
+	/*
+	 * Drives two native OpenSsl peers over loopback; only available in runners
+	 * which load the native library.
+	 */
+	public interface INativePeerTestHost : ITestInstance, ISingletonInstance
+	{
+		// Runs one handshake, optionally with TCP_QUICKACK requested on both sides.
+		NativeHandshakeResult RunHandshake (TestContext ctx, bool quickAck);
+
+		/*
+		 * Requests kernel TLS on one side only, so the other side's OpenSsl record
+		 * layer checks the derived keys, and exchanges data in both directions.
+		 * Returns false if the kernel didn't take over the connection.
+		 */
+		bool RunKernelTls (TestContext ctx, bool server, CipherSuiteCode cipher);
+
+		/*
+		 * Sends `length' bytes at `offset' of a `fileSize' byte temporary file with
+		 * SendFile() and checks what the peer receives.  Returns the number of bytes
+		 * sent, or -1 if SendFile() rejected the range.
+		 */
+		long RunSendFile (TestContext ctx, int fileSize, long offset, long length);
+
+		/*
+		 * Binds the server to `bindHost' and connects the client to `connectHost', either
+		 * of which may be an IPv4 or IPv6 literal or a host name.
+		 */
+		void RunConnect (TestContext ctx, string bindHost, string connectHost);
+
+		/*
+		 * A second server binds to the port of a listening one with SO_REUSEPORT, which
+		 * one without it can't, and both of them accept a connection.
+		 */
+		void RunReusePort (TestContext ctx);
+
+		/*
+		 * Connects through a keep-alive client pool and releases the connection; the
+		 * pool must hand it out again for the same key, but not for a key with a
+		 * different client certificate.  Then several clients connect with the same
+		 * key at once, each of them replacing the session which the others resume.
+		 */
+		void RunClientPool (TestContext ctx);
+
+		/*
+		 * Releases both peers into a connection pool, which must hand them out again
+		 * for an equal key, and connects once more with a different verify callback,
+		 * which the reset native connection must use.
+		 */
+		void RunConnectionPool (TestContext ctx);
+
+		/*
+		 * Connects to a server using a shared session cache, then resumes the session
+		 * on a second server which opened the same cache.
+		 */
+		void RunSessionCache (TestContext ctx);
+
+		/*
+		 * Switches `connections' connection pairs to asynchronous I/O, exchanges data in
+		 * both directions on all of them at once, then closes the servers with a read
+		 * still pending, which must fail.
+		 */
+		void RunAsyncIO (TestContext ctx, int connections);
+
+		/*
+		 * Exchanges data over two connections, one of them in lean mode, and compares
+		 * the native memory which their idle clients still hold.  Returns false if the
+		 * memory hooks weren't installed before OpenSsl's first allocation.
+		 */
+		bool RunMemoryStats (TestContext ctx);
+	}
+}
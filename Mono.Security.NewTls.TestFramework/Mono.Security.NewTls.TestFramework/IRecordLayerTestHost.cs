@@ -0,0 +1,100 @@
+﻿//
+// IRecordLayerTestHost.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using Xamarin.AsyncTests;
+
+namespace Mono.Security.NewTls.TestFramework
+{
+	/*
+	 * Unless noted otherwise, each of these runs a TLS 1.2 handshake between two in-memory
+	 * contexts and then checks one aspect of the record layer, reporting failures through `ctx'.
+	 */
+	public interface IRecordLayerTestHost : ITestInstance
+	{
+		// EncryptMessage() hands out the previous message's record buffer again.
+		void RunBufferReuse (TestContext ctx);
+
+		/*
+		 * With a fixed clock: a burst starts with small records and switches to full-size
+		 * ones after DynamicRecordSizeThreshold bytes, going back to small ones after the
+		 * connection has been idle; RecordSizeDistribution must count all of them.
+		 */
+		void RunDynamicRecordSizing (TestContext ctx);
+
+		/*
+		 * The server's first flight is re-fragmented so that a record ends inside a
+		 * message header and another one carries the end of one message followed by
+		 * a complete one.
+		 */
+		void RunFragmentedHandshake (TestContext ctx);
+
+		/*
+		 * The client, which has no certificate, is asked for one by a CertificateRequest
+		 * that spans two records, so it has to process the reassembled messages again.
+		 */
+		void RunFragmentedCertificateRequest (TestContext ctx);
+
+		/*
+		 * The server asks for a client certificate, which the client doesn't have, both
+		 * during the initial handshake and when it renegotiates.
+		 */
+		void RunRenegotiationCertificateRequest (TestContext ctx);
+
+		/*
+		 * Both sides count the same records and bytes during the handshake and for one
+		 * application data record, and the process totals include them right away.
+		 */
+		void RunStatistics (TestContext ctx);
+
+		/*
+		 * Server contexts which share a configuration send the same encoded Certificate
+		 * message, until SetCertificate() is called.
+		 */
+		void RunCertificateMessageCache (TestContext ctx);
+
+		/*
+		 * A transcript hash which is only created after the messages have been added
+		 * must match one which was fed as they arrived, and a handshake must only hash
+		 * its transcript once for each algorithm it actually needs.
+		 */
+		void RunHandshakeHash (TestContext ctx);
+
+		/*
+		 * With the Default and SequenceNumber nonce types, each GCM record carries the
+		 * big-endian write sequence number as its explicit nonce.
+		 */
+		void RunGcmSequenceNonce (TestContext ctx);
+
+		// With GcmNonceType.Random, no two records carry the same explicit nonce.
+		void RunGcmRandomNonce (TestContext ctx);
+
+		/*
+		 * Without a handshake: BufferedRandomNumberGenerator only refills when a request
+		 * doesn't fit into the rest of its block, and never hands out a byte twice.
+		 */
+		void RunBufferedRandom (TestContext ctx);
+	}
+}
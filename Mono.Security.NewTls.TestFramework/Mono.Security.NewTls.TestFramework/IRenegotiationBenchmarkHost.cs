@@ -0,0 +1,41 @@
+﻿//
+// IRenegotiationBenchmarkHost.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using Xamarin.AsyncTests;
+
+namespace Mono.Security.NewTls.TestFramework
+{
+	public interface IRenegotiationBenchmarkHost : ITestInstance, ISingletonInstance
+	{
+		/*
+		 * Streams data over a loopback connection for `duration' while the sending
+		 * side - the server if `serverInitiated' is set, otherwise the client -
+		 * renegotiates every `interval'.  The receiving side samples its throughput
+		 * once per `sampleInterval'.
+		 */
+		RenegotiationBenchmarkResult Run (TestContext ctx, bool serverInitiated, TimeSpan duration, TimeSpan interval, TimeSpan sampleInterval);
+	}
+}
@@ -63,6 +63,9 @@ namespace Mono.Security.NewTls.TestFramework
 		ClientRenegotiation,
 		ServerRenegotiation,
 		Renegotiation,
+
+		CipherPerformance,
+		ConnectionPerformance
 	}
 }
 
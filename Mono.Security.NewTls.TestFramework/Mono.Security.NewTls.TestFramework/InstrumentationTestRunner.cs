@@ -28,6 +28,7 @@ using System.Net;
 using System.Linq;
 using System.Text;
 using System.Threading;
+using System.Diagnostics;
 using System.Threading.Tasks;
 using System.Collections.Generic;
 using Mono.Security.Interface;
@@ -73,6 +74,69 @@ namespace Mono.Security.NewTls.TestFramework
 
 		public abstract Instrumentation CreateInstrument (TestContext ctx, MonoTlsSettings settings);
 
+		PerformanceConnectionHandler performanceHandler;
+		readonly Stopwatch handshakeWatch = new Stopwatch ();
+		TimeSpan? clientHandshakeTime;
+		TimeSpan? serverHandshakeTime;
+
+		// Performance runs compare managed against managed and managed against OpenSSL.
+		protected static bool IsPerformancePairingSupported (ConnectionProviderType clientType, ConnectionProviderType serverType)
+		{
+			if (clientType == ConnectionProviderType.NewTLS)
+				return serverType == ConnectionProviderType.NewTLS || serverType == ConnectionProviderType.OpenSsl;
+			return clientType == ConnectionProviderType.OpenSsl && serverType == ConnectionProviderType.NewTLS;
+		}
+
+		protected MonoConnectionHandler CreatePerformanceHandler ()
+		{
+			performanceHandler = new PerformanceConnectionHandler (this);
+			return performanceHandler;
+		}
+
+		/*
+		 * The handshake time is measured from the start of the run until both sides have
+		 * completed their handshake, so it includes the TCP connect; that part is the same
+		 * for every combination and does not affect the comparison.
+		 */
+		public async Task<ConnectionPerformanceResult> RunPerformance (TestContext ctx, CancellationToken cancellationToken)
+		{
+			if (performanceHandler == null)
+				throw new InvalidOperationException ();
+
+			handshakeWatch.Start ();
+			await Run (ctx, cancellationToken);
+
+			if (clientHandshakeTime == null || serverHandshakeTime == null || !performanceHandler.HasCompleted) {
+				ctx.AssertFail ("Performance run did not complete.");
+				return null;
+			}
+
+			var handshakeTime = clientHandshakeTime > serverHandshakeTime ? clientHandshakeTime.Value : serverHandshakeTime.Value;
+
+			var result = new ConnectionPerformanceResult (
+				performanceHandler.Protocol, performanceHandler.Cipher, Client.Provider.Type, Server.Provider.Type,
+				handshakeTime, performanceHandler.TransferredBytes, performanceHandler.TransferTime);
+
+			ctx.LogMessage ("Performance: {0}", result);
+			PerformanceMatrix.Add (result);
+			PerformanceMatrix.CheckRegression (ctx, result);
+			return result;
+		}
+
+		protected override void OnWaitForClientConnectionCompleted (TestContext ctx, Task task)
+		{
+			if (handshakeWatch.IsRunning && task.Status == TaskStatus.RanToCompletion)
+				clientHandshakeTime = handshakeWatch.Elapsed;
+			base.OnWaitForClientConnectionCompleted (ctx, task);
+		}
+
+		protected override void OnWaitForServerConnectionCompleted (TestContext ctx, Task task)
+		{
+			if (handshakeWatch.IsRunning && task.Status == TaskStatus.RanToCompletion)
+				serverHandshakeTime = handshakeWatch.Elapsed;
+			base.OnWaitForServerConnectionCompleted (ctx, task);
+		}
+
 		public static InstrumentationConnectionFlags GetConnectionFlags (TestContext ctx, InstrumentationCategory category)
 		{
 			switch (category) {
@@ -106,6 +170,9 @@ namespace Mono.Security.NewTls.TestFramework
 				return InstrumentationConnectionFlags.ClientInstrumentation | InstrumentationConnectionFlags.ServerInstrumentation;
 			case InstrumentationCategory.MartinTest:
 				return InstrumentationConnectionFlags.RequireMonoClient | InstrumentationConnectionFlags.RequireMonoServer | InstrumentationConnectionFlags.RequireTls12;
+			case InstrumentationCategory.CipherPerformance:
+			case InstrumentationCategory.ConnectionPerformance:
+				return InstrumentationConnectionFlags.None;
 			default:
 				ctx.AssertFail ("Unsupported instrumentation category: '{0}'.", category);
 				return InstrumentationConnectionFlags.None;
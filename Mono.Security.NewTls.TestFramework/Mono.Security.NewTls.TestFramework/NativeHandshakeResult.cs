@@ -0,0 +1,74 @@
+﻿//
+// NativeHandshakeResult.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+
+namespace Mono.Security.NewTls.TestFramework
+{
+	public class NativeHandshakeResult
+	{
+		// Whether TCP_QUICKACK took effect on both sockets; it's Linux only.
+		public bool QuickAckApplied {
+			get;
+			private set;
+		}
+
+		// How often each side re-armed TCP_QUICKACK before a handshake read.
+		public int ClientQuickAckCount {
+			get;
+			private set;
+		}
+
+		public int ServerQuickAckCount {
+			get;
+			private set;
+		}
+
+		public TimeSpan ClientHandshakeTime {
+			get;
+			private set;
+		}
+
+		public TimeSpan ServerHandshakeTime {
+			get;
+			private set;
+		}
+
+		public NativeHandshakeResult (bool quickAckApplied, int clientQuickAckCount, int serverQuickAckCount, TimeSpan clientHandshakeTime, TimeSpan serverHandshakeTime)
+		{
+			QuickAckApplied = quickAckApplied;
+			ClientQuickAckCount = clientQuickAckCount;
+			ServerQuickAckCount = serverQuickAckCount;
+			ClientHandshakeTime = clientHandshakeTime;
+			ServerHandshakeTime = serverHandshakeTime;
+		}
+
+		public override string ToString ()
+		{
+			return string.Format ("[NativeHandshakeResult: QuickAckApplied={0}, QuickAckCount={1}/{2}, HandshakeTime={3}/{4}]",
+				QuickAckApplied, ClientQuickAckCount, ServerQuickAckCount, ClientHandshakeTime, ServerHandshakeTime);
+		}
+	}
+}
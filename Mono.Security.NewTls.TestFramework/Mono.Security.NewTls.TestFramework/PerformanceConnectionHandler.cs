@@ -0,0 +1,154 @@
+﻿//
+// PerformanceConnectionHandler.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.IO;
+using System.Threading;
+using System.Threading.Tasks;
+using System.Diagnostics;
+using Mono.Security.Interface;
+using Xamarin.AsyncTests;
+using Xamarin.WebTests.ConnectionFramework;
+using Xamarin.WebTests.MonoConnectionFramework;
+using Xamarin.WebTests.MonoTestFramework;
+
+namespace Mono.Security.NewTls.TestFramework
+{
+	public class PerformanceConnectionHandler : InstrumentationConnectionHandler
+	{
+		public const int TransferSize = 4 * 1024 * 1024;
+		public const int ChunkSize = 16384;
+
+		public PerformanceConnectionHandler (InstrumentationTestRunner runner)
+			: base (runner)
+		{
+		}
+
+		public ProtocolVersions Protocol {
+			get;
+			private set;
+		}
+
+		public CipherSuiteCode Cipher {
+			get;
+			private set;
+		}
+
+		public long TransferredBytes {
+			get;
+			private set;
+		}
+
+		public TimeSpan TransferTime {
+			get;
+			private set;
+		}
+
+		public bool HasCompleted {
+			get;
+			private set;
+		}
+
+		void ReadConnectionInfo (TestContext ctx)
+		{
+			var connection = Client as IMonoCommonConnection;
+			if (connection == null || !connection.SupportsConnectionInfo)
+				connection = Server as IMonoCommonConnection;
+			if (connection == null || !connection.SupportsConnectionInfo) {
+				ctx.AssertFail ("Performance measurement requires connection info.");
+				return;
+			}
+
+			Protocol = connection.ProtocolVersion;
+			Cipher = connection.GetConnectionInfo ().CipherSuiteCode;
+		}
+
+		protected override async Task HandleClientWrite (TestContext ctx, CancellationToken cancellationToken)
+		{
+			var buffer = new byte [ChunkSize];
+			for (int offset = 0; offset < TransferSize; offset += ChunkSize) {
+				cancellationToken.ThrowIfCancellationRequested ();
+				await Client.Stream.WriteAsync (buffer, 0, Math.Min (ChunkSize, TransferSize - offset), cancellationToken);
+			}
+			await Client.Stream.FlushAsync (cancellationToken);
+
+			StartClientRead ();
+		}
+
+		protected override async Task HandleClientRead (TestContext ctx, CancellationToken cancellationToken)
+		{
+			await ExpectBlob (ctx, Client, HandshakeInstrumentType.TestCompleted, cancellationToken);
+		}
+
+		protected override async Task HandleServerRead (TestContext ctx, CancellationToken cancellationToken)
+		{
+			var buffer = new byte [ChunkSize];
+			var watch = new Stopwatch ();
+			long total = 0;
+
+			while (total < TransferSize) {
+				var ret = await Server.Stream.ReadAsync (buffer, 0, buffer.Length, cancellationToken);
+				if (ret <= 0) {
+					ctx.AssertFail ("Unexpected end of stream after {0} bytes.", total);
+					return;
+				}
+				// Start timing on the first byte, so the measurement does not include any setup.
+				if (total == 0)
+					watch.Start ();
+				total += ret;
+			}
+
+			watch.Stop ();
+			TransferredBytes = total;
+			TransferTime = watch.Elapsed;
+
+			StartServerWrite ();
+		}
+
+		protected override async Task HandleServerWrite (TestContext ctx, CancellationToken cancellationToken)
+		{
+			await WriteBlob (ctx, Server, HandshakeInstrumentType.TestCompleted, cancellationToken);
+			HasCompleted = true;
+		}
+
+		protected override Task HandleMainLoop (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return FinishedTask;
+		}
+
+		protected override Task HandleClient (TestContext ctx, CancellationToken cancellationToken)
+		{
+			ReadConnectionInfo (ctx);
+			StartClientWrite ();
+			return FinishedTask;
+		}
+
+		protected override Task HandleServer (TestContext ctx, CancellationToken cancellationToken)
+		{
+			StartServerRead ();
+			return FinishedTask;
+		}
+	}
+}
@@ -0,0 +1,175 @@
+﻿//
+// PerformanceMatrix.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.Linq;
+using System.Text;
+using System.Globalization;
+using System.Collections.Generic;
+using System.Text.RegularExpressions;
+using Mono.Security.Interface;
+using Xamarin.AsyncTests;
+using Xamarin.WebTests.ConnectionFramework;
+
+namespace Mono.Security.NewTls.TestFramework
+{
+	/*
+	 * Collects the results of all performance runs in this process.
+	 *
+	 * A previous report can be loaded as baseline; each new result is then compared against
+	 * the baseline entry for the same (protocol, cipher, client, server) combination and the
+	 * test fails when it is slower than the tolerances allow.
+	 */
+	public static class PerformanceMatrix
+	{
+		static readonly object syncRoot = new object ();
+		static readonly List<ConnectionPerformanceResult> results = new List<ConnectionPerformanceResult> ();
+		static Dictionary<string,ConnectionPerformanceResult> baseline;
+
+		static PerformanceMatrix ()
+		{
+			HandshakeTolerance = 0.25;
+			ThroughputTolerance = 0.20;
+		}
+
+		// Maximum relative increase of the handshake time over the baseline.
+		public static double HandshakeTolerance {
+			get; set;
+		}
+
+		// Maximum relative decrease of the throughput below the baseline.
+		public static double ThroughputTolerance {
+			get; set;
+		}
+
+		public static IList<ConnectionPerformanceResult> Results {
+			get {
+				lock (syncRoot)
+					return results.ToArray ();
+			}
+		}
+
+		public static void Add (ConnectionPerformanceResult result)
+		{
+			lock (syncRoot)
+				results.Add (result);
+		}
+
+		public static void LoadBaseline (string json)
+		{
+			var entries = Parse (json);
+			lock (syncRoot) {
+				baseline = new Dictionary<string,ConnectionPerformanceResult> ();
+				foreach (var entry in entries)
+					baseline [entry.Key] = entry;
+			}
+		}
+
+		public static void CheckRegression (TestContext ctx, ConnectionPerformanceResult result)
+		{
+			ConnectionPerformanceResult expected;
+			lock (syncRoot) {
+				if (baseline == null || !baseline.TryGetValue (result.Key, out expected))
+					return;
+			}
+
+			var maxHandshake = expected.HandshakeTime.TotalMilliseconds * (1.0 + HandshakeTolerance);
+			if (result.HandshakeTime.TotalMilliseconds > maxHandshake)
+				ctx.AssertFail ("Handshake regression in {0}: {1:F2} ms, baseline {2:F2} ms.",
+					result.Key, result.HandshakeTime.TotalMilliseconds, expected.HandshakeTime.TotalMilliseconds);
+
+			var minThroughput = expected.Throughput * (1.0 - ThroughputTolerance);
+			if (result.Throughput < minThroughput)
+				ctx.AssertFail ("Throughput regression in {0}: {1:F0} bytes/s, baseline {2:F0} bytes/s.",
+					result.Key, result.Throughput, expected.Throughput);
+		}
+
+		public static string FormatTable ()
+		{
+			var sb = new StringBuilder ();
+			sb.AppendFormat ("{0,-8} {1,-45} {2,-10} {3,-10} {4,14} {5,14}", "Protocol", "Cipher", "Client", "Server", "Handshake (ms)", "MB/s");
+			sb.AppendLine ();
+			foreach (var result in Sorted (Results)) {
+				sb.AppendFormat (CultureInfo.InvariantCulture, "{0,-8} {1,-45} {2,-10} {3,-10} {4,14:F2} {5,14:F2}",
+					result.Protocol, result.Cipher, result.ClientProvider, result.ServerProvider,
+					result.HandshakeTime.TotalMilliseconds, result.Throughput / (1024 * 1024));
+				sb.AppendLine ();
+			}
+			return sb.ToString ();
+		}
+
+		public static string FormatJson ()
+		{
+			var sb = new StringBuilder ();
+			sb.Append ("[\n");
+			var sorted = Sorted (Results).ToArray ();
+			for (int i = 0; i < sorted.Length; i++) {
+				var result = sorted [i];
+				sb.AppendFormat (CultureInfo.InvariantCulture,
+					"  {{ \"protocol\": \"{0}\", \"cipher\": \"{1}\", \"client\": \"{2}\", \"server\": \"{3}\", " +
+					"\"handshakeMs\": {4:F3}, \"bytes\": {5}, \"transferMs\": {6:F3} }}{7}\n",
+					result.Protocol, result.Cipher, result.ClientProvider, result.ServerProvider,
+					result.HandshakeTime.TotalMilliseconds, result.TransferredBytes, result.TransferTime.TotalMilliseconds,
+					i + 1 < sorted.Length ? "," : string.Empty);
+			}
+			sb.Append ("]\n");
+			return sb.ToString ();
+		}
+
+		static IEnumerable<ConnectionPerformanceResult> Sorted (IEnumerable<ConnectionPerformanceResult> list)
+		{
+			return list.OrderBy (r => r.Protocol).ThenBy (r => r.Cipher).ThenBy (r => r.ClientProvider).ThenBy (r => r.ServerProvider);
+		}
+
+		static readonly Regex objectRegex = new Regex (@"\{[^{}]*\}");
+		static readonly Regex fieldRegex = new Regex (@"""(\w+)""\s*:\s*(?:""([^""]*)""|([-+0-9.eE]+))");
+
+		// Only reads what FormatJson() writes.
+		public static IList<ConnectionPerformanceResult> Parse (string json)
+		{
+			var list = new List<ConnectionPerformanceResult> ();
+			foreach (Match obj in objectRegex.Matches (json)) {
+				var fields = new Dictionary<string,string> ();
+				foreach (Match field in fieldRegex.Matches (obj.Value))
+					fields [field.Groups [1].Value] = field.Groups [2].Success ? field.Groups [2].Value : field.Groups [3].Value;
+
+				list.Add (new ConnectionPerformanceResult (
+					(ProtocolVersions)Enum.Parse (typeof (ProtocolVersions), fields ["protocol"]),
+					(CipherSuiteCode)Enum.Parse (typeof (CipherSuiteCode), fields ["cipher"]),
+					(ConnectionProviderType)Enum.Parse (typeof (ConnectionProviderType), fields ["client"]),
+					(ConnectionProviderType)Enum.Parse (typeof (ConnectionProviderType), fields ["server"]),
+					TimeSpan.FromTicks ((long)(ParseDouble (fields ["handshakeMs"]) * TimeSpan.TicksPerMillisecond)),
+					long.Parse (fields ["bytes"], CultureInfo.InvariantCulture),
+					TimeSpan.FromTicks ((long)(ParseDouble (fields ["transferMs"]) * TimeSpan.TicksPerMillisecond))));
+			}
+			return list;
+		}
+
+		static double ParseDouble (string value)
+		{
+			return double.Parse (value, NumberStyles.Float, CultureInfo.InvariantCulture);
+		}
+	}
+}
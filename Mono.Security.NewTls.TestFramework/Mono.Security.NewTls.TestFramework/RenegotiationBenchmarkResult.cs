@@ -0,0 +1,105 @@
+﻿//
+// RenegotiationBenchmarkResult.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.Linq;
+using System.Collections.Generic;
+
+namespace Mono.Security.NewTls.TestFramework
+{
+	public class RenegotiationBenchmarkResult
+	{
+		// Completed renegotiations, as counted by the side which started them.
+		public int Renegotiations {
+			get;
+			private set;
+		}
+
+		// Completed renegotiations, as counted by the peer; should match Renegotiations.
+		public int PeerRenegotiations {
+			get;
+			private set;
+		}
+
+		public TimeSpan AverageLatency {
+			get;
+			private set;
+		}
+
+		public TimeSpan MaxLatency {
+			get;
+			private set;
+		}
+
+		public long TotalBytes {
+			get;
+			private set;
+		}
+
+		// Bytes per second received during each sample interval.
+		public IList<double> Samples {
+			get;
+			private set;
+		}
+
+		// Median of the samples.
+		public double BaselineThroughput {
+			get;
+			private set;
+		}
+
+		public double MinimumThroughput {
+			get;
+			private set;
+		}
+
+		// Relative drop of the slowest sample below the baseline.
+		public double ThroughputDip {
+			get { return BaselineThroughput > 0 ? 1.0 - MinimumThroughput / BaselineThroughput : 0.0; }
+		}
+
+		public RenegotiationBenchmarkResult (int renegotiations, int peerRenegotiations, TimeSpan totalLatency, TimeSpan maxLatency, long totalBytes, IList<double> samples)
+		{
+			Renegotiations = renegotiations;
+			PeerRenegotiations = peerRenegotiations;
+			AverageLatency = renegotiations > 0 ? TimeSpan.FromTicks (totalLatency.Ticks / renegotiations) : TimeSpan.Zero;
+			MaxLatency = maxLatency;
+			TotalBytes = totalBytes;
+			Samples = samples;
+
+			if (samples.Count > 0) {
+				var sorted = samples.OrderBy (s => s).ToArray ();
+				BaselineThroughput = sorted [sorted.Length / 2];
+				MinimumThroughput = sorted [0];
+			}
+		}
+
+		public override string ToString ()
+		{
+			return string.Format ("[RenegotiationBenchmarkResult: Renegotiations={0}/{1}, AverageLatency={2}, MaxLatency={3}, TotalBytes={4}, Baseline={5:F0} bytes/s, Minimum={6:F0} bytes/s, Dip={7:P1}]",
+				Renegotiations, PeerRenegotiations, AverageLatency, MaxLatency, TotalBytes, BaselineThroughput, MinimumThroughput, ThroughputDip);
+		}
+	}
+}
@@ -0,0 +1,138 @@
+﻿//
+// WriteCoalescingConnectionHandler.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.IO;
+using System.Threading;
+using System.Threading.Tasks;
+using Mono.Security.Interface;
+using Xamarin.AsyncTests;
+using Xamarin.AsyncTests.Constraints;
+using Xamarin.WebTests.ConnectionFramework;
+
+namespace Mono.Security.NewTls.TestFramework
+{
+	using ConnectionFramework;
+
+	/*
+	 * The client writes a few chunks which all stay below the coalescing threshold; they
+	 * must reach the server in a single transport write, either on an explicit flush or -
+	 * when the parameters set a delay - once the flush timer fires.
+	 */
+	public class WriteCoalescingConnectionHandler : InstrumentationConnectionHandler
+	{
+		public const int Threshold = 4096;
+		public const int ChunkSize = 100;
+		public const int ChunkCount = 10;
+
+		new public GenericConnectionInstrumentTestRunner Runner {
+			get { return (GenericConnectionInstrumentTestRunner)base.Runner; }
+		}
+
+		public WriteCoalescingConnectionHandler (GenericConnectionInstrumentTestRunner runner)
+			: base (runner)
+		{
+		}
+
+		IMonoTlsProviderExtensions extension;
+		IMonoSslStream stream;
+		long transportWrites;
+
+		protected override async Task HandleClientWrite (TestContext ctx, CancellationToken cancellationToken)
+		{
+			extension = Client.Provider.GetTlsProviderExtension ();
+			ctx.Assert (extension, Is.Not.Null, "client provider extension");
+			stream = (IMonoSslStream)Client.SslStream;
+			transportWrites = extension.GetTransportWrites (stream);
+
+			var buffer = new byte [ChunkSize];
+			for (int i = 0; i < ChunkCount; i++) {
+				for (int j = 0; j < ChunkSize; j++)
+					buffer [j] = (byte)(i * ChunkSize + j);
+				await Client.Stream.WriteAsync (buffer, 0, ChunkSize, cancellationToken);
+			}
+
+			ctx.Assert (extension.GetPendingWriteSize (stream), Is.EqualTo (ChunkSize * ChunkCount), "pending write size");
+			ctx.Assert (extension.GetTransportWrites (stream), Is.EqualTo (transportWrites), "nothing sent yet");
+
+			if (Runner.Parameters.WriteCoalescingDelay == null)
+				await Client.Stream.FlushAsync (cancellationToken);
+
+			StartClientRead ();
+		}
+
+		protected override async Task HandleClientRead (TestContext ctx, CancellationToken cancellationToken)
+		{
+			await ExpectBlob (ctx, Client, HandshakeInstrumentType.TestCompleted, cancellationToken);
+
+			ctx.Assert (extension.GetPendingWriteSize (stream), Is.EqualTo (0), "pending write size");
+			ctx.Assert (extension.GetTransportWrites (stream), Is.EqualTo (transportWrites + 1), "transport writes");
+		}
+
+		protected override async Task HandleServerRead (TestContext ctx, CancellationToken cancellationToken)
+		{
+			var expected = new byte [ChunkSize * ChunkCount];
+			for (int i = 0; i < expected.Length; i++)
+				expected [i] = (byte)i;
+
+			var buffer = new byte [expected.Length];
+			var offset = 0;
+			while (offset < buffer.Length) {
+				var ret = await Server.Stream.ReadAsync (buffer, offset, buffer.Length - offset, cancellationToken);
+				if (ret <= 0) {
+					ctx.AssertFail ("Unexpected end of stream after {0} bytes.", offset);
+					return;
+				}
+				offset += ret;
+			}
+
+			ctx.Assert (buffer, Is.EqualTo (expected), "data");
+
+			StartServerWrite ();
+		}
+
+		protected override async Task HandleServerWrite (TestContext ctx, CancellationToken cancellationToken)
+		{
+			await WriteBlob (ctx, Server, HandshakeInstrumentType.TestCompleted, cancellationToken);
+		}
+
+		protected override Task HandleMainLoop (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return FinishedTask;
+		}
+
+		protected override Task HandleClient (TestContext ctx, CancellationToken cancellationToken)
+		{
+			StartClientWrite ();
+			return FinishedTask;
+		}
+
+		protected override Task HandleServer (TestContext ctx, CancellationToken cancellationToken)
+		{
+			StartServerRead ();
+			return FinishedTask;
+		}
+	}
+}
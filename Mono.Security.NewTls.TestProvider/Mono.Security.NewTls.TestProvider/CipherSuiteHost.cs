@@ -0,0 +1,186 @@
+﻿//
+// CipherSuiteHost.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+using Mono.Security.Interface;
+using Mono.Security.NewTls.Cipher;
+using Xamarin.AsyncTests;
+using Xamarin.AsyncTests.Constraints;
+
+namespace Mono.Security.NewTls.TestProvider
+{
+	using TestFramework;
+
+	public class CipherSuiteHost : ICipherSuiteTestHost
+	{
+		static readonly TlsProtocolCode[] Protocols = {
+			TlsProtocolCode.Tls10, TlsProtocolCode.Tls11, TlsProtocolCode.Tls12
+		};
+
+		static void CheckIndex (TestContext ctx, CipherSuiteCollection collection, CipherSuiteCode[] codes, string message)
+		{
+			var list = collection.ToArray ();
+			ctx.Assert (collection.Count, Is.EqualTo (list.Length), "{0}: Count", message);
+			foreach (var code in codes) {
+				var expected = Array.IndexOf (list, code);
+				ctx.Assert (collection.IndexOf (code), Is.EqualTo (expected), "{0}: IndexOf ({1})", message, code);
+				ctx.Assert (collection.Contains (code), Is.EqualTo (expected >= 0), "{0}: Contains ({1})", message, code);
+			}
+		}
+
+		public void RunCollectionIndex (TestContext ctx)
+		{
+			var codes = CipherSuiteFactory.GetSupportedCiphers (TlsProtocolCode.Tls12).ToArray ();
+			ctx.Assert (codes.Length, Is.GreaterThanOrEqualTo (4), "supported ciphers");
+			var a = codes [0];
+			var b = codes [1];
+			var c = codes [2];
+			var d = codes [3];
+
+			var collection = new CipherSuiteCollection (TlsProtocolCode.Tls12, new CipherSuiteCode[] { a, b, a });
+			CheckIndex (ctx, collection, codes, "constructor");
+			ctx.Assert (collection.IndexOf (a), Is.EqualTo (0), "first of duplicate codes");
+
+			// The index has been built by now, so these go through Append().
+			collection.Add (c);
+			CheckIndex (ctx, collection, codes, "Add");
+			collection.Add (a);
+			CheckIndex (ctx, collection, codes, "Add duplicate");
+
+			collection.Insert (0, d);
+			CheckIndex (ctx, collection, codes, "Insert");
+			ctx.Assert (collection.IndexOf (a), Is.EqualTo (1), "Insert moves later codes");
+
+			collection.RemoveAt (0);
+			CheckIndex (ctx, collection, codes, "RemoveAt");
+
+			collection [0] = c;
+			CheckIndex (ctx, collection, codes, "indexer");
+			ctx.Assert (collection.IndexOf (a), Is.EqualTo (2), "indexer replaces first duplicate");
+
+			ctx.Assert (collection.Remove (a), Is.True, "Remove");
+			CheckIndex (ctx, collection, codes, "Remove");
+			ctx.Assert (collection.Contains (a), Is.True, "Remove only removes first duplicate");
+			ctx.Assert (collection.Remove (a), Is.True, "Remove second duplicate");
+			CheckIndex (ctx, collection, codes, "Remove second duplicate");
+			ctx.Assert (collection.Remove (a), Is.False, "Remove missing");
+			ctx.Assert (collection.Remove (d), Is.False, "Remove never added");
+
+			collection.Clear ();
+			CheckIndex (ctx, collection, codes, "Clear");
+			collection.Add (b);
+			CheckIndex (ctx, collection, codes, "Add after Clear");
+		}
+
+		public void RunDescriptors (TestContext ctx)
+		{
+			foreach (var protocol in Protocols) {
+				var supported = CipherSuiteFactory.GetSupportedCiphers (protocol);
+				ctx.Assert (supported.Count, Is.GreaterThan (0), "{0}: supported ciphers", protocol);
+
+				foreach (var code in supported) {
+					var descriptor = CipherSuiteFactory.GetDescriptor (protocol, code);
+					var cipher = CipherSuiteFactory.CreateCipherSuite (protocol, code);
+					var message = string.Format ("{0} {1}", protocol, code);
+
+					ctx.Assert (CipherSuiteFactory.IsCipherSupported (protocol, code), Is.True, "{0}: IsCipherSupported", message);
+					ctx.Assert (descriptor.Protocol, Is.EqualTo (protocol), "{0}: Protocol", message);
+					ctx.Assert (descriptor.Code, Is.EqualTo (code), "{0}: Code", message);
+					ctx.Assert (cipher.Code, Is.EqualTo (code), "{0}: CipherSuite.Code", message);
+					ctx.Assert (descriptor.CipherAlgorithmType, Is.EqualTo (cipher.CipherAlgorithmType), "{0}: CipherAlgorithmType", message);
+					ctx.Assert (descriptor.HashAlgorithmType, Is.EqualTo (cipher.HashAlgorithmType), "{0}: HashAlgorithmType", message);
+					ctx.Assert (descriptor.ExchangeAlgorithmType, Is.EqualTo (cipher.ExchangeAlgorithmType), "{0}: ExchangeAlgorithmType", message);
+					ctx.Assert (descriptor.HashSize, Is.EqualTo (cipher.HashSize), "{0}: HashSize", message);
+					ctx.Assert (descriptor.KeyMaterialSize, Is.EqualTo (cipher.KeyMaterialSize), "{0}: KeyMaterialSize", message);
+					ctx.Assert (descriptor.ExpandedKeyMaterialSize, Is.EqualTo (cipher.ExpandedKeyMaterialSize), "{0}: ExpandedKeyMaterialSize", message);
+					ctx.Assert (descriptor.FixedIvSize, Is.EqualTo (cipher.FixedIvSize), "{0}: FixedIvSize", message);
+					ctx.Assert (descriptor.BlockSize, Is.EqualTo (cipher.BlockSize), "{0}: BlockSize", message);
+					ctx.Assert (descriptor.HasHMac, Is.EqualTo (cipher.HasHMac), "{0}: HasHMac", message);
+					ctx.Assert (CipherSuiteFactory.GetExchangeAlgorithmType (protocol, code), Is.EqualTo (cipher.ExchangeAlgorithmType), "{0}: GetExchangeAlgorithmType", message);
+
+					// Each call must hand out its own instance, since cipher suites carry per-connection state.
+					ctx.Assert (ReferenceEquals (cipher, CipherSuiteFactory.CreateCipherSuite (protocol, code)), Is.False, "{0}: new instance", message);
+				}
+			}
+		}
+
+		static void CheckUnsupported (TestContext ctx, TlsProtocolCode protocol, CipherSuiteCode code)
+		{
+			var message = string.Format ("{0} {1}", protocol, code);
+			ctx.Assert (CipherSuiteFactory.IsCipherSupported (protocol, code), Is.False, "{0}: IsCipherSupported", message);
+
+			try {
+				CipherSuiteFactory.GetDescriptor (protocol, code);
+				ctx.AssertFail ("{0}: GetDescriptor", message);
+			} catch (Exception ex) {
+				ctx.Assert (ex, Is.InstanceOf<TlsException> (), "{0}: GetDescriptor exception", message);
+				var tlsEx = (TlsException)ex;
+				ctx.Assert (tlsEx.Alert.Description, Is.EqualTo (AlertDescription.InsuficientSecurity), "{0}: GetDescriptor alert", message);
+			}
+
+			var collection = CipherSuiteFactory.GetSupportedCiphers (protocol);
+			try {
+				collection.Add (code);
+				ctx.AssertFail ("{0}: Add", message);
+			} catch (Exception ex) {
+				ctx.Assert (ex, Is.InstanceOf<TlsException> (), "{0}: Add exception", message);
+				var tlsEx = (TlsException)ex;
+				ctx.Assert (tlsEx.Alert.Description, Is.EqualTo (AlertDescription.InsuficientSecurity), "{0}: Add alert", message);
+			}
+			ctx.Assert (collection.Contains (code), Is.False, "{0}: Contains after Add", message);
+		}
+
+		public void RunUnsupportedCipher (TestContext ctx)
+		{
+			// Only TLS 1.2 has the GCM suites.
+			CheckUnsupported (ctx, TlsProtocolCode.Tls10, CipherSuiteCode.TLS_RSA_WITH_AES_128_GCM_SHA256);
+			CheckUnsupported (ctx, TlsProtocolCode.Tls11, CipherSuiteCode.TLS_DHE_RSA_WITH_AES_256_GCM_SHA384);
+			// Not enabled in any of the tables yet.
+			CheckUnsupported (ctx, TlsProtocolCode.Tls12, CipherSuiteCode.TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384);
+		}
+
+		public Task Initialize (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+
+		public Task PreRun (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+
+		public Task PostRun (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+
+		public Task Destroy (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+	}
+}
@@ -84,6 +84,50 @@ namespace Mono.Security.NewTls.TestProvider
 				throw new NotSupportedException ();
 			}
 		}
+
+		public IEllipticCurveTestHost GetEllipticCurveTestHost (CryptoProviderType type)
+		{
+			switch (type) {
+			case CryptoProviderType.Mono:
+				return new MonoCryptoProvider ();
+
+			default:
+				throw new NotSupportedException ();
+			}
+		}
+
+		public IHandshakeReplayTestHost GetHandshakeReplayTestHost (CryptoProviderType type)
+		{
+			switch (type) {
+			case CryptoProviderType.Mono:
+				return new HandshakeReplayHost ();
+
+			default:
+				throw new NotSupportedException ();
+			}
+		}
+
+		public IRecordLayerTestHost GetRecordLayerTestHost (CryptoProviderType type)
+		{
+			switch (type) {
+			case CryptoProviderType.Mono:
+				return new RecordLayerHost ();
+
+			default:
+				throw new NotSupportedException ();
+			}
+		}
+
+		public ICipherSuiteTestHost GetCipherSuiteTestHost (CryptoProviderType type)
+		{
+			switch (type) {
+			case CryptoProviderType.Mono:
+				return new CipherSuiteHost ();
+
+			default:
+				throw new NotSupportedException ();
+			}
+		}
 	}
 }
 
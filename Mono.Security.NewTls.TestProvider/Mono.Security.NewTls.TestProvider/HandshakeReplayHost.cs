@@ -0,0 +1,242 @@
+﻿//
+// HandshakeReplayHost.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+using System.Diagnostics;
+using System.Collections.Generic;
+using System.Security.Cryptography;
+using Mono.Security.Interface;
+using Xamarin.AsyncTests;
+using Xamarin.WebTests.ConnectionFramework;
+using Xamarin.WebTests.Resources;
+
+namespace Mono.Security.NewTls.TestProvider
+{
+	using TestFramework;
+	using MX = Mono.Security.X509;
+
+	/*
+	 * Both sides of the handshake draw all of their randomness from a seeded generator
+	 * and see the same fixed time, so a fresh context with the same seed sends exactly
+	 * what it sent during the capture and therefore accepts the peer's recorded records.
+	 */
+	public class HandshakeReplayHost : IHandshakeReplayTestHost
+	{
+		const int ClientSeed = 1;
+		const int ServerSeed = 2;
+		const int WarmupIterations = 10;
+
+		static readonly DateTime CaptureTime = new DateTime (2015, 6, 1, 0, 0, 0, DateTimeKind.Utc);
+
+		MX.X509Certificate certificate;
+		AsymmetricAlgorithm privateKey;
+
+		class Capture
+		{
+			public readonly List<byte[]> ClientReceived = new List<byte[]> ();
+			public readonly List<byte[]> ServerReceived = new List<byte[]> ();
+		}
+
+		// Reproducible, not secure.
+		class DeterministicRandomNumberGenerator : RandomNumberGenerator
+		{
+			readonly Random random;
+
+			public DeterministicRandomNumberGenerator (int seed)
+			{
+				random = new Random (seed);
+			}
+
+			public override void GetBytes (byte[] data)
+			{
+				random.NextBytes (data);
+			}
+
+			public override void GetNonZeroBytes (byte[] data)
+			{
+				random.NextBytes (data);
+				for (int i = 0; i < data.Length; i++) {
+					if (data [i] == 0)
+						data [i] = (byte)random.Next (1, 256);
+				}
+			}
+		}
+
+		TlsContext CreateContext (bool server, CipherSuiteCode cipher)
+		{
+			var settings = MonoTlsSettings.CopyDefaultSettings ();
+			settings.EnabledCiphers = new CipherSuiteCode[] { cipher };
+			settings.RemoteCertificateValidationCallback = (targetHost, cert, chain, errors) => true;
+
+			TlsConfiguration configuration;
+			if (server)
+				configuration = new TlsConfiguration (TlsProtocols.Tls12, settings, certificate, privateKey);
+			else
+				configuration = new TlsConfiguration (TlsProtocols.Tls12, settings, "localhost");
+
+			var context = new TlsContext (configuration, server, null);
+			context.SetHandshakeSources (new DeterministicRandomNumberGenerator (server ? ServerSeed : ClientSeed), () => CaptureTime);
+			return context;
+		}
+
+		static SecurityStatus Step (TlsContext context, byte[] record, Queue<byte[]> sent)
+		{
+			var outgoing = new TlsMultiBuffer ();
+			var status = context.GenerateNextToken (record != null ? new TlsBuffer (record) : null, outgoing);
+			if (status != SecurityStatus.OK && status != SecurityStatus.ContinueNeeded)
+				throw new InvalidOperationException (string.Format ("Handshake failed: {0} {1}", status, context.LastError));
+
+			if (sent != null && !outgoing.IsEmpty) {
+				var data = outgoing.StealBuffer ();
+				for (int offset = 0; offset < data.Length; ) {
+					var size = 5 + (data [offset + 3] << 8 | data [offset + 4]);
+					var copy = new byte [size];
+					Buffer.BlockCopy (data, offset, copy, 0, size);
+					sent.Enqueue (copy);
+					offset += size;
+				}
+			}
+
+			return status;
+		}
+
+		static byte[] Copy (byte[] record)
+		{
+			var copy = new byte [record.Length];
+			Buffer.BlockCopy (record, 0, copy, 0, record.Length);
+			return copy;
+		}
+
+		Capture Run (CipherSuiteCode cipher)
+		{
+			var capture = new Capture ();
+			var toServer = new Queue<byte[]> ();
+			var toClient = new Queue<byte[]> ();
+
+			using (var client = CreateContext (false, cipher))
+			using (var server = CreateContext (true, cipher)) {
+				var clientStatus = Step (client, null, toServer);
+				var serverStatus = SecurityStatus.ContinueNeeded;
+
+				while (clientStatus != SecurityStatus.OK || serverStatus != SecurityStatus.OK) {
+					if (toServer.Count > 0) {
+						var record = toServer.Dequeue ();
+						// Records are decrypted in place, so keep a pristine copy.
+						capture.ServerReceived.Add (Copy (record));
+						serverStatus = Step (server, record, toClient);
+					} else if (toClient.Count > 0) {
+						var record = toClient.Dequeue ();
+						capture.ClientReceived.Add (Copy (record));
+						clientStatus = Step (client, record, toServer);
+					} else {
+						throw new InvalidOperationException ("Handshake stalled.");
+					}
+				}
+			}
+
+			return capture;
+		}
+
+		void Replay (CipherSuiteCode cipher, bool server, byte[][] records)
+		{
+			using (var context = CreateContext (server, cipher)) {
+				var status = server ? SecurityStatus.ContinueNeeded : Step (context, null, null);
+				for (int i = 0; i < records.Length; i++)
+					status = Step (context, records [i], null);
+				if (status != SecurityStatus.OK)
+					throw new InvalidOperationException ("Replayed handshake did not complete.");
+			}
+		}
+
+		public HandshakeReplayResult Benchmark (CipherSuiteCode cipher, bool server, int iterations)
+		{
+			var capture = Run (cipher);
+			var received = server ? capture.ServerReceived : capture.ClientReceived;
+			var sent = server ? capture.ClientReceived : capture.ServerReceived;
+
+			// Prepare all copies up front, so neither the time nor the allocations are measured.
+			var inputs = new byte [WarmupIterations + iterations][][];
+			for (int i = 0; i < inputs.Length; i++)
+				inputs [i] = received.ConvertAll (Copy).ToArray ();
+
+			for (int i = 0; i < WarmupIterations; i++)
+				Replay (cipher, server, inputs [i]);
+
+			long allocated = 0;
+			int measured = 0;
+			var elapsed = TimeSpan.Zero;
+			var watch = new Stopwatch ();
+
+			for (int i = 0; i < iterations; i++) {
+				var collections = GC.CollectionCount (0);
+				var before = GC.GetTotalMemory (false);
+
+				watch.Restart ();
+				Replay (cipher, server, inputs [WarmupIterations + i]);
+				watch.Stop ();
+				elapsed += watch.Elapsed;
+
+				var after = GC.GetTotalMemory (false);
+				if (GC.CollectionCount (0) == collections) {
+					allocated += after - before;
+					measured++;
+				}
+			}
+
+			return new HandshakeReplayResult (
+				cipher, server, iterations, elapsed, measured > 0 ? allocated / measured : -1,
+				received.Count, sent.Count);
+		}
+
+		public Task Initialize (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.Run (() => {
+				var provider = DependencyInjector.Get<ICertificateProvider> ();
+				string password;
+				var data = provider.GetRawCertificateData (ResourceManager.SelfSignedServerCertificate, out password);
+				var pkcs12 = new MX.PKCS12 (data, password);
+				certificate = pkcs12.Certificates [0];
+				privateKey = (AsymmetricAlgorithm)pkcs12.Keys [0];
+			});
+		}
+
+		public Task PreRun (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+
+		public Task PostRun (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+
+		public Task Destroy (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+	}
+}
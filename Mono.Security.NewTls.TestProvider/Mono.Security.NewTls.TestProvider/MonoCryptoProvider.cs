@@ -30,21 +30,27 @@ using System.Threading;
 using System.Threading.Tasks;
 using System.Collections;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Net;
 using System.Net.Security;
+using System.Reflection;
 using System.Runtime.InteropServices;
 using System.Security.Cryptography;
 using System.Security.Cryptography.X509Certificates;
 using Mono.Security.NewTls;
 using Mono.Security.NewTls.Cipher;
+using Mono.Security.NewTls.EC;
 using Mono.Security.NewTls.TestFramework;
 using Mono.Security.Cryptography;
 using Mono.Security.Interface;
 using Xamarin.AsyncTests;
+using Org.BouncyCastle.Math;
+using Org.BouncyCastle.Math.EC;
+using Org.BouncyCastle.Crypto.Parameters;
 
 namespace Mono.Security.NewTls.TestProvider
 {
-	public class MonoCryptoProvider : IHashTestHost, IEncryptionTestHost
+	public class MonoCryptoProvider : IHashTestHost, IEncryptionTestHost, IEllipticCurveTestHost
 	{
 		RandomNumberGenerator rng = RandomNumberGenerator.Create ();
 
@@ -66,9 +72,9 @@ namespace Mono.Security.NewTls.TestProvider
 				this.parameters = parameters;
 			}
 
-			protected override SymmetricAlgorithm CreateEncryptionAlgorithm (bool forEncryption)
+			protected override void CreateExplicitIV (byte[] buffer, int offset)
 			{
-				return new MyAlgorithm (base.CreateEncryptionAlgorithm (forEncryption), parameters.IV);
+				Buffer.BlockCopy (parameters.IV, 0, buffer, offset, BlockSize);
 			}
 
 			protected override byte GetPaddingSize (int size)
@@ -83,22 +89,6 @@ namespace Mono.Security.NewTls.TestProvider
 			}
 		}
 
-		class MyAlgorithm : SymmetricAlgorithmProxy
-		{
-			byte[] iv;
-
-			public MyAlgorithm (SymmetricAlgorithm algorithm, byte[] iv)
-				: base (algorithm)
-			{
-				this.iv = iv;
-			}
-
-			public override void GenerateIV ()
-			{
-				base.IV = iv;
-			}
-		}
-
 		class MyGaloisCounterCipher : GaloisCounterCipher
 		{
 			CryptoTestParameters parameters;
@@ -263,6 +253,12 @@ namespace Mono.Security.NewTls.TestProvider
 			return crypto.Decrypt (ContentType.ApplicationData, input, output);
 		}
 
+		public IBufferOffsetSize DecryptInPlace (IBufferOffsetSize input)
+		{
+			crypto.ReadSequenceNumber = 0;
+			return crypto.DecryptInPlace (ContentType.ApplicationData, input);
+		}
+
 		public bool SupportsHashAlgorithms {
 			get { return true; }
 		}
@@ -276,6 +272,97 @@ namespace Mono.Security.NewTls.TestProvider
 		{
 			return HashAlgorithmProvider.CreateAlgorithm (algorithm);
 		}
+
+		/*
+		 * NamedCurveHelper is internal to Mono.Security.NewTls and the test provider is compiled
+		 * into several differently named assemblies, so we look it up by reflection instead.
+		 */
+		static readonly Func<NamedCurve, ECDomainParameters> getECParameters = CreateGetECParameters ();
+
+		static Func<NamedCurve, ECDomainParameters> CreateGetECParameters ()
+		{
+			var type = typeof (TlsContext).Assembly.GetType ("Mono.Security.NewTls.EC.NamedCurveHelper", true);
+			var method = type.GetMethod ("GetECParameters", BindingFlags.Static | BindingFlags.NonPublic);
+			return (Func<NamedCurve, ECDomainParameters>)Delegate.CreateDelegate (typeof (Func<NamedCurve, ECDomainParameters>), method);
+		}
+
+		static ECDomainParameters GetECParameters (NamedCurve curve)
+		{
+			return getECParameters (curve);
+		}
+
+		static ECPoint GetGenerator (NamedCurve curve, bool precomputed)
+		{
+			if (precomputed)
+				return GetECParameters (curve).G;
+			return SecNamedCurves.GetByName (curve.ToString ()).G;
+		}
+
+		public byte[] MultiplyGenerator (NamedCurve curve, byte[] scalar, bool precomputed)
+		{
+			var g = GetGenerator (curve, precomputed);
+			return g.Multiply (new BigInteger (1, scalar)).GetEncoded ();
+		}
+
+		public TimeSpan BenchmarkMultiplyGenerator (NamedCurve curve, int iterations, bool precomputed)
+		{
+			var g = GetGenerator (curve, precomputed);
+			var order = GetECParameters (curve).N;
+
+			var scalars = new BigInteger [iterations];
+			for (int i = 0; i < iterations; i++)
+				scalars [i] = new BigInteger (1, GetRandomBytes ((order.BitLength + 7) / 8)).Mod (order);
+
+			// Warm up, so the lazily computed WNAF table of the generic path is not measured.
+			g.Multiply (scalars [0]);
+
+			var watch = Stopwatch.StartNew ();
+			for (int i = 0; i < iterations; i++)
+				g.Multiply (scalars [i]);
+			watch.Stop ();
+			return watch.Elapsed;
+		}
+
+		static ECDomainParameters GetDomainParameters (NamedCurve curve, bool generic)
+		{
+			var parameters = GetECParameters (curve);
+			if (!generic)
+				return parameters;
+
+			var fp = (FpCurve)parameters.Curve;
+			var plain = new FpCurve (fp.Q, fp.A.ToBigInteger (), fp.B.ToBigInteger ());
+			var g = plain.CreatePoint (parameters.G.X.ToBigInteger (), parameters.G.Y.ToBigInteger (), false);
+			return new ECDomainParameters (plain, g, parameters.N, parameters.H);
+		}
+
+		public byte[] Multiply (NamedCurve curve, byte[] point, byte[] scalar, bool generic)
+		{
+			var parameters = GetDomainParameters (curve, generic);
+			var p = parameters.Curve.DecodePoint (point);
+			return p.Multiply (new BigInteger (1, scalar)).GetEncoded ();
+		}
+
+		public TimeSpan BenchmarkKeyAgreement (NamedCurve curve, int iterations, bool generic)
+		{
+			var parameters = GetDomainParameters (curve, generic);
+			var order = parameters.N;
+			var size = (order.BitLength + 7) / 8;
+
+			var watch = Stopwatch.StartNew ();
+			for (int i = 0; i < iterations; i++) {
+				var serverD = new BigInteger (1, GetRandomBytes (size)).Mod (order);
+				var clientD = new BigInteger (1, GetRandomBytes (size)).Mod (order);
+				var serverPublic = parameters.G.Multiply (serverD).GetEncoded ();
+				var clientPublic = parameters.G.Multiply (clientD).GetEncoded ();
+
+				var clientAgreement = parameters.Curve.DecodePoint (serverPublic).Multiply (clientD).X.ToBigInteger ();
+				var serverAgreement = parameters.Curve.DecodePoint (clientPublic).Multiply (serverD).X.ToBigInteger ();
+				if (!clientAgreement.Equals (serverAgreement))
+					throw new InvalidOperationException ("Key agreement mismatch.");
+			}
+			watch.Stop ();
+			return watch.Elapsed;
+		}
 	}
 }
 
@@ -58,6 +58,16 @@ namespace Mono.Security.NewTls.TestProvider
 		{
 			return ((MonoNewTlsStream)stream).RequestRenegotiation ();
 		}
+
+		public int GetPendingWriteSize (IMonoSslStream stream)
+		{
+			return ((MonoNewTlsStream)stream).PendingWriteSize;
+		}
+
+		public long GetTransportWrites (IMonoSslStream stream)
+		{
+			return ((MonoNewTlsStream)stream).TransportWrites;
+		}
 	}
 }
 
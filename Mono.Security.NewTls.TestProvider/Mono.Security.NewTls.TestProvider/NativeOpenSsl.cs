@@ -28,6 +28,7 @@ using System.IO;
 using System.Net;
 using System.Net.Security;
 using System.Threading;
+using System.Threading.Tasks;
 using System.Text;
 using System.Collections.Generic;
 using System.Runtime.InteropServices;
@@ -53,6 +54,9 @@ namespace Mono.Security.NewTls.TestProvider
 		TlsException lastAlert;
 		int lockReadState;
 		int lockWriteState;
+		IoCompletionCallback io_callback;
+		bool asyncIO;
+		readonly PendingIo[] pendingIo = new PendingIo [2];
 
 		readonly Func<bool,bool> shutdownHandler;
 		readonly Func<byte[],int,int,int> readHandler;
@@ -123,6 +127,27 @@ namespace Mono.Security.NewTls.TestProvider
 			extern static void native_openssl_free_private_key (IntPtr handle);
 		}
 
+		internal class SessionHandle : SafeHandle
+		{
+			SessionHandle ()
+				: base (IntPtr.Zero, true)
+			{
+			}
+
+			public override bool IsInvalid {
+				get { return handle == IntPtr.Zero; }
+			}
+
+			protected override bool ReleaseHandle ()
+			{
+				native_openssl_free_session (handle);
+				return true;
+			}
+
+			[DllImport (DLL)]
+			extern static void native_openssl_free_session (IntPtr handle);
+		}
+
 		void Debug (string message, params object[] args)
 		{
 			if (enableDebugging)
@@ -176,6 +201,8 @@ namespace Mono.Security.NewTls.TestProvider
 
 		delegate void DebugCallback (int cmd, IntPtr ptr, int size, int ret);
 
+		delegate void IoCompletionCallback (int op, int result);
+
 		delegate void MessageCallback (int write_p, int version, int content_type, IntPtr buf, int size);
 
 		void CheckError (int ret)
@@ -208,10 +235,37 @@ namespace Mono.Security.NewTls.TestProvider
 		extern static int native_openssl_close (OpenSslHandle handle);
 
 		[DllImport (DLL)]
-		extern static int native_openssl_connect (OpenSslHandle handle, byte[] ip, int port);
+		extern static int native_openssl_reset (OpenSslHandle handle);
+
+		[DllImport (DLL)]
+		extern static void native_openssl_get_reuse_stats (OpenSslHandle handle, out int created, out int reused);
+
+		[DllImport (DLL)]
+		extern static int native_openssl_connect (OpenSslHandle handle, string host, int port);
+
+		[DllImport (DLL)]
+		extern static void native_openssl_set_listen_options (OpenSslHandle handle, int backlog, bool reuse_port);
+
+		[DllImport (DLL)]
+		extern static int native_openssl_bind (OpenSslHandle handle, string host, int port);
+
+		[DllImport (DLL)]
+		extern static void native_openssl_set_socket_options (OpenSslHandle handle, NativeOpenSslSocketFlags flags, int send_buffer, int receive_buffer);
+
+		[DllImport (DLL)]
+		extern static int native_openssl_get_socket_options (OpenSslHandle handle, out NativeOpenSslSocketFlags flags, out int send_buffer, out int receive_buffer);
 
 		[DllImport (DLL)]
-		extern static int native_openssl_bind (OpenSslHandle handle, byte[] ip, int port);
+		extern static long native_openssl_get_handshake_time (OpenSslHandle handle);
+
+		[DllImport (DLL)]
+		extern static int native_openssl_get_quickack_count (OpenSslHandle handle);
+
+		[DllImport (DLL)]
+		extern static void native_openssl_set_kernel_tls (OpenSslHandle handle, bool enable);
+
+		[DllImport (DLL)]
+		extern static NativeOpenSslKernelTlsMode native_openssl_get_kernel_tls (OpenSslHandle handle);
 
 		[DllImport (DLL)]
 		extern static int native_openssl_accept (OpenSslHandle handle);
@@ -222,6 +276,42 @@ namespace Mono.Security.NewTls.TestProvider
 		[DllImport (DLL)]
 		extern static int native_openssl_read (OpenSslHandle handle, byte[] buffer, int offset, int size);
 
+		[DllImport (DLL)]
+		extern static int native_openssl_renegotiate (OpenSslHandle handle, bool wait);
+
+		[DllImport (DLL)]
+		extern static void native_openssl_get_renegotiation_stats (
+			OpenSslHandle handle, out int count, out bool pending, out long total_usec, out long max_usec);
+
+		[DllImport (DLL)]
+		extern static bool native_openssl_install_memory_hooks ();
+
+		[DllImport (DLL)]
+		extern static bool native_openssl_get_memory_stats (
+			OpenSslHandle handle, out long live_bytes, out long peak_bytes,
+			out long allocations, out long handshake_allocations, out long handshake_bytes);
+
+		[DllImport (DLL)]
+		extern static void native_openssl_set_lean_mode (OpenSslHandle handle, bool enable);
+
+		[DllImport (DLL)]
+		extern static int native_openssl_set_session_cache (OpenSslHandle handle, NativeOpenSslSessionCache.SessionCacheHandle cache);
+
+		[DllImport (DLL)]
+		extern static int native_openssl_io_register (OpenSslHandle handle, IoCompletionCallback callback);
+
+		[DllImport (DLL)]
+		extern static void native_openssl_io_unregister (OpenSslHandle handle);
+
+		[DllImport (DLL)]
+		extern static int native_openssl_io_submit (OpenSslHandle handle, int op, IntPtr buffer, int size);
+
+		[DllImport (DLL)]
+		extern static int native_openssl_send_file (OpenSslHandle handle, int fd, long offset, long length, out long bytes_sent, out long elapsed_usec);
+
+		[DllImport (DLL)]
+		extern static int native_openssl_send_region (OpenSslHandle handle, IntPtr data, long length, out long bytes_sent, out long elapsed_usec);
+
 		[DllImport (DLL)]
 		extern static CertificateHandle native_openssl_load_certificate_from_pem (OpenSslHandle handle, byte[] buffer, int len);
 
@@ -269,6 +359,18 @@ namespace Mono.Security.NewTls.TestProvider
 		[DllImport (DLL)]
 		extern static int native_openssl_shutdown (OpenSslHandle handle);
 
+		[DllImport (DLL)]
+		extern static SessionHandle native_openssl_get_session (OpenSslHandle handle);
+
+		[DllImport (DLL)]
+		extern static int native_openssl_set_session (OpenSslHandle handle, SessionHandle session);
+
+		[DllImport (DLL)]
+		extern static bool native_openssl_session_reused (OpenSslHandle handle);
+
+		[DllImport (DLL)]
+		extern static bool native_openssl_is_alive (OpenSslHandle handle);
+
 		[DllImport (DLL)]
 		extern static short native_openssl_get_current_cipher (OpenSslHandle handle);
 
@@ -307,6 +409,11 @@ namespace Mono.Security.NewTls.TestProvider
 
 		public override void Write (byte[] buffer, int offset, int size)
 		{
+			if (IsAsyncIO) {
+				SubmitAsyncIO (IO_WRITE, buffer, offset, size).GetAwaiter ().GetResult ();
+				return;
+			}
+
 			if (Interlocked.CompareExchange (ref lockWriteState, 1, 0) != 0)
 				throw GetConcurrentOperationEx ();
 
@@ -326,8 +433,59 @@ namespace Mono.Security.NewTls.TestProvider
 				throw new IOException ("Write failed.");
 		}
 
+		/*
+		 * Sends a range of the file directly from native code, so large payloads
+		 * are never copied into managed memory.  The range must lie within the file.
+		 */
+		public NativeOpenSslTransferResult SendFile (FileStream file, long offset, long length)
+		{
+			if (offset < 0)
+				throw new ArgumentOutOfRangeException ("offset");
+			if (length < 0)
+				throw new ArgumentOutOfRangeException ("length");
+			if (IsAsyncIO)
+				throw new InvalidOperationException ();
+			if (Interlocked.CompareExchange (ref lockWriteState, 1, 0) != 0)
+				throw GetConcurrentOperationEx ();
+
+			try {
+				long sent, elapsed;
+				var fd = file.SafeFileHandle.DangerousGetHandle ().ToInt32 ();
+				Debug ("SEND FILE: {0} {1}", offset, length);
+				var ret = native_openssl_send_file (handle, fd, offset, length, out sent, out elapsed);
+				Debug ("SEND FILE DONE: {0} {1}", ret, sent);
+				CheckError (ret);
+				return new NativeOpenSslTransferResult (sent, elapsed);
+			} finally {
+				lockWriteState = 0;
+			}
+		}
+
+		// Same for an unmanaged region, such as a memory-mapped view.
+		public NativeOpenSslTransferResult SendRegion (IntPtr data, long length)
+		{
+			if (length < 0)
+				throw new ArgumentOutOfRangeException ("length");
+			if (IsAsyncIO)
+				throw new InvalidOperationException ();
+			if (Interlocked.CompareExchange (ref lockWriteState, 1, 0) != 0)
+				throw GetConcurrentOperationEx ();
+
+			try {
+				long sent, elapsed;
+				var ret = native_openssl_send_region (handle, data, length, out sent, out elapsed);
+				CheckError (ret);
+				return new NativeOpenSslTransferResult (sent, elapsed);
+			} finally {
+				lockWriteState = 0;
+			}
+		}
+
 		public override IAsyncResult BeginWrite (byte[] buffer, int offset, int count, AsyncCallback callback, object state)
 		{
+			if (IsAsyncIO)
+				return ToAsyncResult (SubmitAsyncIO (IO_WRITE, buffer, offset, count), callback, state);
+
 			if (Interlocked.CompareExchange (ref lockWriteState, 1, 0) != 0)
 				throw GetConcurrentOperationEx ();
 
@@ -341,6 +499,12 @@ namespace Mono.Security.NewTls.TestProvider
 
 		public override void EndWrite (IAsyncResult asyncResult)
 		{
+			var task = asyncResult as Task<int>;
+			if (task != null) {
+				task.GetAwaiter ().GetResult ();
+				return;
+			}
+
 			try {
 				writeHandler.EndInvoke (asyncResult);
 			} finally {
@@ -350,6 +514,9 @@ namespace Mono.Security.NewTls.TestProvider
 
 		public override int Read (byte[] buffer, int offset, int size)
 		{
+			if (IsAsyncIO)
+				return SubmitAsyncIO (IO_READ, buffer, offset, size).GetAwaiter ().GetResult ();
+
 			if (Interlocked.CompareExchange (ref lockReadState, 1, 0) != 0)
 				throw GetConcurrentOperationEx ();
 
@@ -370,6 +537,9 @@ namespace Mono.Security.NewTls.TestProvider
 
 		public override IAsyncResult BeginRead (byte[] buffer, int offset, int count, AsyncCallback callback, object state)
 		{
+			if (IsAsyncIO)
+				return ToAsyncResult (SubmitAsyncIO (IO_READ, buffer, offset, count), callback, state);
+
 			if (Interlocked.CompareExchange (ref lockReadState, 1, 0) != 0)
 				throw GetConcurrentOperationEx ();
 
@@ -383,6 +553,10 @@ namespace Mono.Security.NewTls.TestProvider
 
 		public override int EndRead (IAsyncResult asyncResult)
 		{
+			var task = asyncResult as Task<int>;
+			if (task != null)
+				return task.GetAwaiter ().GetResult ();
+
 			try {
 				return readHandler.EndInvoke (asyncResult);
 			} finally {
@@ -390,6 +564,116 @@ namespace Mono.Security.NewTls.TestProvider
 			}
 		}
 
+		public override Task<int> ReadAsync (byte[] buffer, int offset, int count, CancellationToken cancellationToken)
+		{
+			if (!IsAsyncIO)
+				return base.ReadAsync (buffer, offset, count, cancellationToken);
+			return SubmitAsyncIO (IO_READ, buffer, offset, count);
+		}
+
+		public override Task WriteAsync (byte[] buffer, int offset, int count, CancellationToken cancellationToken)
+		{
+			if (!IsAsyncIO)
+				return base.WriteAsync (buffer, offset, count, cancellationToken);
+			return SubmitAsyncIO (IO_WRITE, buffer, offset, count);
+		}
+
+		const int IO_READ = 0;
+		const int IO_WRITE = 1;
+
+		class PendingIo
+		{
+			public readonly TaskCompletionSource<int> Tcs = new TaskCompletionSource<int> ();
+			public readonly int Size;
+			public GCHandle Pin;
+
+			public PendingIo (int size)
+			{
+				Size = size;
+			}
+		}
+
+		public bool IsAsyncIO {
+			get { return asyncIO; }
+		}
+
+		/*
+		 * Must be called after the handshake.  From then on, the connection is driven by
+		 * the native I/O thread: Read() / Write() and their async variants only submit the
+		 * operation and are completed from there, so pending operations don't block any
+		 * managed thread.
+		 */
+		public void StartAsyncIO ()
+		{
+			if (IsAsyncIO)
+				throw new InvalidOperationException ();
+
+			/*
+			 * The I/O thread may still be invoking the callback while the connection is
+			 * being unregistered, so the delegate is kept alive as long as this instance.
+			 */
+			if (io_callback == null)
+				io_callback = new IoCompletionCallback (OnIoCompletion);
+			var ret = native_openssl_io_register (handle, io_callback);
+			CheckError (ret);
+			asyncIO = true;
+		}
+
+		Task<int> SubmitAsyncIO (int op, byte[] buffer, int offset, int count)
+		{
+			var io = new PendingIo (count);
+			if (Interlocked.CompareExchange (ref pendingIo [op], io, null) != null)
+				throw GetConcurrentOperationEx ();
+
+			io.Pin = GCHandle.Alloc (buffer, GCHandleType.Pinned);
+
+			Debug ("SUBMIT: {0} {1}", op, count);
+			var ret = native_openssl_io_submit (handle, op, io.Pin.AddrOfPinnedObject () + offset, count);
+			if (ret != 0) {
+				pendingIo [op] = null;
+				io.Pin.Free ();
+				throw new NativeOpenSslException ((NativeOpenSslError)ret);
+			}
+
+			return io.Tcs.Task;
+		}
+
+		// Called on the native I/O thread, which must not run the continuations.
+		void OnIoCompletion (int op, int result)
+		{
+			var io = Interlocked.Exchange (ref pendingIo [op], null);
+			if (io == null)
+				return;
+
+			io.Pin.Free ();
+			Debug ("COMPLETED: {0} {1}", op, result);
+
+			ThreadPool.QueueUserWorkItem (_ => {
+				if (op == IO_WRITE && result != io.Size)
+					io.Tcs.SetException (new IOException ("Write failed."));
+				else if (result < 0)
+					io.Tcs.SetException (lastAlert ?? new IOException ("Read failed."));
+				else
+					io.Tcs.SetResult (result);
+			});
+		}
+
+		static IAsyncResult ToAsyncResult (Task<int> task, AsyncCallback callback, object state)
+		{
+			var tcs = new TaskCompletionSource<int> (state);
+			task.ContinueWith (t => {
+				if (t.IsFaulted)
+					tcs.TrySetException (t.Exception.InnerExceptions);
+				else if (t.IsCanceled)
+					tcs.TrySetCanceled ();
+				else
+					tcs.TrySetResult (t.Result);
+				if (callback != null)
+					callback (tcs.Task);
+			}, TaskScheduler.Default);
+			return tcs.Task;
+		}
+
 		public override void Flush ()
 		{
 			;
@@ -418,6 +702,10 @@ namespace Mono.Security.NewTls.TestProvider
 			get { return protocol; }
 		}
 
+		public bool IsServer {
+			get { return isServer; }
+		}
+
 		public NativeOpenSsl (bool isServer, bool debug, NativeOpenSslProtocol protocol)
 		{
 			this.isServer = isServer;
@@ -442,6 +730,18 @@ namespace Mono.Security.NewTls.TestProvider
 		}
 
 		public void Connect (IPEndPoint endpoint)
+		{
+			Connect (endpoint.Address.ToString (), endpoint.Port);
+		}
+
+		// The host may be an IPv4 or IPv6 literal or a host name.
+		public void Connect (string host, int port)
+		{
+			Connect (host, port, null);
+		}
+
+		// Attempts to resume the session if it's not null.
+		internal void Connect (string host, int port, SessionHandle session)
 		{
 			if (isServer)
 				throw new InvalidOperationException ();
@@ -449,11 +749,247 @@ namespace Mono.Security.NewTls.TestProvider
 			var ret = native_openssl_create_connection (handle);
 			CheckError (ret);
 
-			ret = native_openssl_connect (handle, endpoint.Address.GetAddressBytes (), endpoint.Port);
+			if (session != null) {
+				ret = native_openssl_set_session (handle, session);
+				CheckError (ret);
+			}
+
+			ret = native_openssl_connect (handle, host, port);
+			CheckError (ret);
+		}
+
+		internal SessionHandle GetSession ()
+		{
+			var session = native_openssl_get_session (handle);
+			if (session.IsInvalid) {
+				session.Dispose ();
+				return null;
+			}
+			return session;
+		}
+
+		public bool SessionReused {
+			get { return native_openssl_session_reused (handle); }
+		}
+
+		// False if the peer closed the connection or sent anything while we were idle.
+		public bool IsAlive {
+			get { return handle != null && shutdownState == ShutdownState.None && native_openssl_is_alive (handle); }
+		}
+
+		/*
+		 * Must be called before Bind().  A backlog of zero uses the system maximum.
+		 *
+		 * With reusePort, several NativeOpenSsl instances (typically one per worker thread)
+		 * can bind to the same port and the kernel distributes incoming connections between them.
+		 */
+		public void SetListenOptions (int backlog, bool reusePort)
+		{
+			if (!isServer)
+				throw new InvalidOperationException ();
+
+			native_openssl_set_listen_options (handle, backlog, reusePort);
+		}
+
+		// Must be called before Connect() / Bind().
+		public void SetSocketProfile (NativeOpenSslSocketProfile profile)
+		{
+			native_openssl_set_socket_options (handle, profile.Flags, profile.SendBufferSize, profile.ReceiveBufferSize);
+		}
+
+		// Returns the options which actually took effect on the connected socket.
+		public NativeOpenSslSocketProfile GetEffectiveSocketProfile ()
+		{
+			NativeOpenSslSocketFlags flags;
+			int sendBuffer, receiveBuffer;
+			var ret = native_openssl_get_socket_options (handle, out flags, out sendBuffer, out receiveBuffer);
 			CheckError (ret);
+
+			return new NativeOpenSslSocketProfile {
+				Flags = flags, SendBufferSize = sendBuffer, ReceiveBufferSize = receiveBuffer
+			};
+		}
+
+		// Time spent in SSL_connect() / SSL_accept().
+		public TimeSpan HandshakeTime {
+			get { return TimeSpan.FromTicks (native_openssl_get_handshake_time (handle) * 10); }
+		}
+
+		// How often TCP_QUICKACK was re-armed before a handshake read.
+		public int QuickAckCount {
+			get { return native_openssl_get_quickack_count (handle); }
+		}
+
+		/*
+		 * Must be called before Connect() / Accept().  After a TLS 1.2 AES-GCM handshake,
+		 * the record layer is handed over to the kernel on Linux.  If that's not possible,
+		 * the connection keeps using OpenSsl and KernelTlsMode stays None.
+		 */
+		public void EnableKernelTls (bool enable)
+		{
+			native_openssl_set_kernel_tls (handle, enable);
+		}
+
+		public NativeOpenSslKernelTlsMode KernelTlsMode {
+			get { return native_openssl_get_kernel_tls (handle); }
+		}
+
+		/*
+		 * Starts a renegotiation; not supported with async I/O or kernel TLS.  A client
+		 * completes the handshake right away.  A server only sends a HelloRequest and
+		 * the handshake completes inside its next Read(), unless `wait' is set.  Either
+		 * way, the peer must keep reading to process it.
+		 */
+		public void Renegotiate (bool wait)
+		{
+			if (IsAsyncIO)
+				throw new InvalidOperationException ();
+
+			if (Interlocked.CompareExchange (ref lockReadState, 1, 0) != 0)
+				throw GetConcurrentOperationEx ();
+			if (Interlocked.CompareExchange (ref lockWriteState, 1, 0) != 0) {
+				lockReadState = 0;
+				throw GetConcurrentOperationEx ();
+			}
+
+			try {
+				Debug ("RENEGOTIATE: {0}", wait);
+				var ret = native_openssl_renegotiate (handle, wait);
+				Debug ("RENEGOTIATE DONE: {0}", ret);
+				CheckError (ret);
+			} finally {
+				lockReadState = 0;
+				lockWriteState = 0;
+			}
+		}
+
+		// Completed renegotiations, including those started by the peer.
+		public int RenegotiationCount {
+			get {
+				int count;
+				bool pending;
+				long total, max;
+				native_openssl_get_renegotiation_stats (handle, out count, out pending, out total, out max);
+				return count;
+			}
+		}
+
+		public bool RenegotiationPending {
+			get {
+				int count;
+				bool pending;
+				long total, max;
+				native_openssl_get_renegotiation_stats (handle, out count, out pending, out total, out max);
+				return pending;
+			}
+		}
+
+		// Sum of all renegotiations, from the first handshake message until the handshake is done.
+		public TimeSpan TotalRenegotiationTime {
+			get {
+				int count;
+				bool pending;
+				long total, max;
+				native_openssl_get_renegotiation_stats (handle, out count, out pending, out total, out max);
+				return TimeSpan.FromTicks (total * 10);
+			}
+		}
+
+		public TimeSpan MaxRenegotiationTime {
+			get {
+				int count;
+				bool pending;
+				long total, max;
+				native_openssl_get_renegotiation_stats (handle, out count, out pending, out total, out max);
+				return TimeSpan.FromTicks (max * 10);
+			}
+		}
+
+		/*
+		 * Installs counting allocator hooks into OpenSsl, so GetMemoryStats() can report
+		 * the native memory used by each connection.  OpenSsl only accepts them before its
+		 * first allocation, so this must be called before the first instance is created;
+		 * returns false if that's too late.
+		 */
+		public static bool InstallMemoryHooks ()
+		{
+			return native_openssl_install_memory_hooks ();
+		}
+
+		// Returns null unless InstallMemoryHooks() succeeded before this instance was created.
+		public NativeOpenSslMemoryStats GetMemoryStats ()
+		{
+			long live, peak, allocations, handshakeAllocations, handshakeBytes;
+			if (!native_openssl_get_memory_stats (handle, out live, out peak, out allocations, out handshakeAllocations, out handshakeBytes))
+				return null;
+			return new NativeOpenSslMemoryStats (live, peak, allocations, handshakeAllocations, handshakeBytes);
+		}
+
+		/*
+		 * Lean mode releases the record buffers (about 34k each for reading and writing)
+		 * whenever they are empty, so idle connections don't hold on to them.
+		 */
+		public void SetLeanMode (bool enable)
+		{
+			native_openssl_set_lean_mode (handle, enable);
+		}
+
+		/*
+		 * Server only: store sessions in the shared cache instead of the internal one, so they
+		 * can be resumed by any process using the same cache.  The cache stays open as long as
+		 * this instance uses it.
+		 */
+		public void SetSessionCache (NativeOpenSslSessionCache cache)
+		{
+			if (!isServer)
+				throw new InvalidOperationException ();
+
+			var ret = native_openssl_set_session_cache (handle, cache.Handle);
+			CheckError (ret);
+		}
+
+		/*
+		 * Closes the connection and resets it with SSL_clear(), so that the next Connect() or
+		 * Bind() / Accept() reuses the context and the native SSL object with its buffers.
+		 */
+		public void Reset ()
+		{
+			if (pendingIo [IO_READ] != null || pendingIo [IO_WRITE] != null)
+				throw GetConcurrentOperationEx ();
+
+			var ret = native_openssl_reset (handle);
+			asyncIO = false;
+			shutdownState = ShutdownState.None;
+			lastAlert = null;
+			lockReadState = 0;
+			lockWriteState = 0;
+			CheckError (ret);
+		}
+
+		// Number of connections which had to allocate a new native SSL object.
+		public int ConnectionsCreated {
+			get {
+				int created, reused;
+				native_openssl_get_reuse_stats (handle, out created, out reused);
+				return created;
+			}
+		}
+
+		// Number of connections which reused the SSL object of a previous one.
+		public int ConnectionsReused {
+			get {
+				int created, reused;
+				native_openssl_get_reuse_stats (handle, out created, out reused);
+				return reused;
+			}
 		}
 
 		public void Bind (IPEndPoint endpoint)
+		{
+			Bind (endpoint.Address.ToString (), endpoint.Port);
+		}
+
+		public void Bind (string host, int port)
 		{
 			if (!isServer)
 				throw new InvalidOperationException ();
@@ -461,7 +997,7 @@ namespace Mono.Security.NewTls.TestProvider
 			var ret = native_openssl_create_connection (handle);
 			CheckError (ret);
 
-			ret = native_openssl_bind (handle, endpoint.Address.GetAddressBytes (), endpoint.Port);
+			ret = native_openssl_bind (handle, host, port);
 			CheckError (ret);
 		}
 
@@ -544,10 +1080,11 @@ namespace Mono.Security.NewTls.TestProvider
 
 		public void SetCertificateVerify (VerifyMode mode, RemoteValidationCallback callback)
 		{
-			this.managed_cert_callback = callback;
-			if (callback != null)
+			// Created only once: a reused native connection may still point to it.
+			if (verify_callback == null)
 				verify_callback = new VerifyCallback (OnVerifyCallback);
-			native_openssl_set_certificate_verify (handle, (int)mode, verify_callback, null, 10);
+			this.managed_cert_callback = callback;
+			native_openssl_set_certificate_verify (handle, (int)mode, callback != null ? verify_callback : null, null, 10);
 		}
 
 		enum ShutdownState {
@@ -565,6 +1102,12 @@ namespace Mono.Security.NewTls.TestProvider
 			else if (shutdownState == ShutdownState.Closed)
 				return true;
 
+			// SSL_shutdown() needs a blocking socket.
+			if (IsAsyncIO) {
+				native_openssl_io_unregister (handle);
+				asyncIO = false;
+			}
+
 			try {
 				var ret = native_openssl_shutdown (handle);
 				Debug ("SHUTDOWN #1: {0}", ret);
@@ -0,0 +1,276 @@
+﻿//
+// NativeOpenSslClientPool.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.Net;
+using System.Collections.Generic;
+using System.Security.Cryptography;
+using Mono.Security.Interface;
+
+namespace Mono.Security.NewTls.TestProvider
+{
+	/*
+	 * Keeps established client connections alive between requests, so steady-state
+	 * latency can be measured without the handshake.  When no idle connection is
+	 * available, the new one attempts to resume the last session for that key.
+	 */
+	public class NativeOpenSslClientPool : IDisposable
+	{
+		readonly int maxIdlePerKey;
+		readonly Dictionary<PoolKey,Entry> entries = new Dictionary<PoolKey,Entry> ();
+		bool disposed;
+
+		public NativeOpenSslClientPool (int maxIdlePerKey)
+		{
+			this.maxIdlePerKey = maxIdlePerKey;
+		}
+
+		public int MaxIdlePerKey {
+			get { return maxIdlePerKey; }
+		}
+
+		// Idle connection handed out.
+		public int Hits {
+			get; private set;
+		}
+
+		// New connection needed.
+		public int Misses {
+			get; private set;
+		}
+
+		// New connection which resumed a previous session.
+		public int Resumed {
+			get; private set;
+		}
+
+		// Idle connection which failed the health check.
+		public int Discarded {
+			get; private set;
+		}
+
+		// Released connection which exceeded MaxIdlePerKey.
+		public int Evicted {
+			get; private set;
+		}
+
+		public sealed class PoolKey : IEquatable<PoolKey>
+		{
+			public string Host {
+				get;
+				private set;
+			}
+
+			public int Port {
+				get;
+				private set;
+			}
+
+			public NativeOpenSslProtocol Protocol {
+				get;
+				private set;
+			}
+
+			public string CipherPolicy {
+				get;
+				private set;
+			}
+
+			// SHA-256 of the client certificate's PKCS#12 data, or empty.
+			public string ClientCertificate {
+				get;
+				private set;
+			}
+
+			public PoolKey (IPEndPoint endpoint, NativeOpenSslProtocol protocol, ICollection<CipherSuiteCode> ciphers, byte[] clientCertificate)
+			{
+				Host = endpoint.Address.ToString ();
+				Port = endpoint.Port;
+				Protocol = protocol;
+				CipherPolicy = ciphers != null ? string.Join (":", ciphers) : string.Empty;
+				ClientCertificate = GetFingerprint (clientCertificate);
+			}
+
+			internal static string GetFingerprint (byte[] data)
+			{
+				if (data == null)
+					return string.Empty;
+				using (var sha = SHA256.Create ())
+					return BitConverter.ToString (sha.ComputeHash (data));
+			}
+
+			public bool Equals (PoolKey other)
+			{
+				return other != null && Host == other.Host && Port == other.Port &&
+					Protocol == other.Protocol && CipherPolicy == other.CipherPolicy &&
+					ClientCertificate == other.ClientCertificate;
+			}
+
+			public override bool Equals (object obj)
+			{
+				return Equals (obj as PoolKey);
+			}
+
+			public override int GetHashCode ()
+			{
+				return Host.GetHashCode () ^ (Port << 8) ^ (int)Protocol ^ CipherPolicy.GetHashCode () ^ ClientCertificate.GetHashCode ();
+			}
+
+			public override string ToString ()
+			{
+				return string.Format ("[PoolKey: {0}:{1} {2} {3} {4}]", Host, Port, Protocol, CipherPolicy, ClientCertificate);
+			}
+		}
+
+		class Entry
+		{
+			public readonly Stack<NativeOpenSsl> Idle = new Stack<NativeOpenSsl> ();
+			public NativeOpenSsl.SessionHandle Session;
+		}
+
+		Entry GetEntry (PoolKey key)
+		{
+			Entry entry;
+			if (!entries.TryGetValue (key, out entry)) {
+				entry = new Entry ();
+				entries.Add (key, entry);
+			}
+			return entry;
+		}
+
+		/*
+		 * Returns a healthy idle connection for the key, or null if the caller needs
+		 * to create one with Connect().
+		 */
+		public NativeOpenSsl Acquire (PoolKey key)
+		{
+			lock (entries) {
+				if (disposed)
+					throw new ObjectDisposedException ("NativeOpenSslClientPool");
+
+				var entry = GetEntry (key);
+				while (entry.Idle.Count > 0) {
+					var openssl = entry.Idle.Pop ();
+					if (openssl.IsAlive) {
+						Hits++;
+						return openssl;
+					}
+					Discarded++;
+					openssl.Dispose ();
+				}
+
+				Misses++;
+				return null;
+			}
+		}
+
+		/*
+		 * Connects a newly created client, resuming the last session for the key.
+		 *
+		 * Another Connect() for the same key or Dispose() may replace and dispose that
+		 * session while we're still using it, so we hold a reference to the handle.
+		 */
+		public void Connect (PoolKey key, NativeOpenSsl openssl)
+		{
+			NativeOpenSsl.SessionHandle session;
+			var addedRef = false;
+			lock (entries) {
+				if (disposed)
+					throw new ObjectDisposedException ("NativeOpenSslClientPool");
+
+				session = GetEntry (key).Session;
+				if (session != null)
+					session.DangerousAddRef (ref addedRef);
+			}
+
+			try {
+				openssl.Connect (key.Host, key.Port, session);
+			} finally {
+				if (addedRef)
+					session.DangerousRelease ();
+			}
+
+			var newSession = openssl.GetSession ();
+			lock (entries) {
+				if (openssl.SessionReused)
+					Resumed++;
+
+				if (disposed) {
+					if (newSession != null)
+						newSession.Dispose ();
+					return;
+				}
+
+				var entry = GetEntry (key);
+				if (newSession != null) {
+					if (entry.Session != null)
+						entry.Session.Dispose ();
+					entry.Session = newSession;
+				}
+			}
+		}
+
+		// Takes ownership of the connection; it will either be kept for reuse or disposed.
+		public void Release (PoolKey key, NativeOpenSsl openssl)
+		{
+			lock (entries) {
+				if (!disposed && openssl.IsAlive) {
+					var entry = GetEntry (key);
+					if (entry.Idle.Count < maxIdlePerKey) {
+						entry.Idle.Push (openssl);
+						return;
+					}
+					Evicted++;
+				}
+			}
+
+			openssl.Dispose ();
+		}
+
+		public void Dispose ()
+		{
+			lock (entries) {
+				if (disposed)
+					return;
+				disposed = true;
+
+				foreach (var entry in entries.Values) {
+					while (entry.Idle.Count > 0)
+						entry.Idle.Pop ().Dispose ();
+					if (entry.Session != null)
+						entry.Session.Dispose ();
+				}
+				entries.Clear ();
+			}
+		}
+
+		public override string ToString ()
+		{
+			return string.Format ("[NativeOpenSslClientPool: Hits={0}, Misses={1}, Resumed={2}, Discarded={3}, Evicted={4}]",
+				Hits, Misses, Resumed, Discarded, Evicted);
+		}
+	}
+}
+
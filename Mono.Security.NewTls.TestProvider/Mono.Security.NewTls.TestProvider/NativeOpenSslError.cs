@@ -44,7 +44,13 @@ namespace Mono.Security.NewTls.TestProvider
 		CREATE_CONNECTION,
 		INVALID_CIPHER,
 		UNKNOWN_CURVE_NAME,
-		INVALID_CURVE
+		INVALID_CURVE,
+		SEND_FILE,
+		INVALID_SESSION,
+		ASYNC_IO,
+		RENEGOTIATE,
+		SESSION_CACHE,
+		KERNEL_TLS
 	}
 }
 
@@ -0,0 +1,73 @@
+﻿//
+// NativeOpenSslMemoryStats.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+
+namespace Mono.Security.NewTls.TestProvider
+{
+	// Native memory accounted to a connection; see NativeOpenSsl.InstallMemoryHooks().
+	public class NativeOpenSslMemoryStats
+	{
+		public long LiveBytes {
+			get;
+			private set;
+		}
+
+		public long PeakBytes {
+			get;
+			private set;
+		}
+
+		public long Allocations {
+			get;
+			private set;
+		}
+
+		public long HandshakeAllocations {
+			get;
+			private set;
+		}
+
+		public long HandshakeBytes {
+			get;
+			private set;
+		}
+
+		internal NativeOpenSslMemoryStats (long liveBytes, long peakBytes, long allocations, long handshakeAllocations, long handshakeBytes)
+		{
+			LiveBytes = liveBytes;
+			PeakBytes = peakBytes;
+			Allocations = allocations;
+			HandshakeAllocations = handshakeAllocations;
+			HandshakeBytes = handshakeBytes;
+		}
+
+		public override string ToString ()
+		{
+			return string.Format ("[NativeOpenSslMemoryStats: LiveBytes={0}, PeakBytes={1}, Allocations={2}, HandshakeAllocations={3}, HandshakeBytes={4}]",
+				LiveBytes, PeakBytes, Allocations, HandshakeAllocations, HandshakeBytes);
+		}
+	}
+}
@@ -0,0 +1,206 @@
+﻿//
+// NativeOpenSslPool.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.Collections.Generic;
+using Mono.Security.Interface;
+
+namespace Mono.Security.NewTls.TestProvider
+{
+	/*
+	 * Recycles finished connections: a released NativeOpenSsl is reset with SSL_clear()
+	 * and handed out again for the next connection with the same key, so connection
+	 * churn doesn't have to create and free the native context and SSL object each time.
+	 *
+	 * Unlike NativeOpenSslClientPool, this doesn't keep connections alive.
+	 */
+	public class NativeOpenSslPool : IDisposable
+	{
+		readonly int maxIdlePerKey;
+		readonly Dictionary<PoolKey,Stack<NativeOpenSsl>> entries = new Dictionary<PoolKey,Stack<NativeOpenSsl>> ();
+		bool disposed;
+
+		public NativeOpenSslPool (int maxIdlePerKey)
+		{
+			this.maxIdlePerKey = maxIdlePerKey;
+		}
+
+		public int MaxIdlePerKey {
+			get { return maxIdlePerKey; }
+		}
+
+		// Reset instance handed out.
+		public int Hits {
+			get; private set;
+		}
+
+		// New instance needed.
+		public int Misses {
+			get; private set;
+		}
+
+		// Released instance which could not be reset.
+		public int Discarded {
+			get; private set;
+		}
+
+		// Released instance which exceeded MaxIdlePerKey.
+		public int Evicted {
+			get; private set;
+		}
+
+		/*
+		 * Everything which is configured on the native context and not set again for
+		 * each connection: the certificate is compared by its SHA-256 fingerprint.
+		 */
+		public sealed class PoolKey : IEquatable<PoolKey>
+		{
+			public bool IsServer {
+				get;
+				private set;
+			}
+
+			public NativeOpenSslProtocol Protocol {
+				get;
+				private set;
+			}
+
+			public bool EnableDebugging {
+				get;
+				private set;
+			}
+
+			public string Certificate {
+				get;
+				private set;
+			}
+
+			public string CipherPolicy {
+				get;
+				private set;
+			}
+
+			public PoolKey (bool isServer, NativeOpenSslProtocol protocol, bool enableDebugging, byte[] certificate, ICollection<CipherSuiteCode> ciphers)
+			{
+				IsServer = isServer;
+				Protocol = protocol;
+				EnableDebugging = enableDebugging;
+				Certificate = NativeOpenSslClientPool.PoolKey.GetFingerprint (certificate);
+				CipherPolicy = ciphers != null ? string.Join (":", ciphers) : string.Empty;
+			}
+
+			public bool Equals (PoolKey other)
+			{
+				return other != null && IsServer == other.IsServer && Protocol == other.Protocol &&
+					EnableDebugging == other.EnableDebugging && Certificate == other.Certificate &&
+					CipherPolicy == other.CipherPolicy;
+			}
+
+			public override bool Equals (object obj)
+			{
+				return Equals (obj as PoolKey);
+			}
+
+			public override int GetHashCode ()
+			{
+				return (IsServer ? 1 : 0) ^ ((int)Protocol << 1) ^ (EnableDebugging ? 8 : 0) ^ Certificate.GetHashCode () ^ CipherPolicy.GetHashCode ();
+			}
+
+			public override string ToString ()
+			{
+				return string.Format ("[PoolKey: {0} {1} {2}]", IsServer ? "server" : "client", Protocol, CipherPolicy);
+			}
+		}
+
+		// Returns a reset instance for the key, or null if the caller needs to create one.
+		public NativeOpenSsl Acquire (PoolKey key)
+		{
+			lock (entries) {
+				if (disposed)
+					throw new ObjectDisposedException ("NativeOpenSslPool");
+
+				Stack<NativeOpenSsl> idle;
+				if (entries.TryGetValue (key, out idle) && idle.Count > 0) {
+					Hits++;
+					return idle.Pop ();
+				}
+
+				Misses++;
+				return null;
+			}
+		}
+
+		// Takes ownership of the instance; it will either be reset and kept for reuse or disposed.
+		public void Release (PoolKey key, NativeOpenSsl openssl)
+		{
+			try {
+				openssl.Reset ();
+			} catch {
+				lock (entries)
+					Discarded++;
+				openssl.Dispose ();
+				return;
+			}
+
+			lock (entries) {
+				if (!disposed) {
+					Stack<NativeOpenSsl> idle;
+					if (!entries.TryGetValue (key, out idle)) {
+						idle = new Stack<NativeOpenSsl> ();
+						entries.Add (key, idle);
+					}
+					if (idle.Count < maxIdlePerKey) {
+						idle.Push (openssl);
+						return;
+					}
+					Evicted++;
+				}
+			}
+
+			openssl.Dispose ();
+		}
+
+		public void Dispose ()
+		{
+			lock (entries) {
+				if (disposed)
+					return;
+				disposed = true;
+
+				foreach (var idle in entries.Values) {
+					while (idle.Count > 0)
+						idle.Pop ().Dispose ();
+				}
+				entries.Clear ();
+			}
+		}
+
+		public override string ToString ()
+		{
+			return string.Format ("[NativeOpenSslPool: Hits={0}, Misses={1}, Discarded={2}, Evicted={3}]",
+				Hits, Misses, Discarded, Evicted);
+		}
+	}
+}
@@ -0,0 +1,144 @@
+﻿//
+// NativeOpenSslRenegotiationBenchmark.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.Net;
+using System.Threading;
+using System.Threading.Tasks;
+using System.Diagnostics;
+using System.Collections.Generic;
+using Xamarin.AsyncTests;
+using Xamarin.WebTests.ConnectionFramework;
+using Xamarin.WebTests.Resources;
+
+namespace Mono.Security.NewTls.TestProvider
+{
+	using TestFramework;
+
+	/*
+	 * Runs both peers in-process.  The side which renegotiates is also the one which
+	 * writes, so the handshake blocks its data stream; the peer only reads and handles
+	 * the renegotiation inside its reads.
+	 */
+	public class NativeOpenSslRenegotiationBenchmark : IRenegotiationBenchmarkHost
+	{
+		const int BufferSize = 16384;
+
+		public RenegotiationBenchmarkResult Run (TestContext ctx, bool serverInitiated, TimeSpan duration, TimeSpan interval, TimeSpan sampleInterval)
+		{
+			var endpoint = new IPEndPoint (IPAddress.Loopback, 4433);
+			var server = new NativeOpenSsl (true, false, NativeOpenSslProtocol.TLS12);
+			var client = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+
+			try {
+				var provider = DependencyInjector.Get<ICertificateProvider> ();
+				string password;
+				var data = provider.GetRawCertificateData (ResourceManager.SelfSignedServerCertificate, out password);
+				server.SetCertificate (data, password);
+				server.Bind (endpoint);
+
+				var accept = Task.Run (() => server.Accept ());
+				client.Connect (endpoint);
+				accept.Wait ();
+
+				var writer = serverInitiated ? server : client;
+				var reader = serverInitiated ? client : server;
+
+				long totalBytes = 0;
+				var readTask = Task.Run (() => ReadAll (reader, sampleInterval, out totalBytes));
+
+				var buffer = new byte [BufferSize];
+				var watch = Stopwatch.StartNew ();
+				var next = interval;
+				while (watch.Elapsed < duration) {
+					if (watch.Elapsed >= next) {
+						writer.Renegotiate (true);
+						next = watch.Elapsed + interval;
+					}
+					writer.Write (buffer, 0, buffer.Length);
+				}
+
+				var renegotiations = writer.RenegotiationCount;
+				var totalLatency = writer.TotalRenegotiationTime;
+				var maxLatency = writer.MaxRenegotiationTime;
+
+				// Closing the socket ends the reader's loop.
+				writer.Dispose ();
+				var samples = readTask.Result;
+
+				return new RenegotiationBenchmarkResult (
+					renegotiations, reader.RenegotiationCount, totalLatency, maxLatency, totalBytes, samples);
+			} finally {
+				client.Dispose ();
+				server.Dispose ();
+			}
+		}
+
+		static IList<double> ReadAll (NativeOpenSsl reader, TimeSpan sampleInterval, out long totalBytes)
+		{
+			var buffer = new byte [BufferSize];
+			var samples = new List<double> ();
+			var watch = Stopwatch.StartNew ();
+			var sampleStart = TimeSpan.Zero;
+			long sampleBytes = 0;
+			int ret;
+
+			totalBytes = 0;
+			while ((ret = reader.Read (buffer, 0, buffer.Length)) > 0) {
+				totalBytes += ret;
+				sampleBytes += ret;
+
+				var elapsed = watch.Elapsed;
+				if (elapsed - sampleStart >= sampleInterval) {
+					samples.Add (sampleBytes / (elapsed - sampleStart).TotalSeconds);
+					sampleStart = elapsed;
+					sampleBytes = 0;
+				}
+			}
+
+			return samples;
+		}
+
+		public Task Initialize (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+
+		public Task PreRun (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+
+		public Task PostRun (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+
+		public Task Destroy (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+	}
+}
@@ -0,0 +1,171 @@
+﻿//
+// NativeOpenSslSessionCache.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.Runtime.InteropServices;
+
+namespace Mono.Security.NewTls.TestProvider
+{
+	/*
+	 * Session cache in a named shared memory segment.
+	 *
+	 * Every worker process opens the cache with the same name and installs it on its
+	 * server with NativeOpenSsl.SetSessionCache(), so a client can resume its session
+	 * no matter which worker accepts the connection.  Entries are opaque: the native
+	 * server stores DER-encoded sessions, keyed by session id.  Sessions which encode
+	 * to more than MaxDataSize bytes are not cached, but counted as rejected.
+	 *
+	 * On OS X, the locks are not robust: if a process dies while holding one, the
+	 * others give up on that part of the cache after a second and do full handshakes.
+	 */
+	public class NativeOpenSslSessionCache : IDisposable
+	{
+		SessionCacheHandle handle;
+
+		internal class SessionCacheHandle : SafeHandle
+		{
+			SessionCacheHandle ()
+				: base (IntPtr.Zero, true)
+			{
+			}
+
+			public override bool IsInvalid {
+				get { return handle == IntPtr.Zero; }
+			}
+
+			protected override bool ReleaseHandle ()
+			{
+				native_openssl_session_cache_close (handle);
+				return true;
+			}
+
+			[DllImport (NativeOpenSsl.DLL)]
+			extern static void native_openssl_session_cache_close (IntPtr handle);
+		}
+
+		internal SessionCacheHandle Handle {
+			get {
+				if (handle == null)
+					throw new ObjectDisposedException ("NativeOpenSslSessionCache");
+				return handle;
+			}
+		}
+
+		NativeOpenSslSessionCache (SessionCacheHandle handle)
+		{
+			this.handle = handle;
+		}
+
+		/*
+		 * Opens the cache, creating it if necessary; slots and timeout only take effect
+		 * when it is created.  The name must start with a slash, e.g. "/newtls-4433".
+		 */
+		public static NativeOpenSslSessionCache Open (string name, int slots, TimeSpan timeout)
+		{
+			var handle = native_openssl_session_cache_open (name, slots, (int)timeout.TotalSeconds);
+			if (handle.IsInvalid) {
+				handle.Dispose ();
+				throw new NativeOpenSslException (NativeOpenSslError.SESSION_CACHE);
+			}
+			return new NativeOpenSslSessionCache (handle);
+		}
+
+		// Removes the name; processes which still have the cache open keep using it.
+		public static void Unlink (string name)
+		{
+			if (!native_openssl_session_cache_unlink (name))
+				throw new NativeOpenSslException (NativeOpenSslError.SESSION_CACHE);
+		}
+
+		// Returns false if the data was not cached, for instance because it is too large.
+		public bool Store (byte[] id, byte[] data)
+		{
+			return native_openssl_session_cache_store (Handle, id, id.Length, data, data.Length);
+		}
+
+		public byte[] Lookup (byte[] id)
+		{
+			var buffer = new byte [MaxDataSize];
+			var ret = native_openssl_session_cache_lookup (Handle, id, id.Length, buffer, buffer.Length);
+			if (ret <= 0)
+				return null;
+
+			var data = new byte [ret];
+			Buffer.BlockCopy (buffer, 0, data, 0, ret);
+			return data;
+		}
+
+		public void Remove (byte[] id)
+		{
+			native_openssl_session_cache_remove (Handle, id, id.Length);
+		}
+
+		// Keep in sync with SESSION_CACHE_MAX_DATA in the native code.
+		public const int MaxDataSize = 2048;
+
+		public int Capacity {
+			get {
+				int capacity;
+				long hits, misses, stores, evictions, rejected;
+				native_openssl_session_cache_get_stats (Handle, out capacity, out hits, out misses, out stores, out evictions, out rejected);
+				return capacity;
+			}
+		}
+
+		// Totals of all processes sharing the cache; `rejected' counts sessions larger than MaxDataSize.
+		public void GetStatistics (out long hits, out long misses, out long stores, out long evictions, out long rejected)
+		{
+			int capacity;
+			native_openssl_session_cache_get_stats (Handle, out capacity, out hits, out misses, out stores, out evictions, out rejected);
+		}
+
+		public void Dispose ()
+		{
+			if (handle != null) {
+				handle.Dispose ();
+				handle = null;
+			}
+		}
+
+		[DllImport (NativeOpenSsl.DLL)]
+		extern static SessionCacheHandle native_openssl_session_cache_open (string name, int slots, int timeout);
+
+		[DllImport (NativeOpenSsl.DLL)]
+		extern static bool native_openssl_session_cache_unlink (string name);
+
+		[DllImport (NativeOpenSsl.DLL)]
+		extern static bool native_openssl_session_cache_store (SessionCacheHandle handle, byte[] id, int id_len, byte[] data, int data_len);
+
+		[DllImport (NativeOpenSsl.DLL)]
+		extern static int native_openssl_session_cache_lookup (SessionCacheHandle handle, byte[] id, int id_len, byte[] data, int size);
+
+		[DllImport (NativeOpenSsl.DLL)]
+		extern static void native_openssl_session_cache_remove (SessionCacheHandle handle, byte[] id, int id_len);
+
+		[DllImport (NativeOpenSsl.DLL)]
+		extern static void native_openssl_session_cache_get_stats (
+			SessionCacheHandle handle, out int capacity, out long hits, out long misses, out long stores, out long evictions, out long rejected);
+	}
+}
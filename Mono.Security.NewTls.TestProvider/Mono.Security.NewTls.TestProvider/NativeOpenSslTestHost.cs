@@ -0,0 +1,656 @@
+﻿//
+// NativeOpenSslTestHost.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.IO;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading;
+using System.Threading.Tasks;
+using Mono.Security.Interface;
+using Xamarin.AsyncTests;
+using Xamarin.AsyncTests.Constraints;
+using Xamarin.WebTests.ConnectionFramework;
+using Xamarin.WebTests.Resources;
+
+namespace Mono.Security.NewTls.TestProvider
+{
+	using TestFramework;
+
+	public class NativeOpenSslTestHost : INativePeerTestHost
+	{
+		static readonly IPEndPoint Endpoint = new IPEndPoint (IPAddress.Loopback, 4433);
+
+		static NativeOpenSsl CreateServer ()
+		{
+			var server = new NativeOpenSsl (true, false, NativeOpenSslProtocol.TLS12);
+
+			var provider = DependencyInjector.Get<ICertificateProvider> ();
+			string password;
+			var data = provider.GetRawCertificateData (ResourceManager.SelfSignedServerCertificate, out password);
+			server.SetCertificate (data, password);
+			return server;
+		}
+
+		static void Connect (NativeOpenSsl server, NativeOpenSsl client)
+		{
+			Connect (server, client, Endpoint);
+		}
+
+		static void Connect (NativeOpenSsl server, NativeOpenSsl client, IPEndPoint endpoint)
+		{
+			server.Bind (endpoint);
+			var accept = Task.Run (() => server.Accept ());
+			client.Connect (endpoint);
+			accept.Wait ();
+		}
+
+		public NativeHandshakeResult RunHandshake (TestContext ctx, bool quickAck)
+		{
+			var server = CreateServer ();
+			var client = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+
+			try {
+				if (quickAck) {
+					var profile = new NativeOpenSslSocketProfile { Flags = NativeOpenSslSocketFlags.QuickAck };
+					server.SetSocketProfile (profile);
+					client.SetSocketProfile (profile);
+				}
+
+				Connect (server, client);
+
+				var applied = (server.GetEffectiveSocketProfile ().Flags & client.GetEffectiveSocketProfile ().Flags & NativeOpenSslSocketFlags.QuickAck) != 0;
+				return new NativeHandshakeResult (applied, client.QuickAckCount, server.QuickAckCount, client.HandshakeTime, server.HandshakeTime);
+			} finally {
+				client.Dispose ();
+				server.Dispose ();
+			}
+		}
+
+		public bool RunKernelTls (TestContext ctx, bool server, CipherSuiteCode cipher)
+		{
+			var serverPeer = CreateServer ();
+			var clientPeer = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+
+			try {
+				var ciphers = new [] { cipher };
+				serverPeer.SetCipherList (ciphers);
+				clientPeer.SetCipherList (ciphers);
+
+				var kernelPeer = server ? serverPeer : clientPeer;
+				kernelPeer.EnableKernelTls (true);
+
+				Connect (serverPeer, clientPeer);
+
+				var mode = kernelPeer.KernelTlsMode;
+				ctx.LogMessage ("Kernel TLS on the {0}: {1}", server ? "server" : "client", mode);
+				if (mode == NativeOpenSslKernelTlsMode.None)
+					return false;
+
+				// A connection is either handed over completely or not at all.
+				ctx.Assert (mode, Is.EqualTo (NativeOpenSslKernelTlsMode.Transmit | NativeOpenSslKernelTlsMode.Receive), "kernel mode");
+
+				Exchange (ctx, clientPeer, serverPeer, 65536);
+				Exchange (ctx, serverPeer, clientPeer, 65536);
+				return true;
+			} finally {
+				clientPeer.Dispose ();
+				serverPeer.Dispose ();
+			}
+		}
+
+		public long RunSendFile (TestContext ctx, int fileSize, long offset, long length)
+		{
+			var server = CreateServer ();
+			var client = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+			var path = Path.GetTempFileName ();
+
+			try {
+				var data = new byte [fileSize];
+				for (int i = 0; i < fileSize; i++)
+					data [i] = (byte)(i * 7);
+				File.WriteAllBytes (path, data);
+
+				Connect (server, client);
+
+				var received = new MemoryStream ();
+				var read = Task.Run (() => {
+					var buffer = new byte [16384];
+					int ret;
+					while (received.Length < length && (ret = client.Read (buffer, 0, buffer.Length)) > 0)
+						received.Write (buffer, 0, ret);
+				});
+
+				NativeOpenSslTransferResult result;
+				using (var file = new FileStream (path, FileMode.Open, FileAccess.Read)) {
+					try {
+						result = server.SendFile (file, offset, length);
+					} catch (ArgumentOutOfRangeException) {
+						return -1;
+					} catch (NativeOpenSslException) {
+						return -1;
+					}
+				}
+
+				read.Wait ();
+				ctx.LogMessage ("Sent {0} bytes at {1}: {2}", length, offset, result);
+
+				var expected = new byte [length];
+				Array.Copy (data, offset, expected, 0, length);
+				ctx.Assert (received.ToArray (), Is.EqualTo (expected), "data");
+				return result.BytesSent;
+			} finally {
+				// Closing the sockets ends the read if nothing was sent.
+				client.Dispose ();
+				server.Dispose ();
+				File.Delete (path);
+			}
+		}
+
+		public void RunConnect (TestContext ctx, string bindHost, string connectHost)
+		{
+			var server = CreateServer ();
+			var client = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+
+			try {
+				server.Bind (bindHost, Endpoint.Port);
+				var accept = Task.Run (() => server.Accept ());
+				client.Connect (connectHost, Endpoint.Port);
+				accept.Wait ();
+
+				Exchange (ctx, client, server, 4096);
+				Exchange (ctx, server, client, 4096);
+			} finally {
+				client.Dispose ();
+				server.Dispose ();
+			}
+		}
+
+		public void RunReusePort (TestContext ctx)
+		{
+			var first = CreateServer ();
+			var second = CreateServer ();
+			var other = CreateServer ();
+			var firstClient = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+			var secondClient = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+
+			try {
+				first.SetListenOptions (0, true);
+				second.SetListenOptions (0, true);
+
+				// While it's the only listener, the first server gets the connection.
+				Connect (first, firstClient);
+				Exchange (ctx, firstClient, first, 4096);
+
+				second.Bind (Endpoint);
+
+				var bound = true;
+				try {
+					other.Bind (Endpoint);
+				} catch (NativeOpenSslException) {
+					bound = false;
+				}
+				ctx.Assert (bound, Is.False, "bind without SO_REUSEPORT");
+
+				/*
+				 * With both servers listening, the kernel may pick either of them; close the
+				 * first one, so the second one must get the next connection.
+				 */
+				first.Dispose ();
+				var accept = Task.Run (() => second.Accept ());
+				secondClient.Connect (Endpoint);
+				accept.Wait ();
+				Exchange (ctx, secondClient, second, 4096);
+				Exchange (ctx, second, secondClient, 4096);
+			} finally {
+				secondClient.Dispose ();
+				firstClient.Dispose ();
+				other.Dispose ();
+				second.Dispose ();
+				first.Dispose ();
+			}
+		}
+
+		public void RunClientPool (TestContext ctx)
+		{
+			var server = CreateServer ();
+			var client = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+			var pool = new NativeOpenSslClientPool (1);
+
+			try {
+				var certificateProvider = DependencyInjector.Get<ICertificateProvider> ();
+				string password;
+				var certificate = certificateProvider.GetRawCertificateData (ResourceManager.MonkeyCertificate, out password);
+
+				var key = new NativeOpenSslClientPool.PoolKey (Endpoint, NativeOpenSslProtocol.TLS12, null, null);
+				var certificateKey = new NativeOpenSslClientPool.PoolKey (Endpoint, NativeOpenSslProtocol.TLS12, null, certificate);
+				ctx.Assert (certificateKey.Equals (key), Is.False, "client certificate is part of the key");
+
+				ctx.Assert (pool.Acquire (key), Is.Null, "empty pool");
+
+				server.Bind (Endpoint);
+				var accept = Task.Run (() => server.Accept ());
+				pool.Connect (key, client);
+				accept.Wait ();
+				Exchange (ctx, client, server, 4096);
+
+				pool.Release (key, client);
+				ctx.Assert (pool.Acquire (certificateKey), Is.Null, "different client certificate");
+
+				var pooled = pool.Acquire (key);
+				ctx.Assert (ReferenceEquals (pooled, client), Is.True, "pool hit");
+				client = pooled;
+
+				// Still the same TLS connection.
+				Exchange (ctx, client, server, 4096);
+				Exchange (ctx, server, client, 4096);
+
+				ctx.LogMessage ("Client pool: {0}", pool);
+				ctx.Assert (pool.Hits, Is.EqualTo (1), "hits");
+				ctx.Assert (pool.Misses, Is.EqualTo (2), "misses");
+
+				ConnectConcurrently (ctx, pool, 8, 4);
+			} finally {
+				pool.Dispose ();
+				client.Dispose ();
+				server.Dispose ();
+			}
+		}
+
+		/*
+		 * Several clients connect through the pool with the same key at once, so each of
+		 * them replaces the session which the others may still be resuming.
+		 *
+		 * A server only accepts a single connection, so they all connect to a forwarder
+		 * on one port, which hands each connection to its own server on the ports after it;
+		 * which client ends up with which server depends on the order of their connects.
+		 */
+		static void ConnectConcurrently (TestContext ctx, NativeOpenSslClientPool pool, int connections, int rounds)
+		{
+			var endpoint = new IPEndPoint (IPAddress.Loopback, Endpoint.Port + 1);
+			var key = new NativeOpenSslClientPool.PoolKey (endpoint, NativeOpenSslProtocol.TLS12, null, null);
+			var resumed = pool.Resumed;
+
+			var listener = new TcpListener (endpoint);
+			listener.Start ();
+
+			try {
+				for (int round = 0; round < rounds; round++) {
+					var servers = new NativeOpenSsl [connections];
+					var clients = new NativeOpenSsl [connections];
+					var accepts = new Task [connections];
+					var backends = new IPEndPoint [connections];
+					Task forward;
+
+					try {
+						for (int i = 0; i < connections; i++) {
+							backends [i] = new IPEndPoint (IPAddress.Loopback, endpoint.Port + 1 + i);
+							servers [i] = CreateServer ();
+							servers [i].Bind (backends [i]);
+							var server = servers [i];
+							accepts [i] = Task.Run (() => server.Accept ());
+							clients [i] = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+						}
+
+						forward = Forward (listener, backends);
+						var connects = new Task [connections];
+						for (int i = 0; i < connections; i++) {
+							var client = clients [i];
+							connects [i] = Task.Run (() => pool.Connect (key, client));
+						}
+						Task.WaitAll (connects);
+						Task.WaitAll (accepts);
+					} finally {
+						for (int i = 0; i < connections; i++) {
+							if (clients [i] != null)
+								clients [i].Dispose ();
+							if (servers [i] != null)
+								servers [i].Dispose ();
+						}
+					}
+
+					// Closing the sockets ends the forwarding.
+					forward.Wait ();
+				}
+			} finally {
+				listener.Stop ();
+			}
+
+			// Each server has its own session cache, so nothing can be resumed.
+			ctx.LogMessage ("Client pool: {0}", pool);
+			ctx.Assert (pool.Resumed, Is.EqualTo (resumed), "resumed");
+		}
+
+		static async Task Forward (TcpListener listener, IPEndPoint[] backends)
+		{
+			var connections = new Task [backends.Length];
+			for (int i = 0; i < backends.Length; i++) {
+				var client = await listener.AcceptTcpClientAsync ();
+				connections [i] = Forward (client, backends [i]);
+			}
+			await Task.WhenAll (connections);
+		}
+
+		static async Task Forward (TcpClient client, IPEndPoint backend)
+		{
+			using (client)
+			using (var server = new TcpClient ()) {
+				await server.ConnectAsync (backend.Address, backend.Port);
+				var clientStream = client.GetStream ();
+				var serverStream = server.GetStream ();
+				// Once either side closes its socket, disposing both of them ends the other copy.
+				await Task.WhenAny (clientStream.CopyToAsync (serverStream), serverStream.CopyToAsync (clientStream));
+			}
+		}
+
+		public void RunConnectionPool (TestContext ctx)
+		{
+			var certificateProvider = DependencyInjector.Get<ICertificateProvider> ();
+			string password;
+			var serverCertificate = certificateProvider.GetRawCertificateData (ResourceManager.SelfSignedServerCertificate, out password);
+			var otherCertificate = certificateProvider.GetRawCertificateData (ResourceManager.MonkeyCertificate, out password);
+
+			var serverKey = new NativeOpenSslPool.PoolKey (true, NativeOpenSslProtocol.TLS12, false, serverCertificate, null);
+			var sameKey = new NativeOpenSslPool.PoolKey (true, NativeOpenSslProtocol.TLS12, false, (byte[])serverCertificate.Clone (), null);
+			var otherKey = new NativeOpenSslPool.PoolKey (true, NativeOpenSslProtocol.TLS12, false, otherCertificate, null);
+			var clientKey = new NativeOpenSslPool.PoolKey (false, NativeOpenSslProtocol.TLS12, false, null, null);
+			ctx.Assert (sameKey.Equals (serverKey), Is.True, "same certificate data");
+			ctx.Assert (sameKey.GetHashCode (), Is.EqualTo (serverKey.GetHashCode ()), "same hash code");
+			ctx.Assert (otherKey.Equals (serverKey), Is.False, "different certificate");
+
+			var pool = new NativeOpenSslPool (1);
+			var server = CreateServer ();
+			var client = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+
+			try {
+				int firstCalls = 0, secondCalls = 0;
+				client.SetCertificateVerify (NativeOpenSsl.VerifyMode.SSL_VERIFY_PEER, (ok, certificate) => {
+					firstCalls++;
+					return true;
+				});
+
+				Connect (server, client);
+				Exchange (ctx, client, server, 4096);
+				ctx.Assert (firstCalls, Is.GreaterThan (0), "first verify callback");
+
+				pool.Release (serverKey, server);
+				pool.Release (clientKey, client);
+				ctx.Assert (pool.Acquire (otherKey), Is.Null, "different certificate");
+
+				var pooledServer = pool.Acquire (sameKey);
+				var pooledClient = pool.Acquire (clientKey);
+				ctx.Assert (ReferenceEquals (pooledServer, server), Is.True, "server reused");
+				ctx.Assert (ReferenceEquals (pooledClient, client), Is.True, "client reused");
+
+				// The reset SSL object must pick up the new callback, and not call the old one.
+				client.SetCertificateVerify (NativeOpenSsl.VerifyMode.SSL_VERIFY_PEER, (ok, certificate) => {
+					secondCalls++;
+					return true;
+				});
+				var calls = firstCalls;
+
+				GC.Collect ();
+				GC.WaitForPendingFinalizers ();
+
+				Connect (server, client);
+				Exchange (ctx, client, server, 4096);
+				Exchange (ctx, server, client, 4096);
+
+				ctx.Assert (secondCalls, Is.GreaterThan (0), "second verify callback");
+				ctx.Assert (firstCalls, Is.EqualTo (calls), "old verify callback");
+				ctx.Assert (client.ConnectionsReused, Is.EqualTo (1), "client SSL reused");
+				ctx.Assert (server.ConnectionsReused, Is.EqualTo (1), "server SSL reused");
+
+				ctx.Assert (pool.Hits, Is.EqualTo (2), "hits");
+				ctx.Assert (pool.Misses, Is.EqualTo (1), "misses");
+				ctx.Assert (pool.Discarded, Is.EqualTo (0), "discarded");
+			} finally {
+				pool.Dispose ();
+				client.Dispose ();
+				server.Dispose ();
+			}
+		}
+
+		public void RunSessionCache (TestContext ctx)
+		{
+			// Two mappings of the same segment, as two worker processes would have.
+			var name = string.Format ("/newtls-test-{0}", Guid.NewGuid ().ToString ("N").Substring (0, 8));
+			var firstCache = NativeOpenSslSessionCache.Open (name, 64, TimeSpan.FromMinutes (5));
+			var secondCache = NativeOpenSslSessionCache.Open (name, 64, TimeSpan.FromMinutes (5));
+			NativeOpenSslSessionCache.Unlink (name);
+
+			var firstServer = CreateServer ();
+			var secondServer = CreateServer ();
+			var firstClient = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+			var secondClient = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+			NativeOpenSsl.SessionHandle session = null;
+
+			try {
+				firstServer.SetSessionCache (firstCache);
+				secondServer.SetSessionCache (secondCache);
+
+				Connect (firstServer, firstClient);
+				Exchange (ctx, firstClient, firstServer, 4096);
+				ctx.Assert (firstClient.SessionReused, Is.False, "first handshake");
+				session = firstClient.GetSession ();
+
+				// A session which is freed without a close_notify is removed from the cache.
+				firstServer.EndShutdown (firstServer.BeginShutdown (false, null, null));
+				firstClient.EndShutdown (firstClient.BeginShutdown (false, null, null));
+				firstClient.Dispose ();
+				firstServer.Dispose ();
+
+				secondServer.Bind (Endpoint);
+				var accept = Task.Run (() => secondServer.Accept ());
+				secondClient.Connect (Endpoint.Address.ToString (), Endpoint.Port, session);
+				accept.Wait ();
+				Exchange (ctx, secondClient, secondServer, 4096);
+				ctx.Assert (secondClient.SessionReused, Is.True, "resumed on the other server");
+
+				ctx.Assert (firstCache.Store (new byte [32], new byte [NativeOpenSslSessionCache.MaxDataSize + 1]), Is.False, "too large");
+
+				long hits, misses, stores, evictions, rejected;
+				firstCache.GetStatistics (out hits, out misses, out stores, out evictions, out rejected);
+				ctx.LogMessage ("Session cache: {0} hits, {1} misses, {2} stores, {3} evictions, {4} rejected", hits, misses, stores, evictions, rejected);
+				ctx.Assert (stores, Is.EqualTo (1L), "stores");
+				ctx.Assert (hits, Is.EqualTo (1L), "hits");
+				ctx.Assert (rejected, Is.EqualTo (1L), "rejected");
+			} finally {
+				if (session != null)
+					session.Dispose ();
+				secondClient.Dispose ();
+				firstClient.Dispose ();
+				secondServer.Dispose ();
+				firstServer.Dispose ();
+				secondCache.Dispose ();
+				firstCache.Dispose ();
+			}
+		}
+
+		public void RunAsyncIO (TestContext ctx, int connections)
+		{
+			var servers = new NativeOpenSsl [connections];
+			var clients = new NativeOpenSsl [connections];
+
+			try {
+				for (int i = 0; i < connections; i++) {
+					servers [i] = CreateServer ();
+					clients [i] = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+					Connect (servers [i], clients [i], new IPEndPoint (IPAddress.Loopback, Endpoint.Port + i));
+					servers [i].StartAsyncIO ();
+					clients [i].StartAsyncIO ();
+				}
+
+				// Both directions of all connections at once, all driven by the one I/O thread.
+				var transfers = new Task [connections * 2];
+				for (int i = 0; i < connections; i++) {
+					transfers [2 * i] = ExchangeAsync (ctx, clients [i], servers [i], 65536);
+					transfers [2 * i + 1] = ExchangeAsync (ctx, servers [i], clients [i], 65536);
+				}
+				Task.WaitAll (transfers);
+
+				/*
+				 * Closing a connection completes its pending read from the closing thread,
+				 * while the I/O thread may still be dispatching completions for the others.
+				 */
+				var reads = new Task<int> [connections];
+				for (int i = 0; i < connections; i++)
+					reads [i] = servers [i].ReadAsync (new byte [16], 0, 16);
+
+				GC.Collect ();
+				GC.WaitForPendingFinalizers ();
+
+				for (int i = 0; i < connections; i++) {
+					servers [i].Dispose ();
+					try {
+						reads [i].Wait ();
+					} catch (AggregateException) {
+						;
+					}
+					ctx.Assert (reads [i].IsFaulted, Is.True, "pending read failed");
+				}
+			} finally {
+				for (int i = 0; i < connections; i++) {
+					if (clients [i] != null)
+						clients [i].Dispose ();
+					if (servers [i] != null)
+						servers [i].Dispose ();
+				}
+			}
+		}
+
+		// Lean mode must at least release one of the client's record buffers.
+		const int RecordBufferSize = 16384;
+
+		public bool RunMemoryStats (TestContext ctx)
+		{
+			var leanServer = CreateServer ();
+			var leanClient = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+			var server = CreateServer ();
+			var client = new NativeOpenSsl (false, false, NativeOpenSslProtocol.TLS12);
+
+			try {
+				// Creating these made OpenSsl allocate, so only hooks from before that count.
+				if (!NativeOpenSsl.InstallMemoryHooks ()) {
+					ctx.Assert (NativeOpenSsl.InstallMemoryHooks (), Is.False, "still too late");
+					ctx.Assert (client.GetMemoryStats (), Is.Null, "no memory stats");
+					return false;
+				}
+
+				leanServer.SetLeanMode (true);
+				leanClient.SetLeanMode (true);
+				Connect (leanServer, leanClient);
+				Connect (server, client, new IPEndPoint (IPAddress.Loopback, Endpoint.Port + 1));
+
+				// Use both record buffers, then leave the connections idle.
+				Exchange (ctx, leanClient, leanServer, 65536);
+				Exchange (ctx, leanServer, leanClient, 65536);
+				Exchange (ctx, client, server, 65536);
+				Exchange (ctx, server, client, 65536);
+
+				var lean = leanClient.GetMemoryStats ();
+				var regular = client.GetMemoryStats ();
+				ctx.LogMessage ("Idle client in lean mode: {0}", lean);
+				ctx.LogMessage ("Idle client: {0}", regular);
+
+				ctx.Assert (lean.Allocations, Is.GreaterThan (0L), "allocations");
+				ctx.Assert (lean.HandshakeAllocations, Is.GreaterThan (0L), "handshake allocations");
+				ctx.Assert (lean.HandshakeBytes, Is.GreaterThan (0L), "handshake bytes");
+				ctx.Assert (lean.LiveBytes, Is.LessThanOrEqualTo (lean.PeakBytes), "lean peak");
+				ctx.Assert (regular.LiveBytes, Is.LessThanOrEqualTo (regular.PeakBytes), "peak");
+				ctx.Assert (lean.LiveBytes, Is.LessThanOrEqualTo (regular.LiveBytes - RecordBufferSize), "buffers released");
+				return true;
+			} finally {
+				client.Dispose ();
+				server.Dispose ();
+				leanClient.Dispose ();
+				leanServer.Dispose ();
+			}
+		}
+
+		static async Task ExchangeAsync (TestContext ctx, NativeOpenSsl writer, NativeOpenSsl reader, int size)
+		{
+			var data = CreateData (size);
+			var write = writer.WriteAsync (data, 0, size);
+
+			var received = new byte [size];
+			int offset = 0;
+			while (offset < size) {
+				var ret = await reader.ReadAsync (received, offset, size - offset);
+				ctx.Assert (ret, Is.GreaterThan (0), "read");
+				offset += ret;
+			}
+			await write;
+
+			ctx.Assert (received, Is.EqualTo (data), "data");
+		}
+
+		static byte[] CreateData (int size)
+		{
+			var data = new byte [size];
+			for (int i = 0; i < size; i++)
+				data [i] = (byte)(i * 7);
+			return data;
+		}
+
+		static void Exchange (TestContext ctx, NativeOpenSsl writer, NativeOpenSsl reader, int size)
+		{
+			var data = CreateData (size);
+
+			var write = Task.Run (() => writer.Write (data, 0, size));
+
+			var received = new byte [size];
+			int offset = 0;
+			while (offset < size) {
+				var ret = reader.Read (received, offset, size - offset);
+				ctx.Assert (ret, Is.GreaterThan (0), "read");
+				offset += ret;
+			}
+			write.Wait ();
+
+			ctx.Assert (received, Is.EqualTo (data), "data");
+		}
+
+		public Task Initialize (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+
+		public Task PreRun (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+
+		public Task PostRun (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+
+		public Task Destroy (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+	}
+}
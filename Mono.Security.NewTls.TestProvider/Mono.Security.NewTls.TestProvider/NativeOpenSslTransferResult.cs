@@ -0,0 +1,58 @@
+﻿//
+// NativeOpenSslTransferResult.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+
+namespace Mono.Security.NewTls.TestProvider
+{
+	public class NativeOpenSslTransferResult
+	{
+		public long BytesSent {
+			get;
+			private set;
+		}
+
+		public TimeSpan Elapsed {
+			get;
+			private set;
+		}
+
+		public double BytesPerSecond {
+			get { return Elapsed.Ticks > 0 ? BytesSent / Elapsed.TotalSeconds : 0.0; }
+		}
+
+		internal NativeOpenSslTransferResult (long bytesSent, long elapsedUsec)
+		{
+			BytesSent = bytesSent;
+			Elapsed = TimeSpan.FromTicks (elapsedUsec * 10);
+		}
+
+		public override string ToString ()
+		{
+			return string.Format ("[NativeOpenSslTransferResult: BytesSent={0}, Elapsed={1}, BytesPerSecond={2:F0}]", BytesSent, Elapsed, BytesPerSecond);
+		}
+	}
+}
+
@@ -26,9 +26,13 @@ namespace Mono.Security.NewTls.TestProvider
 			get { return base.Parameters as MonoConnectionParameters; }
 		}
 
+		readonly NativeOpenSslClientPool pool;
+		NativeOpenSslClientPool.PoolKey clientPoolKey;
+
 		public OpenSslClient (OpenSslConnectionProvider provider, ConnectionParameters parameters)
 			: base (provider, parameters)
 		{
+			pool = provider.ClientPool;
 		}
 
 		protected override bool IsServer {
@@ -43,21 +47,43 @@ namespace Mono.Security.NewTls.TestProvider
 		protected override void CreateConnection (TestContext ctx)
 		{
 			var endpoint = GetEndPoint ();
+			byte[] clientCertificate = null;
 			if (Parameters.ClientCertificate != null) {
 				var provider = DependencyInjector.Get<ICertificateProvider> ();
 				string password;
-				var data = provider.GetRawCertificateData (Parameters.ClientCertificate, out password);
-				openssl.SetCertificate (data, password);
+				clientCertificate = provider.GetRawCertificateData (Parameters.ClientCertificate, out password);
+				openssl.SetCertificate (clientCertificate, password);
+			}
+
+			var ciphers = MonoParameters != null ? MonoParameters.ClientCiphers : null;
+			SelectCiphers (ctx, ciphers);
+
+			if (pool == null) {
+				openssl.Connect (endpoint);
+				return;
 			}
 
-			if (MonoParameters != null)
-				SelectCiphers (ctx, MonoParameters.ClientCiphers);
+			clientPoolKey = new NativeOpenSslClientPool.PoolKey (endpoint, openssl.Protocol, ciphers, clientCertificate);
+			var pooled = pool.Acquire (clientPoolKey);
+			if (pooled != null) {
+				// The unused instance may have come from the connection pool.
+				ReleaseInstance (openssl);
+				openssl = pooled;
+				// Still points at the connection which used it last.
+				SetCertificateVerify ();
+			} else {
+				pool.Connect (clientPoolKey, openssl);
+			}
 
-			openssl.Connect (endpoint);
+			ctx.LogDebug (2, "{0} using pooled connection: {1}", this, pool);
 		}
 
 		protected override void Stop ()
 		{
+			if (pool != null && clientPoolKey != null && openssl != null) {
+				pool.Release (clientPoolKey, openssl);
+				openssl = null;
+			}
 			base.Stop ();
 		}
 	}
@@ -59,6 +59,7 @@ namespace Mono.Security.NewTls.TestProvider
 
 		protected NativeOpenSsl openssl;
 		OpenSslConnectionProvider provider;
+		NativeOpenSslPool.PoolKey poolKey;
 		MonoTlsConnectionInfo connectionInfo;
 		TaskCompletionSource<object> createTcs;
 
@@ -180,19 +181,56 @@ namespace Mono.Security.NewTls.TestProvider
 				openssl.SetNamedCurve ("prime256v1");
 		}
 
+		NativeOpenSslPool.PoolKey CreatePoolKey (NativeOpenSslProtocol protocol)
+		{
+			var monoParameters = Parameters as MonoConnectionParameters;
+			ICollection<CipherSuiteCode> ciphers = null;
+			if (monoParameters != null)
+				ciphers = IsServer ? monoParameters.ServerCiphers : monoParameters.ClientCiphers;
+
+			var certificateProvider = DependencyInjector.Get<ICertificateProvider> ();
+			byte[] certificate = null;
+			string password;
+			if (IsServer)
+				certificate = certificateProvider.GetRawCertificateData (Parameters.ServerCertificate, out password);
+			else if (Parameters.ClientCertificate != null)
+				certificate = certificateProvider.GetRawCertificateData (Parameters.ClientCertificate, out password);
+
+			return new NativeOpenSslPool.PoolKey (IsServer, protocol, Parameters.EnableDebugging, certificate, ciphers);
+		}
+
 		public sealed override Task Start (TestContext ctx, CancellationToken cancellationToken)
 		{
 			var protocol = GetProtocolVersion ();
 			ctx.LogMessage ("Starting {0} version {1}.", this, protocol);
-			openssl = new NativeOpenSsl (IsServer, Parameters.EnableDebugging, protocol);
-			var validationCallback = GetValidationCallback ();
-			openssl.SetCertificateVerify (NativeOpenSsl.VerifyMode.SSL_VERIFY_PEER, validationCallback);
+			if (provider.TrackNativeMemory && !NativeOpenSsl.InstallMemoryHooks ())
+				ctx.LogMessage ("Cannot install native memory hooks: OpenSsl has already been initialized.");
+			if (provider.ConnectionPool != null) {
+				poolKey = CreatePoolKey (protocol);
+				openssl = provider.ConnectionPool.Acquire (poolKey);
+			}
+			if (openssl == null)
+				openssl = new NativeOpenSsl (IsServer, Parameters.EnableDebugging, protocol);
+			if (provider.SocketProfile != null)
+				openssl.SetSocketProfile (provider.SocketProfile);
+			if (provider.EnableKernelTls)
+				openssl.EnableKernelTls (true);
+			if (provider.LeanMode)
+				openssl.SetLeanMode (true);
+			if (IsServer && provider.SessionCache != null)
+				openssl.SetSessionCache (provider.SessionCache);
+			SetCertificateVerify ();
 			InitDiffieHellman (protocol);
 			Initialize ();
 
 			Task.Factory.StartNew (() => {
 				try {
 					CreateConnection (ctx);
+					if (provider.UseAsyncIO && !openssl.IsAsyncIO)
+						openssl.StartAsyncIO ();
+					ctx.LogDebug (2, "{0} handshake time: {1} {2} {3} quickack={4}", this, openssl.HandshakeTime, openssl.GetEffectiveSocketProfile (), openssl.KernelTlsMode, openssl.QuickAckCount);
+					if (provider.TrackNativeMemory)
+						ctx.LogDebug (2, "{0} native memory: {1}", this, openssl.GetMemoryStats ());
 					createTcs.SetResult (null);
 				} catch (Exception ex) {
 					createTcs.SetException (ex);
@@ -201,6 +239,12 @@ namespace Mono.Security.NewTls.TestProvider
 			return FinishedTask;
 		}
 
+		protected void SetCertificateVerify ()
+		{
+			var validationCallback = GetValidationCallback ();
+			openssl.SetCertificateVerify (NativeOpenSsl.VerifyMode.SSL_VERIFY_PEER, validationCallback);
+		}
+
 		protected void SelectCiphers (TestContext ctx, ICollection<CipherSuiteCode> ciphers)
 		{
 			if (ciphers == null)
@@ -225,10 +269,19 @@ namespace Mono.Security.NewTls.TestProvider
 			return Task.Factory.FromAsync (openssl.BeginShutdown, openssl.EndShutdown, true, null);
 		}
 
+		// Hands the instance back to the connection pool, if it uses one.
+		protected void ReleaseInstance (NativeOpenSsl instance)
+		{
+			if (provider.ConnectionPool != null && poolKey != null)
+				provider.ConnectionPool.Release (poolKey, instance);
+			else
+				instance.Dispose ();
+		}
+
 		protected override void Stop ()
 		{
 			if (openssl != null) {
-				openssl.Dispose ();
+				ReleaseInstance (openssl);
 				openssl = null;
 			}
 		}
@@ -46,6 +46,44 @@ namespace Mono.Security.NewTls.TestProvider
 			get { return false; }
 		}
 
+		// Applied to every NativeOpenSsl instance created by this provider.
+		public NativeOpenSslSocketProfile SocketProfile {
+			get; set;
+		}
+
+		public bool EnableKernelTls {
+			get; set;
+		}
+
+		public bool LeanMode {
+			get; set;
+		}
+
+		// Account native memory per connection; must be set before the first connection is started.
+		public bool TrackNativeMemory {
+			get; set;
+		}
+
+		// Drive established connections from the native I/O thread (see NativeOpenSsl.StartAsyncIO).
+		public bool UseAsyncIO {
+			get; set;
+		}
+
+		// When set, clients keep their connections alive and reuse them.
+		public NativeOpenSslClientPool ClientPool {
+			get; set;
+		}
+
+		// When set, finished connections are reset and their native objects reused.
+		public NativeOpenSslPool ConnectionPool {
+			get; set;
+		}
+
+		// When set, servers keep their sessions in this cache, which may be shared with other processes.
+		public NativeOpenSslSessionCache SessionCache {
+			get; set;
+		}
+
 		public override ProtocolVersions SupportedProtocols {
 			get { return ProtocolVersions.Tls10 | ProtocolVersions.Tls11 | ProtocolVersions.Tls12; }
 		}
@@ -41,9 +41,21 @@ namespace Mono.Security.NewTls.TestProvider
 	{
 		OpenSslConnectionProvider openSslConnectionProvider;
 
+		// Copied to the provider; see OpenSslConnectionProvider.UseAsyncIO.
+		public bool UseAsyncIO {
+			get; set;
+		}
+
+		// Copied to the provider; see OpenSslConnectionProvider.SessionCache.
+		public NativeOpenSslSessionCache SessionCache {
+			get; set;
+		}
+
 		public void Initialize (ConnectionProviderFactory factory, IDefaultConnectionSettings settings)
 		{
 			openSslConnectionProvider = new OpenSslConnectionProvider (factory);
+			openSslConnectionProvider.UseAsyncIO = UseAsyncIO;
+			openSslConnectionProvider.SessionCache = SessionCache;
 			factory.Install (openSslConnectionProvider);
 		}
 	}
@@ -0,0 +1,725 @@
+﻿//
+// RecordLayerHost.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.IO;
+using System.Threading;
+using System.Threading.Tasks;
+using System.Collections.Generic;
+using System.Security.Cryptography;
+using Mono.Security.Interface;
+using Mono.Security.NewTls.Cipher;
+using Xamarin.AsyncTests;
+using Xamarin.AsyncTests.Constraints;
+using Xamarin.WebTests.ConnectionFramework;
+using Xamarin.WebTests.Resources;
+
+namespace Mono.Security.NewTls.TestProvider
+{
+	using TestFramework;
+	using MX = Mono.Security.X509;
+
+	public class RecordLayerHost : IRecordLayerTestHost
+	{
+		const CipherSuiteCode Cipher = CipherSuiteCode.TLS_RSA_WITH_AES_128_GCM_SHA256;
+
+		MX.X509Certificate certificate;
+		AsymmetricAlgorithm privateKey;
+		DateTime now = new DateTime (2015, 10, 1, 0, 0, 0, DateTimeKind.Utc);
+
+		TlsContext CreateContext (bool server, bool askForCertificate = false)
+		{
+			return CreateContext (CreateConfiguration (server, askForCertificate), server);
+		}
+
+		TlsConfiguration CreateConfiguration (bool server, bool askForCertificate = false)
+		{
+			var settings = MonoTlsSettings.CopyDefaultSettings ();
+			settings.EnabledCiphers = new CipherSuiteCode[] { Cipher };
+			settings.RemoteCertificateValidationCallback = (targetHost, cert, chain, errors) => true;
+
+			TlsConfiguration configuration;
+			if (server)
+				configuration = new TlsConfiguration (TlsProtocols.Tls12, settings, certificate, privateKey);
+			else
+				configuration = new TlsConfiguration (TlsProtocols.Tls12, settings, "localhost");
+			if (askForCertificate)
+				configuration.AskForClientCertificate = true;
+			return configuration;
+		}
+
+		TlsContext CreateContext (TlsConfiguration configuration, bool server)
+		{
+			// Dynamic record sizing goes by this clock.
+			var context = new TlsContext (configuration, server, null);
+			context.SetHandshakeSources (RandomNumberGenerator.Create (), () => now);
+			return context;
+		}
+
+		/*
+		 * The client never has a certificate; when the context asks for one, we hand
+		 * it the same record again.
+		 */
+		static SecurityStatus Step (TlsContext context, byte[] record, Queue<byte[]> sent, ref int credentialsNeeded)
+		{
+			var outgoing = new TlsMultiBuffer ();
+			var status = context.GenerateNextToken (record != null ? new TlsBuffer (record) : null, outgoing);
+			if (status == SecurityStatus.CredentialsNeeded) {
+				credentialsNeeded++;
+				status = context.GenerateNextToken (new TlsBuffer (record), outgoing);
+			}
+			if (status != SecurityStatus.OK && status != SecurityStatus.ContinueNeeded)
+				throw new InvalidOperationException (string.Format ("Handshake failed: {0} {1}", status, context.LastError));
+
+			if (!outgoing.IsEmpty)
+				Split (outgoing.StealBuffer (), sent);
+			return status;
+		}
+
+		static void Split (byte[] data, Queue<byte[]> records)
+		{
+			for (int offset = 0; offset < data.Length; ) {
+				var size = 5 + (data [offset + 3] << 8 | data [offset + 4]);
+				var copy = new byte [size];
+				Buffer.BlockCopy (data, offset, copy, 0, size);
+				records.Enqueue (copy);
+				offset += size;
+			}
+		}
+
+		// Returns how often the client asked for credentials.
+		static int Handshake (TlsContext client, TlsContext server)
+		{
+			return Handshake (client, server, null);
+		}
+
+		/*
+		 * Starts a new handshake on the client, either from scratch or - if `helloRequest'
+		 * is set - in response to the server's HelloRequest, and runs it to completion.
+		 */
+		static int Handshake (TlsContext client, TlsContext server, byte[] helloRequest)
+		{
+			var toServer = new Queue<byte[]> ();
+			var toClient = new Queue<byte[]> ();
+			var credentialsNeeded = 0;
+
+			var clientStatus = Step (client, helloRequest, toServer, ref credentialsNeeded);
+			Complete (client, server, toServer, toClient, clientStatus, ref credentialsNeeded);
+			return credentialsNeeded;
+		}
+
+		static void Complete (TlsContext client, TlsContext server, Queue<byte[]> toServer, Queue<byte[]> toClient,
+			SecurityStatus clientStatus, ref int credentialsNeeded)
+		{
+			var serverStatus = SecurityStatus.ContinueNeeded;
+
+			while (clientStatus != SecurityStatus.OK || serverStatus != SecurityStatus.OK) {
+				if (toServer.Count > 0)
+					serverStatus = Step (server, toServer.Dequeue (), toClient, ref credentialsNeeded);
+				else if (toClient.Count > 0)
+					clientStatus = Step (client, toClient.Dequeue (), toServer, ref credentialsNeeded);
+				else
+					throw new InvalidOperationException ("Handshake stalled.");
+			}
+		}
+
+		/*
+		 * Like Handshake(), but the server's first flight reaches the client in different
+		 * records: `getCuts' gets the flight's handshake messages and their sizes (including
+		 * their headers) and returns the offset at which each of the new records ends.
+		 */
+		static int Handshake (TestContext ctx, TlsContext client, TlsContext server, Func<byte[], List<int>, int[]> getCuts)
+		{
+			var toServer = new Queue<byte[]> ();
+			var toClient = new Queue<byte[]> ();
+			var credentialsNeeded = 0;
+
+			Step (client, null, toServer, ref credentialsNeeded);
+			while (toServer.Count > 0)
+				Step (server, toServer.Dequeue (), toClient, ref credentialsNeeded);
+
+			var flight = new MemoryStream ();
+			byte[] header = null;
+			while (toClient.Count > 0) {
+				header = toClient.Dequeue ();
+				ctx.Assert ((ContentType)header [0], Is.EqualTo (ContentType.Handshake), "plain text handshake record");
+				flight.Write (header, 5, header.Length - 5);
+			}
+
+			var messages = flight.ToArray ();
+			var sizes = new List<int> ();
+			for (int offset = 0; offset < messages.Length; offset += sizes [sizes.Count - 1])
+				sizes.Add (4 + ((messages [offset + 1] << 16) | (messages [offset + 2] << 8) | messages [offset + 3]));
+
+			var cuts = getCuts (messages, sizes);
+			var start = 0;
+			for (int i = 0; i < cuts.Length; i++) {
+				var length = cuts [i] - start;
+				var record = new byte [5 + length];
+				record [0] = (byte)ContentType.Handshake;
+				record [1] = header [1];
+				record [2] = header [2];
+				record [3] = (byte)(length >> 8);
+				record [4] = (byte)length;
+				Buffer.BlockCopy (messages, start, record, 5, length);
+				start = cuts [i];
+
+				if (i == cuts.Length - 1) {
+					toClient.Enqueue (record);
+					break;
+				}
+
+				ctx.Assert (Step (client, record, toServer, ref credentialsNeeded), Is.EqualTo (SecurityStatus.ContinueNeeded), "fragment #{0}", i);
+				ctx.Assert (toServer.Count, Is.EqualTo (0), "no reply before the flight is complete");
+			}
+			ctx.Assert (start, Is.EqualTo (messages.Length), "entire flight");
+
+			Complete (client, server, toServer, toClient, SecurityStatus.ContinueNeeded, ref credentialsNeeded);
+			return credentialsNeeded;
+		}
+
+		static TlsBuffer Encrypt (TestContext ctx, TlsContext context, int size)
+		{
+			var buffer = new TlsBuffer (new byte [size]);
+			ctx.Assert (context.EncryptMessage (ref buffer), Is.EqualTo (SecurityStatus.OK), "encrypt");
+			return buffer;
+		}
+
+		/*
+		 * Sends `size' bytes of application data from `sender' to `receiver' and returns
+		 * a copy of each record, as it was before the receiver decrypted it.
+		 */
+		static List<byte[]> TransferRecords (TestContext ctx, TlsContext sender, TlsContext receiver, int size)
+		{
+			var records = new Queue<byte[]> ();
+			var encrypted = Encrypt (ctx, sender, size);
+			var data = new byte [encrypted.Remaining];
+			Buffer.BlockCopy (encrypted.Buffer, encrypted.Position, data, 0, data.Length);
+			Split (data, records);
+
+			var sent = new List<byte[]> ();
+			var received = 0;
+			while (records.Count > 0) {
+				var record = records.Dequeue ();
+				sent.Add ((byte[])record.Clone ());
+				var buffer = new TlsBuffer (record);
+				ctx.Assert (receiver.DecryptMessage (ref buffer), Is.EqualTo (SecurityStatus.OK), "decrypt");
+				received += buffer.Remaining;
+			}
+
+			ctx.Assert (received, Is.EqualTo (size), "received");
+			return sent;
+		}
+
+		// Like TransferRecords(), but only returns the length of each record.
+		static List<int> Transfer (TestContext ctx, TlsContext sender, TlsContext receiver, int size)
+		{
+			var sizes = new List<int> ();
+			foreach (var record in TransferRecords (ctx, sender, receiver, size))
+				sizes.Add (record.Length - 5);
+			return sizes;
+		}
+
+		// Maximum TLSCiphertext fragment length which we send.
+		const int MaxRecordSize = 16384;
+
+		static void AssertRecordSizes (TestContext ctx, List<int> sizes, int min, int max, string message)
+		{
+			foreach (var size in sizes) {
+				ctx.Assert (size, Is.GreaterThanOrEqualTo (min), message);
+				ctx.Assert (size, Is.LessThanOrEqualTo (max), message);
+			}
+		}
+
+		public void RunBufferReuse (TestContext ctx)
+		{
+			using (var client = CreateContext (false))
+			using (var server = CreateContext (true)) {
+				Handshake (client, server);
+
+				var first = Encrypt (ctx, client, 100).Buffer;
+				var reuses = client.RecordBufferReuses;
+
+				// Same size class, so the first message's buffer comes straight back.
+				var second = Encrypt (ctx, client, 200).Buffer;
+				ctx.Assert (ReferenceEquals (first, second), Is.True, "record buffer reused");
+				ctx.Assert (client.RecordBufferReuses, Is.EqualTo (reuses + 1), "reuses");
+			}
+		}
+
+		public void RunDynamicRecordSizing (TestContext ctx)
+		{
+			using (var client = CreateContext (false))
+			using (var server = CreateContext (true)) {
+				Handshake (client, server);
+
+				var configuration = client.Configuration;
+				ctx.Assert (configuration.DynamicRecordSizing, Is.True, "enabled by default");
+				var initialSize = configuration.InitialRecordSize;
+				var chunks = configuration.DynamicRecordSizeThreshold / 16384;
+
+				// The first DynamicRecordSizeThreshold bytes of a burst go out in small records ...
+				var all = new List<int> ();
+				for (int i = 0; i < chunks; i++) {
+					var sizes = Transfer (ctx, client, server, 16384);
+					AssertRecordSizes (ctx, sizes, 1, initialSize, "ramp");
+					all.AddRange (sizes);
+				}
+
+				// ... and everything after that in full-size ones, as long as the writer doesn't go idle.
+				now += TimeSpan.FromTicks (configuration.DynamicRecordIdleTimeout.Ticks / 2);
+				var large = Transfer (ctx, client, server, 65536);
+				AssertRecordSizes (ctx, large, 1, MaxRecordSize, "full size");
+				ctx.Assert (large.Count, Is.LessThanOrEqualTo (5), "full-size records");
+				ctx.Assert (large [0], Is.GreaterThan (8192), "first full-size record");
+				all.AddRange (large);
+
+				// Idle for longer than DynamicRecordIdleTimeout: back to small records.
+				now += configuration.DynamicRecordIdleTimeout + TimeSpan.FromMilliseconds (1);
+				var reset = Transfer (ctx, client, server, 16384);
+				AssertRecordSizes (ctx, reset, 1, initialSize, "after idle");
+				all.AddRange (reset);
+
+				// Only application data records are counted.
+				var distribution = client.RecordSizeDistribution;
+				ctx.LogMessage ("Record sizes: {0}", distribution);
+				long totalBytes = 0;
+				foreach (var size in all)
+					totalBytes += size;
+				for (int bucket = 0; bucket < distribution.BucketCount; bucket++) {
+					var lower = bucket > 0 ? distribution.GetBucketLimit (bucket - 1) : 0;
+					var upper = distribution.GetBucketLimit (bucket);
+					var expected = all.FindAll (size => size > lower && size <= upper).Count;
+					ctx.Assert (distribution.GetCount (bucket), Is.EqualTo ((long)expected), "bucket {0}", bucket);
+				}
+				ctx.Assert (distribution.TotalRecords, Is.EqualTo ((long)all.Count), "total records");
+				ctx.Assert (distribution.TotalBytes, Is.EqualTo (totalBytes), "total bytes");
+			}
+		}
+
+		public void RunFragmentedHandshake (TestContext ctx)
+		{
+			using (var client = CreateContext (false))
+			using (var server = CreateContext (true)) {
+				Handshake (ctx, client, server, (messages, sizes) => {
+					// ServerHello, Certificate, ServerHelloDone.
+					ctx.Assert (sizes.Count, Is.EqualTo (3), "server flight");
+					var certificateStart = sizes [0];
+					var certificateEnd = certificateStart + sizes [1];
+
+					/*
+					 * Split the first message's header; then the end of ServerHello and part
+					 * of the Certificate's header; then most of the Certificate; finally its
+					 * last bytes, followed by all of ServerHelloDone.
+					 */
+					return new int[] { 2, certificateStart + 3, certificateEnd - 10, certificateEnd + sizes [2] };
+				});
+
+				ctx.Assert (client.HandshakeReassemblyBuffers, Is.GreaterThan (0L), "reassembled");
+				Transfer (ctx, client, server, 100);
+				Transfer (ctx, server, client, 100);
+			}
+		}
+
+		public void RunFragmentedCertificateRequest (TestContext ctx)
+		{
+			using (var client = CreateContext (false))
+			using (var server = CreateContext (true, true)) {
+				var credentialsNeeded = Handshake (ctx, client, server, sizes => {
+					// ServerHello, Certificate, CertificateRequest, ServerHelloDone.
+					ctx.Assert (sizes.Count, Is.EqualTo (4), "server flight");
+					var requestStart = sizes [0] + sizes [1];
+
+					// CertificateRequest is only complete once the second record has been reassembled.
+					return new int[] { requestStart + 2, requestStart + sizes [2] + sizes [3] };
+				});
+
+				// The retry must pick up the reassembled messages where we left off.
+				ctx.Assert (credentialsNeeded, Is.EqualTo (1), "credentials needed");
+				Transfer (ctx, client, server, 100);
+				Transfer (ctx, server, client, 100);
+			}
+		}
+
+		public void RunRenegotiationCertificateRequest (TestContext ctx)
+		{
+			using (var client = CreateContext (false))
+			using (var server = CreateContext (true, true)) {
+				// The first CertificateRequest arrives in plain text.
+				ctx.Assert (Handshake (client, server), Is.EqualTo (1), "initial handshake");
+				Transfer (ctx, client, server, 100);
+
+				var helloRequest = server.CreateHelloRequest ();
+				var buffer = new TlsBuffer (helloRequest);
+				ctx.Assert (client.DecryptMessage (ref buffer), Is.EqualTo (SecurityStatus.Renegotiate), "hello request");
+
+				// This one is encrypted and has already been decrypted in place when the client asks for credentials.
+				ctx.Assert (Handshake (client, server, helloRequest), Is.EqualTo (1), "renegotiation");
+				Transfer (ctx, client, server, 100);
+				Transfer (ctx, server, client, 100);
+			}
+		}
+
+		static void AssertRecordCounts (TestContext ctx, TlsConnectionStatistics sender, TlsConnectionStatistics receiver, string direction)
+		{
+			ctx.Assert (receiver.RecordsReceived, Is.EqualTo (sender.RecordsSent), "{0} records", direction);
+			ctx.Assert (receiver.BytesReceived, Is.EqualTo (sender.BytesSent), "{0} bytes", direction);
+		}
+
+		public void RunStatistics (TestContext ctx)
+		{
+			var processBefore = TlsConnectionStatistics.Process;
+
+			using (var client = CreateContext (false))
+			using (var server = CreateContext (true)) {
+				Handshake (client, server);
+
+				var clientStatistics = client.Statistics;
+				var serverStatistics = server.Statistics;
+				ctx.Assert (clientStatistics.Handshakes, Is.EqualTo (1L), "client handshakes");
+				ctx.Assert (serverStatistics.Handshakes, Is.EqualTo (1L), "server handshakes");
+				ctx.Assert (clientStatistics.RecordsSent, Is.GreaterThan (0L), "handshake records");
+				AssertRecordCounts (ctx, clientStatistics, serverStatistics, "client to server");
+				AssertRecordCounts (ctx, serverStatistics, clientStatistics, "server to client");
+
+				var recordsSent = clientStatistics.RecordsSent;
+				var bytesSent = clientStatistics.BytesSent;
+
+				var sizes = Transfer (ctx, client, server, 100);
+				ctx.Assert (sizes.Count, Is.EqualTo (1), "one record");
+				var bytes = 5L + sizes [0];
+
+				ctx.Assert (clientStatistics.RecordsSent, Is.EqualTo (recordsSent + 1), "application data records");
+				ctx.Assert (clientStatistics.BytesSent, Is.EqualTo (bytesSent + bytes), "application data bytes");
+				AssertRecordCounts (ctx, clientStatistics, serverStatistics, "client to server");
+				AssertRecordCounts (ctx, serverStatistics, clientStatistics, "server to client");
+
+				// Neither context has been cleared, but both are already part of the totals.
+				var process = TlsConnectionStatistics.Process;
+				var records = clientStatistics.RecordsSent + serverStatistics.RecordsSent;
+				ctx.Assert (process.Handshakes, Is.GreaterThanOrEqualTo (processBefore.Handshakes + 2), "process handshakes");
+				ctx.Assert (process.RecordsSent, Is.GreaterThanOrEqualTo (processBefore.RecordsSent + records), "process records sent");
+				ctx.Assert (process.RecordsReceived, Is.GreaterThanOrEqualTo (processBefore.RecordsReceived + records), "process records received");
+				ctx.Assert (process.BytesSent, Is.GreaterThanOrEqualTo (processBefore.BytesSent + clientStatistics.BytesSent + serverStatistics.BytesSent), "process bytes sent");
+			}
+		}
+
+		// Runs a handshake with a server using `configuration' and returns its Certificate message.
+		byte[] GetCertificateMessage (TestContext ctx, TlsConfiguration configuration)
+		{
+			byte[] message = null;
+			using (var client = CreateContext (false))
+			using (var server = CreateContext (configuration, true)) {
+				Handshake (ctx, client, server, (messages, sizes) => {
+					// ServerHello, Certificate, ServerHelloDone.
+					ctx.Assert (sizes.Count, Is.EqualTo (3), "server flight");
+					message = new byte [sizes [1]];
+					Buffer.BlockCopy (messages, sizes [0], message, 0, sizes [1]);
+					return new int[] { messages.Length };
+				});
+				Transfer (ctx, client, server, 100);
+			}
+			return message;
+		}
+
+		static void WriteInt24 (byte[] buffer, int offset, int value)
+		{
+			buffer [offset] = (byte)(value >> 16);
+			buffer [offset + 1] = (byte)(value >> 8);
+			buffer [offset + 2] = (byte)value;
+		}
+
+		// Certificate message with a single certificate, as RFC 5246 describes it.
+		static byte[] EncodeCertificateMessage (MX.X509Certificate certificate)
+		{
+			var data = certificate.RawData;
+			var message = new byte [10 + data.Length];
+			message [0] = 11;
+			WriteInt24 (message, 1, data.Length + 6);
+			WriteInt24 (message, 4, data.Length + 3);
+			WriteInt24 (message, 7, data.Length);
+			Buffer.BlockCopy (data, 0, message, 10, data.Length);
+			return message;
+		}
+
+		public void RunCertificateMessageCache (TestContext ctx)
+		{
+			var configuration = CreateConfiguration (true);
+			ctx.Assert (configuration.CertificateMessagesEncoded, Is.EqualTo (0), "not encoded yet");
+
+			var first = GetCertificateMessage (ctx, configuration);
+			ctx.Assert (first, Is.EqualTo (EncodeCertificateMessage (certificate)), "encoding");
+			ctx.Assert (configuration.CertificateMessagesEncoded, Is.EqualTo (1), "first handshake");
+
+			var second = GetCertificateMessage (ctx, configuration);
+			ctx.Assert (second, Is.EqualTo (first), "second handshake");
+			ctx.Assert (configuration.CertificateMessagesEncoded, Is.EqualTo (1), "cached");
+
+			// Even the same certificate must be encoded again.
+			configuration.SetCertificate (certificate, privateKey);
+			var third = GetCertificateMessage (ctx, configuration);
+			ctx.Assert (third, Is.EqualTo (first), "new certificate");
+			ctx.Assert (configuration.CertificateMessagesEncoded, Is.EqualTo (2), "cache dropped");
+		}
+
+		static byte[] GetHash (HandshakeHash hash)
+		{
+			using (var digest = hash.GetHash (HandshakeHashType.SHA256))
+				return (byte[])digest.Buffer.Clone ();
+		}
+
+		static byte[] ComputeHash (byte[] data, int length)
+		{
+			using (var sha256 = SHA256.Create ())
+				return sha256.ComputeHash (data, 0, length);
+		}
+
+		public void RunHandshakeHash (TestContext ctx)
+		{
+			// More than the initial transcript buffer.
+			var data = new byte [10000];
+			for (int i = 0; i < data.Length; i++)
+				data [i] = (byte)(i * 7);
+			var cuts = new int[] { 0, 100, 5000, 9000, data.Length };
+
+			using (var incremental = new HandshakeHash ())
+			using (var replayed = new HandshakeHash ()) {
+				// Created before the first message, so this one is fed as they're added.
+				incremental.GetHash (HandshakeHashType.SHA256).Dispose ();
+				for (int i = 1; i < cuts.Length - 1; i++) {
+					var message = new BufferOffsetSize (data, cuts [i - 1], cuts [i] - cuts [i - 1]);
+					incremental.Add (message);
+					replayed.Add (message);
+				}
+
+				var length = cuts [cuts.Length - 2];
+				ctx.Assert (replayed.TranscriptLength, Is.EqualTo (length), "transcript");
+				ctx.Assert (replayed.Algorithms, Is.EqualTo (0), "no algorithm yet");
+				ctx.Assert (replayed.BytesHashed, Is.EqualTo (0L), "nothing hashed yet");
+
+				var expected = ComputeHash (data, length);
+				ctx.Assert (GetHash (incremental), Is.EqualTo (expected), "incremental hash");
+				ctx.Assert (GetHash (replayed), Is.EqualTo (expected), "replayed hash");
+				ctx.Assert (incremental.BytesHashed, Is.EqualTo ((long)length), "incremental bytes hashed");
+				ctx.Assert (replayed.BytesHashed, Is.EqualTo ((long)length), "replayed bytes hashed");
+
+				// Once it has been replayed, the algorithm is fed like the other one.
+				var last = new BufferOffsetSize (data, length, data.Length - length);
+				incremental.Add (last);
+				replayed.Add (last);
+				expected = ComputeHash (data, data.Length);
+				ctx.Assert (GetHash (incremental), Is.EqualTo (expected), "incremental hash after replay");
+				ctx.Assert (GetHash (replayed), Is.EqualTo (expected), "replayed hash after replay");
+				ctx.Assert (replayed.BytesHashed, Is.EqualTo ((long)data.Length), "bytes hashed after replay");
+				ctx.Assert (replayed.Algorithms, Is.EqualTo (1), "algorithms");
+
+				replayed.Dispose ();
+				ctx.Assert (replayed.TranscriptLength, Is.EqualTo (0), "transcript cleared");
+				ctx.Assert (replayed.Algorithms, Is.EqualTo (0), "algorithms cleared");
+			}
+
+			using (var client = CreateContext (false))
+			using (var server = CreateContext (true)) {
+				Handshake (client, server);
+
+				// With RSA key exchange and no client certificate, only the Finished messages need a hash.
+				ctx.Assert (client.HandshakeTranscriptLength, Is.GreaterThan (0L), "client transcript");
+				ctx.Assert (server.HandshakeTranscriptLength, Is.GreaterThan (0L), "server transcript");
+				ctx.Assert (client.HandshakeBytesHashed, Is.EqualTo (client.HandshakeTranscriptLength), "client bytes hashed");
+				ctx.Assert (server.HandshakeBytesHashed, Is.EqualTo (server.HandshakeTranscriptLength), "server bytes hashed");
+			}
+		}
+
+		// The 8-byte explicit nonce which follows the header of a GCM record.
+		static ulong GetExplicitNonce (byte[] record)
+		{
+			ulong nonce = 0;
+			for (int i = 0; i < 8; i++)
+				nonce = (nonce << 8) | record [5 + i];
+			return nonce;
+		}
+
+		void CheckSequenceNonces (TestContext ctx, GcmNonceType type)
+		{
+			var clientConfiguration = CreateConfiguration (false);
+			var serverConfiguration = CreateConfiguration (true);
+			clientConfiguration.GcmNonceType = type;
+			serverConfiguration.GcmNonceType = type;
+
+			using (var client = CreateContext (clientConfiguration, false))
+			using (var server = CreateContext (serverConfiguration, true)) {
+				Handshake (client, server);
+
+				// The Finished message is record zero, so application data starts at one.
+				ulong expected = 1;
+				for (int i = 0; i < 2; i++) {
+					foreach (var record in TransferRecords (ctx, client, server, 3 * MaxRecordSize)) {
+						ctx.Assert ((ContentType)record [0], Is.EqualTo (ContentType.ApplicationData), "{0}: content type", type);
+						ctx.Assert (GetExplicitNonce (record), Is.EqualTo (expected), "{0}: client nonce", type);
+						expected++;
+					}
+				}
+				ctx.Assert (expected, Is.GreaterThanOrEqualTo (7UL), "{0}: records", type);
+
+				// Each direction has its own sequence number.
+				var reply = TransferRecords (ctx, server, client, 100);
+				ctx.Assert (reply.Count, Is.EqualTo (1), "{0}: one record", type);
+				ctx.Assert (GetExplicitNonce (reply [0]), Is.EqualTo (1UL), "{0}: server nonce", type);
+			}
+		}
+
+		public void RunGcmSequenceNonce (TestContext ctx)
+		{
+			ctx.Assert (CreateConfiguration (false).GcmNonceType, Is.EqualTo (GcmNonceType.Default), "default");
+			CheckSequenceNonces (ctx, GcmNonceType.Default);
+			CheckSequenceNonces (ctx, GcmNonceType.SequenceNumber);
+		}
+
+		public void RunGcmRandomNonce (TestContext ctx)
+		{
+			var clientConfiguration = CreateConfiguration (false);
+			var serverConfiguration = CreateConfiguration (true);
+			clientConfiguration.GcmNonceType = GcmNonceType.Random;
+			serverConfiguration.GcmNonceType = GcmNonceType.Random;
+
+			using (var client = CreateContext (clientConfiguration, false))
+			using (var server = CreateContext (serverConfiguration, true)) {
+				Handshake (client, server);
+
+				/*
+				 * More records than one BufferedRandomNumberGenerator block holds nonces
+				 * for, so the generator has to be refilled along the way.
+				 */
+				const int count = 2 * BufferedRandomNumberGenerator.DefaultBufferSize / 8 + 1;
+				var nonces = new HashSet<ulong> ();
+				var sequential = 0;
+				for (int i = 0; i < count; i++) {
+					var records = TransferRecords (ctx, client, server, 10);
+					ctx.Assert (records.Count, Is.EqualTo (1), "one record");
+					var nonce = GetExplicitNonce (records [0]);
+					ctx.Assert (nonces.Add (nonce), Is.True, "nonce #{0} is unique", i);
+					if (nonce == (ulong)i + 1)
+						sequential++;
+				}
+				ctx.Assert (sequential, Is.LessThanOrEqualTo (1), "nonces are not sequence numbers");
+			}
+		}
+
+		// Hands out 0, 1, 2, ... so that each byte tells where in the stream it came from.
+		class CountingRandomNumberGenerator : RandomNumberGenerator
+		{
+			int next;
+
+			public int Calls {
+				get;
+				private set;
+			}
+
+			public override void GetBytes (byte[] data)
+			{
+				Calls++;
+				for (int i = 0; i < data.Length; i++)
+					data [i] = (byte)next++;
+			}
+
+			public override void GetNonZeroBytes (byte[] data)
+			{
+				GetBytes (data);
+			}
+		}
+
+		static void GetBytes (TestContext ctx, BufferedRandomNumberGenerator random, HashSet<byte> seen,
+			int count, int first, int refills, string message)
+		{
+			// Surround the requested range by bytes which must not be touched.
+			var data = new byte [count + 2];
+			data [0] = data [count + 1] = 0xff;
+			random.GetBytes (data, 1, count);
+
+			ctx.Assert (random.Refills, Is.EqualTo (refills), "{0}: refills", message);
+			ctx.Assert (data [0], Is.EqualTo ((byte)0xff), "{0}: before offset", message);
+			ctx.Assert (data [count + 1], Is.EqualTo ((byte)0xff), "{0}: after count", message);
+			for (int i = 0; i < count; i++) {
+				ctx.Assert (data [i + 1], Is.EqualTo ((byte)(first + i)), "{0}: byte #{1}", message, i);
+				ctx.Assert (seen.Add (data [i + 1]), Is.True, "{0}: byte #{1} handed out once", message, i);
+			}
+		}
+
+		public void RunBufferedRandom (TestContext ctx)
+		{
+			var generator = new CountingRandomNumberGenerator ();
+			var seen = new HashSet<byte> ();
+
+			using (var random = new BufferedRandomNumberGenerator (generator, 16)) {
+				ctx.Assert (random.Refills, Is.EqualTo (0), "lazy");
+				ctx.Assert (generator.Calls, Is.EqualTo (0), "no calls before the first request");
+
+				GetBytes (ctx, random, seen, 8, 0, 1, "first block");
+				GetBytes (ctx, random, seen, 8, 8, 1, "end of first block");
+				GetBytes (ctx, random, seen, 8, 16, 2, "second block");
+				GetBytes (ctx, random, seen, 5, 24, 2, "middle of second block");
+
+				// Only three bytes are left, so they are dropped.
+				GetBytes (ctx, random, seen, 5, 32, 3, "third block");
+				ctx.Assert (generator.Calls, Is.EqualTo (3), "one call per refill");
+
+				// Larger than the buffer: goes straight to the generator and leaves the buffer alone.
+				GetBytes (ctx, random, seen, 20, 48, 3, "larger than buffer");
+				ctx.Assert (generator.Calls, Is.EqualTo (4), "direct call");
+				GetBytes (ctx, random, seen, 11, 37, 3, "rest of third block");
+
+				GetBytes (ctx, random, seen, 16, 68, 4, "entire block");
+				ctx.Assert (generator.Calls, Is.EqualTo (5), "calls");
+			}
+		}
+
+		public Task Initialize (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.Run (() => {
+				var provider = DependencyInjector.Get<ICertificateProvider> ();
+				string password;
+				var data = provider.GetRawCertificateData (ResourceManager.SelfSignedServerCertificate, out password);
+				var pkcs12 = new MX.PKCS12 (data, password);
+				certificate = pkcs12.Certificates [0];
+				privateKey = (AsymmetricAlgorithm)pkcs12.Keys [0];
+			});
+		}
+
+		public Task PreRun (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+
+		public Task PostRun (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+
+		public Task Destroy (TestContext ctx, CancellationToken cancellationToken)
+		{
+			return Task.FromResult<object> (null);
+		}
+	}
+}
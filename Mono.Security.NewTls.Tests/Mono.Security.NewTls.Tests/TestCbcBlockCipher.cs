@@ -273,6 +273,25 @@ namespace Mono.Security.NewTls.Tests
 			ctx.Assert (decrypted, Is.EqualTo (hello), "#4");
 		}
 
+		[AsyncTest]
+		public void TestDecryptInPlace (TestContext ctx, [TestHost] IEncryptionTestHost host)
+		{
+			var input = GetBuffer (HelloWorldResult);
+			var hello = GetField (HelloWorldName);
+
+			var buffer = new byte [input.Size + 7];
+			Buffer.BlockCopy (input.Buffer, input.Offset, buffer, 7, input.Size);
+
+			var output = host.DecryptInPlace (new BufferOffsetSize (buffer, 7, input.Size));
+			ctx.Assert (output.Buffer == buffer, "#1");
+			ctx.Assert (output.Offset, Is.GreaterThanOrEqualTo (7), "#2");
+			ctx.Assert (output.Size, Is.EqualTo (hello.Length), "#3");
+
+			var decrypted = new byte [output.Size];
+			Buffer.BlockCopy (output.Buffer, output.Offset, decrypted, 0, output.Size);
+			ctx.Assert (decrypted, Is.EqualTo (hello), "#4");
+		}
+
 		[AsyncTest]
 		public void TestDecryptData0 (TestContext ctx, [TestHost] IEncryptionTestHost host)
 		{
@@ -0,0 +1,105 @@
+﻿//
+// TestEllipticCurves.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using Xamarin.AsyncTests;
+using Xamarin.AsyncTests.Constraints;
+
+namespace Mono.Security.NewTls.Tests
+{
+	using TestFramework;
+	using TestFeatures;
+
+	[AsyncTestFixture]
+	public class TestEllipticCurves : ITestHost<IEllipticCurveTestHost>
+	{
+		public IEllipticCurveTestHost CreateInstance (TestContext context)
+		{
+			var provider = DependencyInjector.Get<ICryptoProvider> ();
+			return provider.GetEllipticCurveTestHost (CryptoProviderType.Mono);
+		}
+
+		static readonly NamedCurve[] Curves = {
+			NamedCurve.secp256k1, NamedCurve.secp256r1, NamedCurve.secp384r1, NamedCurve.secp521r1
+		};
+
+		[AsyncTest]
+		public void TestMultiplyGenerator (TestContext ctx, [TestHost] IEllipticCurveTestHost host)
+		{
+			foreach (var curve in Curves) {
+				for (int i = 0; i < 8; i++) {
+					// Deliberately longer than the order, so the reduction path is covered as well.
+					var scalar = host.GetRandomBytes (72);
+					var expected = host.MultiplyGenerator (curve, scalar, false);
+					var actual = host.MultiplyGenerator (curve, scalar, true);
+					ctx.Assert (actual, Is.EqualTo (expected), "{0} #{1}", curve, i);
+				}
+
+				var one = new byte[] { 1 };
+				ctx.Assert (host.MultiplyGenerator (curve, one, true), Is.EqualTo (host.MultiplyGenerator (curve, one, false)), "{0} one", curve);
+			}
+		}
+
+		[AsyncTest]
+		public void TestSpecializedField (TestContext ctx, [TestHost] IEllipticCurveTestHost host)
+		{
+			foreach (var curve in Curves) {
+				for (int i = 0; i < 8; i++) {
+					var point = host.MultiplyGenerator (curve, host.GetRandomBytes (32), true);
+					var scalar = host.GetRandomBytes (48);
+					var expected = host.Multiply (curve, point, scalar, true);
+					var actual = host.Multiply (curve, point, scalar, false);
+					ctx.Assert (actual, Is.EqualTo (expected), "{0} #{1}", curve, i);
+				}
+			}
+		}
+
+		[Benchmark]
+		[AsyncTest]
+		public void BenchmarkKeyAgreement (TestContext ctx, [TestHost] IEllipticCurveTestHost host)
+		{
+			foreach (var curve in Curves) {
+				var generic = host.BenchmarkKeyAgreement (curve, 10, true);
+				var specialized = host.BenchmarkKeyAgreement (curve, 10, false);
+				ctx.LogMessage ("{0}: 10 ECDHE exchanges - generic {1}, specialized {2} ({3:F2}x)", curve,
+					generic, specialized, generic.TotalMilliseconds / specialized.TotalMilliseconds);
+			}
+		}
+
+		[Benchmark]
+		[AsyncTest]
+		public void BenchmarkMultiplyGenerator (TestContext ctx, [TestHost] IEllipticCurveTestHost host)
+		{
+			const int Iterations = 200;
+
+			foreach (var curve in Curves) {
+				var generic = host.BenchmarkMultiplyGenerator (curve, Iterations, false);
+				var precomputed = host.BenchmarkMultiplyGenerator (curve, Iterations, true);
+				ctx.LogMessage ("{0}: {1} x G - generic {2}, precomputed {3} ({4:F2}x)", curve, Iterations,
+					generic, precomputed, generic.TotalMilliseconds / precomputed.TotalMilliseconds);
+			}
+		}
+	}
+}
@@ -185,6 +185,43 @@ namespace Mono.Security.NewTls.Tests
 			var decrypted = output.ReadBytes (length);
 			ctx.Assert (decrypted, Is.EqualTo (hello), "#4");
 		}
+
+		[AsyncTest]
+		public void TestDecryptInPlace (TestContext ctx, [TestHost] IEncryptionTestHost host)
+		{
+			var input = GetBuffer (HelloWorldResult);
+			var hello = GetField (HelloWorldName);
+
+			var buffer = new byte [input.Size + 7];
+			Buffer.BlockCopy (input.Buffer, input.Offset, buffer, 7, input.Size);
+
+			var output = host.DecryptInPlace (new BufferOffsetSize (buffer, 7, input.Size));
+			ctx.Assert (output.Buffer == buffer, "#1");
+			ctx.Assert (output.Offset, Is.GreaterThanOrEqualTo (7), "#2");
+			ctx.Assert (output.Size, Is.EqualTo (hello.Length), "#3");
+
+			var decrypted = new byte [output.Size];
+			Buffer.BlockCopy (output.Buffer, output.Offset, decrypted, 0, output.Size);
+			ctx.Assert (decrypted, Is.EqualTo (hello), "#4");
+		}
+
+		[AsyncTest]
+		public void TestMultipleRecords (TestContext ctx, [TestHost] IEncryptionTestHost host)
+		{
+			var hello = GetField (HelloWorldName);
+
+			for (int i = 0; i < 4; i++) {
+				var encrypted = host.Encrypt (GetBuffer (HelloWorldName));
+				ctx.Assert (encrypted.Size, Is.EqualTo (hello.Length + host.MinExtraEncryptedBytes), "#1");
+
+				var decrypted = host.Decrypt (encrypted);
+				ctx.Assert (decrypted.Size, Is.EqualTo (hello.Length), "#2");
+
+				var buffer = new byte [decrypted.Size];
+				Buffer.BlockCopy (decrypted.Buffer, decrypted.Offset, buffer, 0, decrypted.Size);
+				ctx.Assert (buffer, Is.EqualTo (hello), "#3");
+			}
+		}
 	}
 }
 
@@ -0,0 +1,84 @@
+﻿//
+// TestHandshakeReplay.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using Xamarin.AsyncTests;
+using Xamarin.AsyncTests.Constraints;
+using Mono.Security.Interface;
+
+namespace Mono.Security.NewTls.Tests
+{
+	using TestFramework;
+	using TestFeatures;
+
+	[AsyncTestFixture]
+	public class TestHandshakeReplay : ITestHost<IHandshakeReplayTestHost>
+	{
+		public IHandshakeReplayTestHost CreateInstance (TestContext context)
+		{
+			var provider = DependencyInjector.Get<ICryptoProvider> ();
+			return provider.GetHandshakeReplayTestHost (CryptoProviderType.Mono);
+		}
+
+		const int Iterations = 200;
+
+		static readonly CipherSuiteCode[] ClientCiphers = {
+			CipherSuiteCode.TLS_RSA_WITH_AES_128_CBC_SHA,
+			CipherSuiteCode.TLS_RSA_WITH_AES_128_GCM_SHA256,
+			CipherSuiteCode.TLS_DHE_RSA_WITH_AES_128_GCM_SHA256,
+			CipherSuiteCode.TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256
+		};
+
+		// The server's Diffie-Hellman key pair does not come from the session's generator yet.
+		static readonly CipherSuiteCode[] ServerCiphers = {
+			CipherSuiteCode.TLS_RSA_WITH_AES_128_CBC_SHA,
+			CipherSuiteCode.TLS_RSA_WITH_AES_128_GCM_SHA256,
+			CipherSuiteCode.TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256
+		};
+
+		void Run (TestContext ctx, IHandshakeReplayTestHost host, CipherSuiteCode[] ciphers, bool server)
+		{
+			foreach (var cipher in ciphers) {
+				var result = host.Benchmark (cipher, server, Iterations);
+				ctx.LogMessage ("Handshake replay: {0}", result);
+				ctx.Assert (result.IncomingRecords, Is.GreaterThan (0), "incoming records");
+			}
+		}
+
+		[Benchmark]
+		[AsyncTest]
+		public void BenchmarkClientHandshake (TestContext ctx, [TestHost] IHandshakeReplayTestHost host)
+		{
+			Run (ctx, host, ClientCiphers, false);
+		}
+
+		[Benchmark]
+		[AsyncTest]
+		public void BenchmarkServerHandshake (TestContext ctx, [TestHost] IHandshakeReplayTestHost host)
+		{
+			Run (ctx, host, ServerCiphers, true);
+		}
+	}
+}
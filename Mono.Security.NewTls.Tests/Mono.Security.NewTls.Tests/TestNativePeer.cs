@@ -0,0 +1,168 @@
+﻿//
+// TestNativePeer.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.Net.Sockets;
+using Mono.Security.Interface;
+using Xamarin.AsyncTests;
+using Xamarin.AsyncTests.Constraints;
+
+namespace Mono.Security.NewTls.Tests
+{
+	using TestFramework;
+
+	[AsyncTestFixture]
+	public class TestNativePeer : ITestHost<INativePeerTestHost>
+	{
+		public INativePeerTestHost CreateInstance (TestContext context)
+		{
+			return DependencyInjector.Get<INativePeerTestHost> ();
+		}
+
+		[AsyncTest]
+		public void QuickAck (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			var baseline = host.RunHandshake (ctx, false);
+			var result = host.RunHandshake (ctx, true);
+			ctx.LogMessage ("Handshake without TCP_QUICKACK: {0}", baseline);
+			ctx.LogMessage ("Handshake with TCP_QUICKACK: {0}", result);
+
+			ctx.Assert (baseline.ClientQuickAckCount + baseline.ServerQuickAckCount, Is.EqualTo (0), "not requested");
+			if (!result.QuickAckApplied) {
+				ctx.Assert (result.ClientQuickAckCount + result.ServerQuickAckCount, Is.EqualTo (0), "not supported");
+				return;
+			}
+
+			// Each side reads at least twice during a full handshake.
+			ctx.Assert (result.ClientQuickAckCount, Is.GreaterThanOrEqualTo (2), "client re-armed");
+			ctx.Assert (result.ServerQuickAckCount, Is.GreaterThanOrEqualTo (2), "server re-armed");
+		}
+
+		[AsyncTest]
+		public void KernelTlsClient (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			if (!host.RunKernelTls (ctx, false, CipherSuiteCode.TLS_RSA_WITH_AES_128_GCM_SHA256))
+				ctx.LogMessage ("Kernel TLS is not available.");
+		}
+
+		[AsyncTest]
+		public void KernelTlsServer (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			if (!host.RunKernelTls (ctx, true, CipherSuiteCode.TLS_RSA_WITH_AES_256_GCM_SHA384))
+				ctx.LogMessage ("Kernel TLS is not available.");
+		}
+
+		const int SendFileSize = 1 << 20;
+
+		[AsyncTest]
+		public void SendFile (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			// Neither end is page aligned.
+			var sent = host.RunSendFile (ctx, SendFileSize, 1000, SendFileSize - 5000);
+			ctx.Assert (sent, Is.EqualTo ((long)SendFileSize - 5000), "sent");
+		}
+
+		[AsyncTest]
+		public void SendFileToEnd (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			var sent = host.RunSendFile (ctx, SendFileSize, 4096, SendFileSize - 4096);
+			ctx.Assert (sent, Is.EqualTo ((long)SendFileSize - 4096), "sent");
+		}
+
+		[AsyncTest]
+		public void SendFilePastEnd (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			ctx.Assert (host.RunSendFile (ctx, SendFileSize, SendFileSize - 1000, 2000), Is.EqualTo (-1L), "past the end");
+			ctx.Assert (host.RunSendFile (ctx, SendFileSize, SendFileSize + 4096, 1), Is.EqualTo (-1L), "offset past the end");
+		}
+
+		[AsyncTest]
+		public void SendFileNegativeRange (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			ctx.Assert (host.RunSendFile (ctx, SendFileSize, -1, 100), Is.EqualTo (-1L), "negative offset");
+			ctx.Assert (host.RunSendFile (ctx, SendFileSize, 0, -1), Is.EqualTo (-1L), "negative length");
+		}
+
+		[AsyncTest]
+		public void ConnectIPv6 (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			if (!Socket.OSSupportsIPv6) {
+				ctx.LogMessage ("IPv6 is not available.");
+				return;
+			}
+			host.RunConnect (ctx, "::1", "::1");
+		}
+
+		[AsyncTest]
+		public void ConnectHostName (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			// "localhost" may resolve to ::1 first, which the client must skip.
+			host.RunConnect (ctx, "127.0.0.1", "localhost");
+		}
+
+		[AsyncTest]
+		public void ReusePort (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			host.RunReusePort (ctx);
+		}
+
+		[AsyncTest]
+		public void ClientPool (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			host.RunClientPool (ctx);
+		}
+
+		[AsyncTest]
+		public void ConnectionPool (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			host.RunConnectionPool (ctx);
+		}
+
+		[AsyncTest]
+		public void SessionCache (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			host.RunSessionCache (ctx);
+		}
+
+		[AsyncTest]
+		public void AsyncIO (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			host.RunAsyncIO (ctx, 1);
+		}
+
+		[AsyncTest]
+		public void AsyncIOConcurrent (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			host.RunAsyncIO (ctx, 8);
+		}
+
+		[AsyncTest]
+		public void MemoryStats (TestContext ctx, [TestHost] INativePeerTestHost host)
+		{
+			if (!host.RunMemoryStats (ctx))
+				ctx.LogMessage ("Native memory hooks are not installed; the runner installs them with NEWTLS_OPENSSL_MEMORY_HOOKS=1.");
+		}
+	}
+}
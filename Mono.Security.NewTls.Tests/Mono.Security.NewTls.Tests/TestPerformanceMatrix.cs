@@ -0,0 +1,96 @@
+﻿//
+// TestPerformanceMatrix.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.Threading;
+using System.Threading.Tasks;
+using Mono.Security.Interface;
+using Xamarin.AsyncTests;
+using Xamarin.AsyncTests.Constraints;
+using Xamarin.WebTests.ConnectionFramework;
+using Xamarin.WebTests.MonoTestFeatures;
+
+namespace Mono.Security.NewTls.Tests
+{
+	using TestFramework;
+	using TestFeatures;
+
+	[Benchmark]
+	[AsyncTestFixture]
+	public class TestPerformanceMatrix
+	{
+		static async Task Run (TestContext ctx, CancellationToken cancellationToken, InstrumentationTestRunner runner)
+		{
+			var result = await runner.RunPerformance (ctx, cancellationToken);
+			ctx.Assert (result.TransferredBytes, Is.EqualTo ((long)PerformanceConnectionHandler.TransferSize), "transferred bytes");
+		}
+
+		[AsyncTest]
+		[ProtocolVersion (ProtocolVersions.Tls10)]
+		[InstrumentationCategory (InstrumentationCategory.CipherPerformance)]
+		public Task TestCipherTls10 (TestContext ctx, CancellationToken cancellationToken,
+			InstrumentationConnectionProvider provider,
+			[CipherSuite] CipherSuiteCode cipher,
+			CipherInstrumentParameters parameters,
+			CipherInstrumentTestRunner runner)
+		{
+			return Run (ctx, cancellationToken, runner);
+		}
+
+		[AsyncTest]
+		[ProtocolVersion (ProtocolVersions.Tls11)]
+		[InstrumentationCategory (InstrumentationCategory.CipherPerformance)]
+		public Task TestCipherTls11 (TestContext ctx, CancellationToken cancellationToken,
+			InstrumentationConnectionProvider provider,
+			[CipherSuite] CipherSuiteCode cipher,
+			CipherInstrumentParameters parameters,
+			CipherInstrumentTestRunner runner)
+		{
+			return Run (ctx, cancellationToken, runner);
+		}
+
+		[AsyncTest]
+		[ProtocolVersion (ProtocolVersions.Tls12)]
+		[InstrumentationCategory (InstrumentationCategory.CipherPerformance)]
+		public Task TestCipherTls12 (TestContext ctx, CancellationToken cancellationToken,
+			InstrumentationConnectionProvider provider,
+			[CipherSuite] CipherSuiteCode cipher,
+			CipherInstrumentParameters parameters,
+			CipherInstrumentTestRunner runner)
+		{
+			return Run (ctx, cancellationToken, runner);
+		}
+
+		[AsyncTest]
+		[InstrumentationCategory (InstrumentationCategory.ConnectionPerformance)]
+		public Task TestDefaultConnection (TestContext ctx, CancellationToken cancellationToken,
+			InstrumentationConnectionProvider provider,
+			GenericConnectionInstrumentParameters parameters,
+			GenericConnectionInstrumentTestRunner runner)
+		{
+			return Run (ctx, cancellationToken, runner);
+		}
+	}
+}
@@ -0,0 +1,110 @@
+﻿//
+// TestRecordLayer.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using Xamarin.AsyncTests;
+using Xamarin.AsyncTests.Constraints;
+using Mono.Security.Interface;
+
+namespace Mono.Security.NewTls.Tests
+{
+	using TestFramework;
+
+	[AsyncTestFixture]
+	public class TestRecordLayer : ITestHost<IRecordLayerTestHost>
+	{
+		public IRecordLayerTestHost CreateInstance (TestContext context)
+		{
+			var provider = DependencyInjector.Get<ICryptoProvider> ();
+			return provider.GetRecordLayerTestHost (CryptoProviderType.Mono);
+		}
+
+		[AsyncTest]
+		public void BufferReuse (TestContext ctx, [TestHost] IRecordLayerTestHost host)
+		{
+			host.RunBufferReuse (ctx);
+		}
+
+		[AsyncTest]
+		public void DynamicRecordSizing (TestContext ctx, [TestHost] IRecordLayerTestHost host)
+		{
+			host.RunDynamicRecordSizing (ctx);
+		}
+
+		[AsyncTest]
+		public void FragmentedHandshake (TestContext ctx, [TestHost] IRecordLayerTestHost host)
+		{
+			host.RunFragmentedHandshake (ctx);
+		}
+
+		[AsyncTest]
+		public void FragmentedCertificateRequest (TestContext ctx, [TestHost] IRecordLayerTestHost host)
+		{
+			host.RunFragmentedCertificateRequest (ctx);
+		}
+
+		[AsyncTest]
+		public void RenegotiationCertificateRequest (TestContext ctx, [TestHost] IRecordLayerTestHost host)
+		{
+			host.RunRenegotiationCertificateRequest (ctx);
+		}
+
+		[AsyncTest]
+		public void Statistics (TestContext ctx, [TestHost] IRecordLayerTestHost host)
+		{
+			host.RunStatistics (ctx);
+		}
+
+		[AsyncTest]
+		public void CertificateMessageCache (TestContext ctx, [TestHost] IRecordLayerTestHost host)
+		{
+			host.RunCertificateMessageCache (ctx);
+		}
+
+		[AsyncTest]
+		public void HandshakeHash (TestContext ctx, [TestHost] IRecordLayerTestHost host)
+		{
+			host.RunHandshakeHash (ctx);
+		}
+
+		[AsyncTest]
+		public void GcmSequenceNonce (TestContext ctx, [TestHost] IRecordLayerTestHost host)
+		{
+			host.RunGcmSequenceNonce (ctx);
+		}
+
+		[AsyncTest]
+		public void GcmRandomNonce (TestContext ctx, [TestHost] IRecordLayerTestHost host)
+		{
+			host.RunGcmRandomNonce (ctx);
+		}
+
+		[AsyncTest]
+		public void BufferedRandom (TestContext ctx, [TestHost] IRecordLayerTestHost host)
+		{
+			host.RunBufferedRandom (ctx);
+		}
+	}
+}
@@ -0,0 +1,70 @@
+﻿//
+// TestRenegotiationCost.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using Xamarin.AsyncTests;
+using Xamarin.AsyncTests.Constraints;
+
+namespace Mono.Security.NewTls.Tests
+{
+	using TestFramework;
+	using TestFeatures;
+
+	[AsyncTestFixture]
+	public class TestRenegotiationCost : ITestHost<IRenegotiationBenchmarkHost>
+	{
+		public IRenegotiationBenchmarkHost CreateInstance (TestContext context)
+		{
+			return DependencyInjector.Get<IRenegotiationBenchmarkHost> ();
+		}
+
+		static readonly TimeSpan Duration = TimeSpan.FromSeconds (10);
+		static readonly TimeSpan Interval = TimeSpan.FromSeconds (1);
+		static readonly TimeSpan SampleInterval = TimeSpan.FromMilliseconds (50);
+
+		void Run (TestContext ctx, IRenegotiationBenchmarkHost host, bool serverInitiated)
+		{
+			var result = host.Run (ctx, serverInitiated, Duration, Interval, SampleInterval);
+			ctx.LogMessage ("{0} renegotiation every {1} while streaming: {2}", serverInitiated ? "Server" : "Client", Interval, result);
+
+			ctx.Assert (result.Renegotiations, Is.GreaterThan (0), "renegotiations");
+			ctx.Assert (result.PeerRenegotiations, Is.EqualTo (result.Renegotiations), "peer renegotiations");
+		}
+
+		[Benchmark]
+		[AsyncTest]
+		public void BenchmarkServerRenegotiation (TestContext ctx, [TestHost] IRenegotiationBenchmarkHost host)
+		{
+			Run (ctx, host, true);
+		}
+
+		[Benchmark]
+		[AsyncTest]
+		public void BenchmarkClientRenegotiation (TestContext ctx, [TestHost] IRenegotiationBenchmarkHost host)
+		{
+			Run (ctx, host, false);
+		}
+	}
+}
@@ -123,6 +123,7 @@ namespace Mono.Security.NewTls.Tests
 		public IEnumerable<TestCategory> Categories {
 			get {
 				yield return RenegotiationAttribute.Instance;
+				yield return BenchmarkAttribute.Instance;
 			}
 		}
 
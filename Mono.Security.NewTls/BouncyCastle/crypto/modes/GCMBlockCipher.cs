@@ -110,7 +110,8 @@ namespace Org.BouncyCastle.Crypto.Modes
 			}
 
 			int bufLength = forEncryption ? BlockSize : (BlockSize + macSize);
-			this.bufBlock = new byte[bufLength];
+			if (bufBlock == null || bufBlock.Length != bufLength)
+				this.bufBlock = new byte[bufLength];
 
 			if (nonce == null || nonce.Length < 1)
 			{
@@ -123,16 +124,25 @@ namespace Org.BouncyCastle.Crypto.Modes
 				A = new byte[0];
 			}
 
-			// Cipher always used in forward mode
-			cipher.Init(true, keyParam);
+			// A null key re-uses the key schedule and the GHASH tables from the
+			// previous Init, so only the nonce and associated text are processed.
+			if (keyParam != null)
+			{
+				// Cipher always used in forward mode
+				cipher.Init(true, keyParam);
 
-			// TODO This should be configurable by Init parameters
-			// (but must be 16 if nonce length not 12) (BlockSize?)
-//			this.tagLength = 16;
+				// TODO This should be configurable by Init parameters
+				// (but must be 16 if nonce length not 12) (BlockSize?)
+//				this.tagLength = 16;
 
-			this.H = new byte[BlockSize];
-			cipher.ProcessBlock(H, 0, H, 0);
-			multiplier.Init(H);
+				this.H = new byte[BlockSize];
+				cipher.ProcessBlock(H, 0, H, 0);
+				multiplier.Init(H);
+			}
+			else if (this.H == null)
+			{
+				throw new ArgumentException("Key must be specified in initial init");
+			}
 
 			this.initS = gHASH(A);
 
@@ -84,16 +84,17 @@ namespace Org.BouncyCastle.Math.EC
 			return x.GetHashCode() ^ y.GetHashCode();
 		}
 
-//		/**
-//		 * Mainly for testing. Explicitly set the <code>ECMultiplier</code>.
-//		 * @param multiplier The <code>ECMultiplier</code> to be used to multiply
-//		 * this <code>ECPoint</code>.
-//		 */
-//		internal void SetECMultiplier(
-//			ECMultiplier multiplier)
-//		{
-//			this.multiplier = multiplier;
-//		}
+		/**
+		 * Explicitly set the <code>ECMultiplier</code>; used to install a
+		 * fixed-base multiplier on the generator of a named curve.
+		 * @param multiplier The <code>ECMultiplier</code> to be used to multiply
+		 * this <code>ECPoint</code>.
+		 */
+		internal void SetECMultiplier(
+			ECMultiplier multiplier)
+		{
+			this.multiplier = multiplier;
+		}
 
 		/**
 		 * Sets the <code>PreCompInfo</code>. Used by <code>ECMultiplier</code>s
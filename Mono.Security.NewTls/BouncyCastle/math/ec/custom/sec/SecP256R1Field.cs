@@ -0,0 +1,54 @@
+using System;
+
+using Org.BouncyCastle.Utilities.Encoders;
+
+namespace Org.BouncyCastle.Math.EC.Custom.Sec
+{
+	/**
+	* The field of the secp256r1 curve, p = 2^256 - 2^224 + 2^192 + 2^96 - 1, with the fast
+	* reduction from FIPS 186-4, D.2.3.
+	*/
+	internal sealed class SecP256R1Field
+		: SecPrimeField
+	{
+		internal static readonly SecP256R1Field Instance = new SecP256R1Field();
+
+		private SecP256R1Field()
+			: base(new BigInteger(1, Hex.Decode("FFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF")))
+		{
+		}
+
+		protected internal override void Reduce(uint[] xx, uint[] z)
+		{
+			long c08 = xx[8], c09 = xx[9], c10 = xx[10], c11 = xx[11], c12 = xx[12], c13 = xx[13], c14 = xx[14], c15 = xx[15];
+
+			long cc = 0;
+			cc += (long)xx[0] + c08 + c09 - c11 - c12 - c13 - c14;
+			z[0] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[1] + c09 + c10 - c12 - c13 - c14 - c15;
+			z[1] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[2] + c10 + c11 - c13 - c14 - c15;
+			z[2] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[3] + 2 * c11 + 2 * c12 + c13 - c08 - c09 - c15;
+			z[3] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[4] + 2 * c12 + 2 * c13 + c14 - c09 - c10;
+			z[4] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[5] + 2 * c13 + 2 * c14 + c15 - c10 - c11;
+			z[5] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[6] + c13 + 3 * c14 + 2 * c15 - c08 - c09;
+			z[6] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[7] + c08 + 3 * c15 - c10 - c11 - c12 - c13;
+			z[7] = (uint)cc;
+			cc >>= 32;
+
+			Normalize((int)cc, z);
+		}
+	}
+}
@@ -0,0 +1,66 @@
+using System;
+
+using Org.BouncyCastle.Utilities.Encoders;
+
+namespace Org.BouncyCastle.Math.EC.Custom.Sec
+{
+	/**
+	* The field of the secp384r1 curve, p = 2^384 - 2^128 - 2^96 + 2^32 - 1, with the fast
+	* reduction from FIPS 186-4, D.2.4.
+	*/
+	internal sealed class SecP384R1Field
+		: SecPrimeField
+	{
+		internal static readonly SecP384R1Field Instance = new SecP384R1Field();
+
+		private SecP384R1Field()
+			: base(new BigInteger(1, Hex.Decode("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFFFF0000000000000000FFFFFFFF")))
+		{
+		}
+
+		protected internal override void Reduce(uint[] xx, uint[] z)
+		{
+			long c12 = xx[12], c13 = xx[13], c14 = xx[14], c15 = xx[15], c16 = xx[16], c17 = xx[17], c18 = xx[18], c19 = xx[19], c20 = xx[20], c21 = xx[21], c22 = xx[22], c23 = xx[23];
+
+			long cc = 0;
+			cc += (long)xx[0] + c12 + c20 + c21 - c23;
+			z[0] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[1] + c13 + c22 + c23 - c12 - c20;
+			z[1] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[2] + c14 + c23 - c13 - c21;
+			z[2] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[3] + c12 + c15 + c20 + c21 - c14 - c22 - c23;
+			z[3] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[4] + c12 + c13 + c16 + c20 + 2 * c21 + c22 - c15 - 2 * c23;
+			z[4] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[5] + c13 + c14 + c17 + c21 + 2 * c22 + c23 - c16;
+			z[5] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[6] + c14 + c15 + c18 + c22 + 2 * c23 - c17;
+			z[6] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[7] + c15 + c16 + c19 + c23 - c18;
+			z[7] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[8] + c16 + c17 + c20 - c19;
+			z[8] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[9] + c17 + c18 + c21 - c20;
+			z[9] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[10] + c18 + c19 + c22 - c21;
+			z[10] = (uint)cc;
+			cc >>= 32;
+			cc += (long)xx[11] + c19 + c20 + c23 - c22;
+			z[11] = (uint)cc;
+			cc >>= 32;
+
+			Normalize((int)cc, z);
+		}
+	}
+}
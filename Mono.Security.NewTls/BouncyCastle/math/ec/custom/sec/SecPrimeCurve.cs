@@ -0,0 +1,84 @@
+using System;
+
+namespace Org.BouncyCastle.Math.EC.Custom.Sec
+{
+	/**
+	* Base class for the prime curves with a dedicated <code>SecPrimeField</code>.
+	* Field elements use fixed-width limbs and points are multiplied in
+	* Jacobian coordinates; the public API is the same as that of
+	* <code>FpCurve</code>.
+	*/
+	internal abstract class SecPrimeCurve
+		: FpCurve
+	{
+		protected SecPrimeCurve(BigInteger q, BigInteger a, BigInteger b)
+			: base(q, a, b)
+		{
+			if (!q.Equals(Field.Q))
+				throw new ArgumentException("curve does not match its field", "q");
+
+			// SecPrimeJacobianPoint.Twice() assumes a = -3.
+			if (!a.Equals(q.Subtract(BigInteger.Three)))
+				throw new ArgumentException("only curves with a = -3 are supported", "a");
+		}
+
+		/**
+		* Note: this is accessed from the <code>FpCurve</code> constructor, so
+		* implementations must not depend on instance state.
+		*/
+		internal abstract SecPrimeField Field { get; }
+
+		public override ECFieldElement FromBigInteger(BigInteger x)
+		{
+			return new SecPrimeFieldElement(Field, Field.FromBigInteger(x));
+		}
+
+		public override ECPoint CreatePoint(
+			BigInteger	X1,
+			BigInteger	Y1,
+			bool		withCompression)
+		{
+			return new SecPrimePoint(
+				this,
+				FromBigInteger(X1),
+				FromBigInteger(Y1),
+				withCompression);
+		}
+
+		protected internal override ECPoint DecompressPoint(
+			int			yTilde,
+			BigInteger	X1)
+		{
+			ECPoint p = base.DecompressPoint(yTilde, X1);
+			return new SecPrimePoint(this, p.X, p.Y, true);
+		}
+	}
+
+	internal class SecP256R1Curve
+		: SecPrimeCurve
+	{
+		public SecP256R1Curve(BigInteger q, BigInteger a, BigInteger b)
+			: base(q, a, b)
+		{
+		}
+
+		internal override SecPrimeField Field
+		{
+			get { return SecP256R1Field.Instance; }
+		}
+	}
+
+	internal class SecP384R1Curve
+		: SecPrimeCurve
+	{
+		public SecP384R1Curve(BigInteger q, BigInteger a, BigInteger b)
+			: base(q, a, b)
+		{
+		}
+
+		internal override SecPrimeField Field
+		{
+			get { return SecP384R1Field.Instance; }
+		}
+	}
+}
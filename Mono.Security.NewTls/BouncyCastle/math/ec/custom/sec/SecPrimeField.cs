@@ -0,0 +1,186 @@
+using System;
+
+using Org.BouncyCastle.Math.Raw;
+
+namespace Org.BouncyCastle.Math.EC.Custom.Sec
+{
+	/**
+	* Arithmetic modulo one of the SEC / NIST "generalized Mersenne" primes on
+	* fixed-width limb arrays.  Elements are always fully reduced; every
+	* operation writes into a caller supplied buffer, which may alias the
+	* operands.  Subclasses only provide the special-prime reduction.
+	*/
+	internal abstract class SecPrimeField
+	{
+		private readonly BigInteger q;
+		private readonly int size;
+		private readonly uint[] p;
+		private readonly uint[] invExponent;
+		private readonly uint[] sqrtExponent;
+
+		protected SecPrimeField(BigInteger q)
+		{
+			this.q = q;
+			this.size = (q.BitLength + 31) >> 5;
+			this.p = Nat.FromBigInteger(size, q);
+			this.invExponent = Nat.FromBigInteger(size, q.Subtract(BigInteger.Two));
+
+			// Only p = 3 (mod 4) is supported, which holds for all the curves using this.
+			if (!q.TestBit(0) || !q.TestBit(1))
+				throw new ArgumentException("field prime must be 3 mod 4", "q");
+			this.sqrtExponent = Nat.FromBigInteger(size, q.ShiftRight(2).Add(BigInteger.One));
+		}
+
+		public BigInteger Q
+		{
+			get { return q; }
+		}
+
+		/**
+		* The number of 32-bit limbs of an element.
+		*/
+		public int Size
+		{
+			get { return size; }
+		}
+
+		public uint[] Create()
+		{
+			return Nat.Create(size);
+		}
+
+		/**
+		* A buffer large enough for an unreduced product.
+		*/
+		public uint[] CreateExt()
+		{
+			return Nat.Create(size << 1);
+		}
+
+		public uint[] FromBigInteger(BigInteger x)
+		{
+			if (x.SignValue < 0 || x.CompareTo(q) >= 0)
+				throw new ArgumentException("x value too large in field element");
+
+			return Nat.FromBigInteger(size, x);
+		}
+
+		public BigInteger ToBigInteger(uint[] x)
+		{
+			return Nat.ToBigInteger(size, x);
+		}
+
+		public void Add(uint[] x, uint[] y, uint[] z)
+		{
+			uint c = Nat.Add(size, x, y, z);
+			if (c != 0 || Nat.Gte(size, z, p))
+			{
+				Nat.Sub(size, z, p, z);
+			}
+		}
+
+		public void Twice(uint[] x, uint[] z)
+		{
+			Add(x, x, z);
+		}
+
+		public void Subtract(uint[] x, uint[] y, uint[] z)
+		{
+			if (Nat.Sub(size, x, y, z) != 0)
+			{
+				Nat.Add(size, z, p, z);
+			}
+		}
+
+		public void Negate(uint[] x, uint[] z)
+		{
+			if (Nat.IsZero(size, x))
+			{
+				Nat.Copy(size, x, z);
+				return;
+			}
+			Nat.Sub(size, p, x, z);
+		}
+
+		public void Multiply(uint[] x, uint[] y, uint[] z, uint[] tt)
+		{
+			Nat.Mul(size, x, y, tt);
+			Reduce(tt, z);
+		}
+
+		public void Square(uint[] x, uint[] z, uint[] tt)
+		{
+			Nat.Square(size, x, tt);
+			Reduce(tt, z);
+		}
+
+		/**
+		* z = 1 / x, by Fermat's little theorem.  x must not be zero.
+		*/
+		public void Invert(uint[] x, uint[] z)
+		{
+			Pow(x, invExponent, z);
+		}
+
+		/**
+		* z = sqrt(x); returns false if x is not a quadratic residue.
+		*/
+		public bool Sqrt(uint[] x, uint[] z)
+		{
+			uint[] r = Create();
+			Pow(x, sqrtExponent, r);
+
+			uint[] check = Create();
+			Square(r, check, CreateExt());
+			if (!Nat.Eq(size, check, x))
+				return false;
+
+			Nat.Copy(size, r, z);
+			return true;
+		}
+
+		private void Pow(uint[] x, uint[] e, uint[] z)
+		{
+			uint[] b = Create();
+			Nat.Copy(size, x, b);
+			uint[] tt = CreateExt();
+
+			Nat.SetOne(size, z);
+			for (int bit = (size << 5) - 1; bit >= 0; bit--)
+			{
+				Square(z, z, tt);
+				if (Nat.TestBit(e, bit))
+				{
+					Multiply(z, b, z, tt);
+				}
+			}
+		}
+
+		/**
+		* Reduces the double-width value xx modulo p into z.  Implementations
+		* combine the limbs of xx with signed 64-bit accumulators and hand the
+		* remaining carry to <code>Normalize()</code>.
+		*/
+		protected internal abstract void Reduce(uint[] xx, uint[] z);
+
+		/**
+		* Folds a signed carry out of the top limb back into z and brings the
+		* result into the range [0, p).
+		*/
+		protected void Normalize(int carry, uint[] z)
+		{
+			while (carry > 0)
+			{
+				carry += Nat.Sub(size, z, p, z);
+			}
+			while (carry < 0)
+			{
+				carry += (int)Nat.Add(size, z, p, z);
+			}
+			if (Nat.Gte(size, z, p))
+			{
+				Nat.Sub(size, z, p, z);
+			}
+		}
+	}
+}
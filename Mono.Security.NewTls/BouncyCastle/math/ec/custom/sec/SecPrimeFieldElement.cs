@@ -0,0 +1,131 @@
+using System;
+
+using Org.BouncyCastle.Math.Raw;
+
+namespace Org.BouncyCastle.Math.EC.Custom.Sec
+{
+	/**
+	* Field element of a <code>SecPrimeField</code>, stored as a fixed-width
+	* limb array instead of a <code>BigInteger</code>.
+	*/
+	internal class SecPrimeFieldElement
+		: ECFieldElement
+	{
+		internal readonly SecPrimeField field;
+		internal readonly uint[] x;
+
+		internal SecPrimeFieldElement(SecPrimeField field, uint[] x)
+		{
+			this.field = field;
+			this.x = x;
+		}
+
+		public override BigInteger ToBigInteger()
+		{
+			return field.ToBigInteger(x);
+		}
+
+		public override string FieldName
+		{
+			get { return "Fp"; }
+		}
+
+		public override int FieldSize
+		{
+			get { return field.Q.BitLength; }
+		}
+
+		public BigInteger Q
+		{
+			get { return field.Q; }
+		}
+
+		private static uint[] GetLimbs(ECFieldElement b)
+		{
+			return ((SecPrimeFieldElement)b).x;
+		}
+
+		public override ECFieldElement Add(
+			ECFieldElement b)
+		{
+			uint[] z = field.Create();
+			field.Add(x, GetLimbs(b), z);
+			return new SecPrimeFieldElement(field, z);
+		}
+
+		public override ECFieldElement Subtract(
+			ECFieldElement b)
+		{
+			uint[] z = field.Create();
+			field.Subtract(x, GetLimbs(b), z);
+			return new SecPrimeFieldElement(field, z);
+		}
+
+		public override ECFieldElement Multiply(
+			ECFieldElement b)
+		{
+			uint[] z = field.Create();
+			field.Multiply(x, GetLimbs(b), z, field.CreateExt());
+			return new SecPrimeFieldElement(field, z);
+		}
+
+		public override ECFieldElement Divide(
+			ECFieldElement b)
+		{
+			uint[] z = field.Create();
+			field.Invert(GetLimbs(b), z);
+			field.Multiply(z, x, z, field.CreateExt());
+			return new SecPrimeFieldElement(field, z);
+		}
+
+		public override ECFieldElement Negate()
+		{
+			uint[] z = field.Create();
+			field.Negate(x, z);
+			return new SecPrimeFieldElement(field, z);
+		}
+
+		public override ECFieldElement Square()
+		{
+			uint[] z = field.Create();
+			field.Square(x, z, field.CreateExt());
+			return new SecPrimeFieldElement(field, z);
+		}
+
+		public override ECFieldElement Invert()
+		{
+			uint[] z = field.Create();
+			field.Invert(x, z);
+			return new SecPrimeFieldElement(field, z);
+		}
+
+		public override ECFieldElement Sqrt()
+		{
+			uint[] z = field.Create();
+			if (!field.Sqrt(x, z))
+				return null;
+			return new SecPrimeFieldElement(field, z);
+		}
+
+		public override bool Equals(
+			object obj)
+		{
+			SecPrimeFieldElement other = obj as SecPrimeFieldElement;
+
+			if (other == null)
+				return base.Equals(obj);
+
+			return field == other.field && Nat.Eq(field.Size, x, other.x);
+		}
+
+		public override int GetHashCode()
+		{
+			int hash = 0;
+			for (int i = 0; i < field.Size; i++)
+			{
+				hash = hash * 31 ^ (int)x[i];
+			}
+			return hash;
+		}
+	}
+}
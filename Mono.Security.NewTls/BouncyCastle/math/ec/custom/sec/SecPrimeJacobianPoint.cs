@@ -0,0 +1,266 @@
+using System;
+
+using Org.BouncyCastle.Math.Raw;
+
+namespace Org.BouncyCastle.Math.EC.Custom.Sec
+{
+	/**
+	* Mutable point in Jacobian coordinates (X / Z^2, Y / Z^3), used as the
+	* accumulator of the scalar multiplications on a <code>SecPrimeCurve</code>.
+	* All operations work in place on preallocated limb buffers, so a whole
+	* multiplication only allocates once; the single field inversion happens
+	* in <code>ToAffine()</code>.
+	*/
+	internal sealed class SecPrimeJacobianPoint
+	{
+		private readonly SecPrimeField field;
+		private readonly uint[] x, y, z;
+		private bool infinity;
+
+		private readonly uint[] t1, t2, t3, t4, t5, t6, tt;
+
+		internal SecPrimeJacobianPoint(SecPrimeField field)
+		{
+			this.field = field;
+			this.x = field.Create();
+			this.y = field.Create();
+			this.z = field.Create();
+			this.t1 = field.Create();
+			this.t2 = field.Create();
+			this.t3 = field.Create();
+			this.t4 = field.Create();
+			this.t5 = field.Create();
+			this.t6 = field.Create();
+			this.tt = field.CreateExt();
+			this.infinity = true;
+		}
+
+		internal bool IsInfinity
+		{
+			get { return infinity; }
+		}
+
+		internal void SetInfinity()
+		{
+			infinity = true;
+		}
+
+		internal void Set(ECPoint p)
+		{
+			if (p.IsInfinity)
+			{
+				infinity = true;
+				return;
+			}
+
+			Nat.Copy(field.Size, ((SecPrimeFieldElement)p.X).x, x);
+			Nat.Copy(field.Size, ((SecPrimeFieldElement)p.Y).x, y);
+			Nat.SetOne(field.Size, z);
+			infinity = false;
+		}
+
+		internal void Set(SecPrimeJacobianPoint p)
+		{
+			infinity = p.infinity;
+			Nat.Copy(field.Size, p.x, x);
+			Nat.Copy(field.Size, p.y, y);
+			Nat.Copy(field.Size, p.z, z);
+		}
+
+		/**
+		* this = 2 * this, using the a = -3 doubling formula.
+		*/
+		internal void Twice()
+		{
+			if (infinity)
+				return;
+
+			if (Nat.IsZero(field.Size, y))
+			{
+				infinity = true;
+				return;
+			}
+
+			uint[] delta = t1, gamma = t2, beta = t3, alpha = t4;
+
+			field.Square(z, delta, tt);
+			field.Square(y, gamma, tt);
+			field.Multiply(x, gamma, beta, tt);
+
+			// alpha = 3 * (X - delta) * (X + delta)
+			field.Subtract(x, delta, alpha);
+			field.Add(x, delta, t5);
+			field.Multiply(alpha, t5, alpha, tt);
+			field.Twice(alpha, t5);
+			field.Add(alpha, t5, alpha);
+
+			// Z3 = (Y + Z)^2 - gamma - delta
+			field.Add(y, z, t5);
+			field.Square(t5, t5, tt);
+			field.Subtract(t5, gamma, t5);
+			field.Subtract(t5, delta, z);
+
+			// X3 = alpha^2 - 8 * beta
+			field.Twice(beta, beta);
+			field.Twice(beta, beta);
+			field.Square(alpha, x, tt);
+			field.Subtract(x, beta, x);
+			field.Subtract(x, beta, x);
+
+			// Y3 = alpha * (4 * beta - X3) - 8 * gamma^2
+			field.Subtract(beta, x, beta);
+			field.Multiply(alpha, beta, beta, tt);
+			field.Square(gamma, gamma, tt);
+			field.Twice(gamma, gamma);
+			field.Twice(gamma, gamma);
+			field.Twice(gamma, gamma);
+			field.Subtract(beta, gamma, y);
+		}
+
+		/**
+		* this = this + p, where p is an affine point which is not infinity.
+		*/
+		internal void AddAffine(ECPoint p)
+		{
+			uint[] x2 = ((SecPrimeFieldElement)p.X).x;
+			uint[] y2 = ((SecPrimeFieldElement)p.Y).x;
+
+			if (infinity)
+			{
+				Set(p);
+				return;
+			}
+
+			uint[] z1z1 = t1, u2 = t2, s2 = t3, hh = t4, hhh = t5;
+
+			field.Square(z, z1z1, tt);
+			field.Multiply(x2, z1z1, u2, tt);
+			field.Multiply(z, z1z1, s2, tt);
+			field.Multiply(y2, s2, s2, tt);
+
+			uint[] h = u2, r = s2;
+			field.Subtract(u2, x, h);
+			field.Subtract(s2, y, r);
+
+			if (Nat.IsZero(field.Size, h))
+			{
+				if (Nat.IsZero(field.Size, r))
+					Twice();
+				else
+					infinity = true;
+				return;
+			}
+
+			field.Square(h, hh, tt);
+			field.Multiply(h, hh, hhh, tt);
+
+			uint[] v = hh;
+			field.Multiply(x, hh, v, tt);
+
+			// X3 = r^2 - HHH - 2 * V
+			field.Square(r, x, tt);
+			field.Subtract(x, hhh, x);
+			field.Subtract(x, v, x);
+			field.Subtract(x, v, x);
+
+			// Y3 = r * (V - X3) - Y1 * HHH
+			field.Subtract(v, x, v);
+			field.Multiply(r, v, v, tt);
+			field.Multiply(y, hhh, hhh, tt);
+			field.Subtract(v, hhh, y);
+
+			// Z3 = Z1 * H
+			field.Multiply(z, h, z, tt);
+		}
+
+		/**
+		* this = this + p, or this - p if <code>negate</code> is set.
+		*/
+		internal void Add(SecPrimeJacobianPoint p, bool negate)
+		{
+			if (p.infinity)
+				return;
+
+			if (infinity)
+			{
+				Set(p);
+				if (negate)
+					field.Negate(y, y);
+				return;
+			}
+
+			uint[] z1z1 = t1, z2z2 = t2, u1 = t3, u2 = t4, s1 = t5, s2 = t6;
+
+			field.Square(z, z1z1, tt);
+			field.Square(p.z, z2z2, tt);
+			field.Multiply(x, z2z2, u1, tt);
+			field.Multiply(p.x, z1z1, u2, tt);
+
+			field.Multiply(p.z, z2z2, s1, tt);
+			field.Multiply(y, s1, s1, tt);
+			field.Multiply(z, z1z1, s2, tt);
+			field.Multiply(p.y, s2, s2, tt);
+			if (negate)
+				field.Negate(s2, s2);
+
+			uint[] h = u2, r = s2;
+			field.Subtract(u2, u1, h);
+			field.Subtract(s2, s1, r);
+
+			if (Nat.IsZero(field.Size, h))
+			{
+				if (Nat.IsZero(field.Size, r))
+					Twice();
+				else
+					infinity = true;
+				return;
+			}
+
+			uint[] hh = t1, hhh = t2, v = u1;
+			field.Square(h, hh, tt);
+			field.Multiply(h, hh, hhh, tt);
+			field.Multiply(u1, hh, v, tt);
+
+			// Z3 = Z1 * Z2 * H
+			field.Multiply(z, p.z, z, tt);
+			field.Multiply(z, h, z, tt);
+
+			// X3 = r^2 - HHH - 2 * V
+			field.Square(r, x, tt);
+			field.Subtract(x, hhh, x);
+			field.Subtract(x, v, x);
+			field.Subtract(x, v, x);
+
+			// Y3 = r * (V - X3) - S1 * HHH
+			field.Subtract(v, x, v);
+			field.Multiply(r, v, v, tt);
+			field.Multiply(s1, hhh, s1, tt);
+			field.Subtract(v, s1, y);
+		}
+
+		internal ECPoint ToAffine(SecPrimeCurve curve)
+		{
+			if (infinity)
+				return curve.Infinity;
+
+			uint[] zInv = field.Create();
+			field.Invert(z, zInv);
+
+			uint[] zInv2 = field.Create();
+			field.Square(zInv, zInv2, tt);
+
+			uint[] ax = field.Create();
+			field.Multiply(x, zInv2, ax, tt);
+
+			uint[] ay = field.Create();
+			field.Multiply(zInv2, zInv, zInv2, tt);
+			field.Multiply(y, zInv2, ay, tt);
+
+			return new SecPrimePoint(
+				curve,
+				new SecPrimeFieldElement(field, ax),
+				new SecPrimeFieldElement(field, ay),
+				false);
+		}
+	}
+}
@@ -0,0 +1,60 @@
+using System;
+
+namespace Org.BouncyCastle.Math.EC.Custom.Sec
+{
+	/**
+	* Affine point on a <code>SecPrimeCurve</code>.  Single additions use the
+	* affine formulas of <code>FpPoint</code>, but scalar multiplication is
+	* done in Jacobian coordinates by <code>SecPrimeWNafMultiplier</code>.
+	*/
+	internal class SecPrimePoint
+		: FpPoint
+	{
+		internal SecPrimePoint(
+			ECCurve			curve,
+			ECFieldElement	x,
+			ECFieldElement	y,
+			bool			withCompression)
+			: base(curve, x, y, withCompression)
+		{
+		}
+
+		private ECPoint Wrap(ECPoint p)
+		{
+			if (p.IsInfinity || p is SecPrimePoint)
+				return p;
+
+			return new SecPrimePoint(curve, p.X, p.Y, withCompression);
+		}
+
+		public override ECPoint Add(
+			ECPoint b)
+		{
+			return Wrap(base.Add(b));
+		}
+
+		public override ECPoint Twice()
+		{
+			return Wrap(base.Twice());
+		}
+
+		public override ECPoint Negate()
+		{
+			return new SecPrimePoint(curve, x, y.Negate(), withCompression);
+		}
+
+		internal override void AssertECMultiplier()
+		{
+			if (this.multiplier == null)
+			{
+				lock (this)
+				{
+					if (this.multiplier == null)
+					{
+						this.multiplier = new SecPrimeWNafMultiplier();
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,60 @@
+using System;
+
+using Org.BouncyCastle.Math.EC.Multiplier;
+
+namespace Org.BouncyCastle.Math.EC.Custom.Sec
+{
+	/**
+	* Window NAF multiplication of an arbitrary point on a
+	* <code>SecPrimeCurve</code>, with the table of odd multiples and the
+	* accumulator kept in Jacobian coordinates.  Used for the peer's public
+	* key in ECDH, which is different every time, so nothing is cached.
+	*/
+	internal class SecPrimeWNafMultiplier
+		: ECMultiplier
+	{
+		private const sbyte Width = 5;
+
+		public ECPoint Multiply(ECPoint p, BigInteger k, PreCompInfo preCompInfo)
+		{
+			SecPrimeCurve curve = (SecPrimeCurve)p.Curve;
+			SecPrimeField field = curve.Field;
+
+			sbyte[] wnaf = new WNafMultiplier().WindowNaf(Width, k);
+
+			// table[i] = (2 * i + 1) * p
+			SecPrimeJacobianPoint[] table = new SecPrimeJacobianPoint[1 << (Width - 2)];
+			table[0] = new SecPrimeJacobianPoint(field);
+			table[0].Set(p);
+
+			SecPrimeJacobianPoint twiceP = new SecPrimeJacobianPoint(field);
+			twiceP.Set(p);
+			twiceP.Twice();
+
+			for (int i = 1; i < table.Length; i++)
+			{
+				table[i] = new SecPrimeJacobianPoint(field);
+				table[i].Set(table[i - 1]);
+				table[i].Add(twiceP, false);
+			}
+
+			SecPrimeJacobianPoint q = new SecPrimeJacobianPoint(field);
+			for (int i = wnaf.Length - 1; i >= 0; i--)
+			{
+				q.Twice();
+
+				int digit = wnaf[i];
+				if (digit > 0)
+				{
+					q.Add(table[digit >> 1], false);
+				}
+				else if (digit < 0)
+				{
+					q.Add(table[(-digit) >> 1], true);
+				}
+			}
+
+			return q.ToAffine(curve);
+		}
+	}
+}
@@ -0,0 +1,130 @@
+using System;
+
+using Org.BouncyCastle.Math.EC.Custom.Sec;
+
+namespace Org.BouncyCastle.Math.EC.Multiplier
+{
+	/**
+	* Class implementing the fixed-base comb multiplication algorithm
+	* (Lim-Lee).  It is only worthwhile for points which are multiplied
+	* many times, such as the generator of a named curve; the table is
+	* computed once by <code>Precompute()</code> and then shared by all
+	* subsequent multiplications.
+	*/
+	internal class FixedPointCombMultiplier
+		: ECMultiplier
+	{
+		/**
+		* Computes the comb table for <code>p</code>, attaches it to the
+		* point and makes this multiplier the one used by <code>p</code>.
+		* @param p The fixed base point.
+		* @param order The order of <code>p</code>.
+		*/
+		public static void Precompute(ECPoint p, BigInteger order)
+		{
+			int bits = order.BitLength;
+			int width = bits > 257 ? 6 : 5;
+			int spacing = (bits + width - 1) / width;
+
+			ECPoint[] pow2Table = new ECPoint[width];
+			pow2Table[0] = p;
+			for (int i = 1; i < width; i++)
+			{
+				ECPoint q = pow2Table[i - 1];
+				for (int j = 0; j < spacing; j++)
+				{
+					q = q.Twice();
+				}
+				pow2Table[i] = q;
+			}
+
+			ECPoint[] preComp = new ECPoint[1 << width];
+			preComp[0] = p.Curve.Infinity;
+			for (int bit = 0; bit < width; bit++)
+			{
+				int pow = 1 << bit;
+				for (int j = 0; j < pow; j++)
+				{
+					preComp[pow + j] = preComp[j].Add(pow2Table[bit]);
+				}
+			}
+
+			lock (p)
+			{
+				p.SetPreCompInfo(new FixedPointPreCompInfo(preComp, order, width, spacing));
+				p.SetECMultiplier(new FixedPointCombMultiplier());
+			}
+		}
+
+		public ECPoint Multiply(ECPoint p, BigInteger k, PreCompInfo preCompInfo)
+		{
+			FixedPointPreCompInfo info = preCompInfo as FixedPointPreCompInfo;
+			if (info == null)
+			{
+				// Not precomputed; this multiplier only makes sense for a fixed base.
+				return new ReferenceMultiplier().Multiply(p, k, null);
+			}
+
+			int width = info.Width;
+			int spacing = info.Spacing;
+
+			if (k.BitLength > width * spacing)
+			{
+				k = k.Mod(info.Order);
+			}
+
+			ECPoint[] preComp = info.GetPreComp();
+
+			SecPrimeCurve secCurve = p.Curve as SecPrimeCurve;
+			if (secCurve != null)
+			{
+				return MultiplyJacobian(secCurve, preComp, k, width, spacing);
+			}
+
+			ECPoint q = p.Curve.Infinity;
+
+			for (int i = spacing - 1; i >= 0; i--)
+			{
+				int index = 0;
+				for (int j = width - 1; j >= 0; j--)
+				{
+					index <<= 1;
+					if (k.TestBit(j * spacing + i))
+					{
+						index |= 1;
+					}
+				}
+
+				q = q.Twice().Add(preComp[index]);
+			}
+
+			return q;
+		}
+
+		private static ECPoint MultiplyJacobian(SecPrimeCurve curve, ECPoint[] preComp, BigInteger k, int width, int spacing)
+		{
+			SecPrimeJacobianPoint q = new SecPrimeJacobianPoint(curve.Field);
+
+			for (int i = spacing - 1; i >= 0; i--)
+			{
+				int index = 0;
+				for (int j = width - 1; j >= 0; j--)
+				{
+					index <<= 1;
+					if (k.TestBit(j * spacing + i))
+					{
+						index |= 1;
+					}
+				}
+
+				q.Twice();
+				if (index != 0)
+				{
+					q.AddAffine(preComp[index]);
+				}
+			}
+
+			return q.ToAffine(curve);
+		}
+	}
+}
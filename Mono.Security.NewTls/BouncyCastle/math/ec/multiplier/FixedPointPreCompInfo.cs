@@ -0,0 +1,60 @@
+namespace Org.BouncyCastle.Math.EC.Multiplier
+{
+	/**
+	* Class holding precomputation data for the fixed-base comb
+	* multiplication in <code>FixedPointCombMultiplier</code>.
+	*/
+	internal class FixedPointPreCompInfo
+		: PreCompInfo
+	{
+		/**
+		* Array holding the precomputed comb entries; entry <code>i</code> is
+		* the sum of <code>2<sup>j * d</sup> * P</code> for every bit
+		* <code>j</code> which is set in <code>i</code>.
+		*/
+		private readonly ECPoint[] preComp;
+
+		/**
+		* The order of the base point.
+		*/
+		private readonly BigInteger order;
+
+		/**
+		* The number of teeth of the comb.
+		*/
+		private readonly int width;
+
+		/**
+		* The spacing between two teeth of the comb.
+		*/
+		private readonly int spacing;
+
+		internal FixedPointPreCompInfo(ECPoint[] preComp, BigInteger order, int width, int spacing)
+		{
+			this.preComp = preComp;
+			this.order = order;
+			this.width = width;
+			this.spacing = spacing;
+		}
+
+		internal ECPoint[] GetPreComp()
+		{
+			return preComp;
+		}
+
+		internal BigInteger Order
+		{
+			get { return order; }
+		}
+
+		internal int Width
+		{
+			get { return width; }
+		}
+
+		internal int Spacing
+		{
+			get { return spacing; }
+		}
+	}
+}
@@ -0,0 +1,200 @@
+using System;
+
+namespace Org.BouncyCastle.Math.Raw
+{
+	/**
+	* Fixed-width unsigned arithmetic on little-endian arrays of 32-bit limbs.
+	* None of these methods allocate, so the callers can keep their operands
+	* and temporaries in preallocated buffers.
+	*/
+	internal static class Nat
+	{
+		public static uint[] Create(int len)
+		{
+			return new uint[len];
+		}
+
+		public static uint[] FromBigInteger(int len, BigInteger x)
+		{
+			if (x.SignValue < 0 || x.BitLength > len * 32)
+				throw new ArgumentException("value out of range", "x");
+
+			uint[] z = new uint[len];
+			byte[] bytes = x.ToByteArrayUnsigned();
+			for (int i = 0; i < bytes.Length; i++)
+			{
+				int pos = bytes.Length - 1 - i;
+				z[i >> 2] |= (uint)bytes[pos] << ((i & 3) << 3);
+			}
+			return z;
+		}
+
+		public static BigInteger ToBigInteger(int len, uint[] x)
+		{
+			byte[] bytes = new byte[len << 2];
+			for (int i = 0; i < len; i++)
+			{
+				uint xi = x[i];
+				int pos = (len - 1 - i) << 2;
+				bytes[pos] = (byte)(xi >> 24);
+				bytes[pos + 1] = (byte)(xi >> 16);
+				bytes[pos + 2] = (byte)(xi >> 8);
+				bytes[pos + 3] = (byte)xi;
+			}
+			return new BigInteger(1, bytes);
+		}
+
+		public static void Copy(int len, uint[] x, uint[] z)
+		{
+			Array.Copy(x, 0, z, 0, len);
+		}
+
+		public static void SetOne(int len, uint[] z)
+		{
+			z[0] = 1;
+			for (int i = 1; i < len; i++)
+			{
+				z[i] = 0;
+			}
+		}
+
+		public static bool IsZero(int len, uint[] x)
+		{
+			for (int i = 0; i < len; i++)
+			{
+				if (x[i] != 0)
+					return false;
+			}
+			return true;
+		}
+
+		public static bool Eq(int len, uint[] x, uint[] y)
+		{
+			for (int i = 0; i < len; i++)
+			{
+				if (x[i] != y[i])
+					return false;
+			}
+			return true;
+		}
+
+		public static bool Gte(int len, uint[] x, uint[] y)
+		{
+			for (int i = len - 1; i >= 0; i--)
+			{
+				if (x[i] != y[i])
+					return x[i] > y[i];
+			}
+			return true;
+		}
+
+		public static bool TestBit(uint[] x, int bit)
+		{
+			return ((x[bit >> 5] >> (bit & 31)) & 1) != 0;
+		}
+
+		/**
+		* z = x + y; returns the carry (0 or 1).  z may alias x or y.
+		*/
+		public static uint Add(int len, uint[] x, uint[] y, uint[] z)
+		{
+			ulong c = 0;
+			for (int i = 0; i < len; i++)
+			{
+				c += (ulong)x[i] + y[i];
+				z[i] = (uint)c;
+				c >>= 32;
+			}
+			return (uint)c;
+		}
+
+		/**
+		* z = x - y; returns the borrow (0 or -1).  z may alias x or y.
+		*/
+		public static int Sub(int len, uint[] x, uint[] y, uint[] z)
+		{
+			long c = 0;
+			for (int i = 0; i < len; i++)
+			{
+				c += (long)x[i] - y[i];
+				z[i] = (uint)c;
+				c >>= 32;
+			}
+			return (int)c;
+		}
+
+		/**
+		* zz = x * y, where zz has 2 * len limbs and must not alias x or y.
+		*/
+		public static void Mul(int len, uint[] x, uint[] y, uint[] zz)
+		{
+			ulong c = 0;
+			ulong x0 = x[0];
+			for (int j = 0; j < len; j++)
+			{
+				c += x0 * y[j];
+				zz[j] = (uint)c;
+				c >>= 32;
+			}
+			zz[len] = (uint)c;
+
+			for (int i = 1; i < len; i++)
+			{
+				ulong xi = x[i];
+				c = 0;
+				for (int j = 0; j < len; j++)
+				{
+					c += xi * y[j] + zz[i + j];
+					zz[i + j] = (uint)c;
+					c >>= 32;
+				}
+				zz[i + len] = (uint)c;
+			}
+		}
+
+		/**
+		* zz = x * x, where zz has 2 * len limbs and must not alias x.
+		*/
+		public static void Square(int len, uint[] x, uint[] zz)
+		{
+			// Off-diagonal products first, each of them only once ...
+			for (int i = 0; i < len << 1; i++)
+			{
+				zz[i] = 0;
+			}
+
+			for (int i = 0; i < len - 1; i++)
+			{
+				ulong xi = x[i];
+				ulong c = 0;
+				for (int j = i + 1; j < len; j++)
+				{
+					c += xi * x[j] + zz[i + j];
+					zz[i + j] = (uint)c;
+					c >>= 32;
+				}
+				zz[i + len] = (uint)c;
+			}
+
+			// ... then double them and add the squares on the diagonal.
+			ulong d = 0;
+			uint prev = 0;
+			for (int i = 0; i < len; i++)
+			{
+				ulong sq = (ulong)x[i] * x[i];
+
+				uint lo = zz[2 * i], hi = zz[2 * i + 1];
+				uint lo2 = (lo << 1) | (prev >> 31);
+				uint hi2 = (hi << 1) | (lo >> 31);
+				prev = hi;
+
+				d += (ulong)lo2 + (uint)sq;
+				zz[2 * i] = (uint)d;
+				d >>= 32;
+				d += (ulong)hi2 + (sq >> 32);
+				zz[2 * i + 1] = (uint)d;
+				d >>= 32;
+			}
+		}
+	}
+}
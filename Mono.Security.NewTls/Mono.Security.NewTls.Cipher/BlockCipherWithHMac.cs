@@ -68,6 +68,10 @@ namespace Mono.Security.NewTls.Cipher
 			return plen + padLen;
 		}
 
+		public override int EncryptedHeaderSize {
+			get { return HeaderSize; }
+		}
+
 		public override int MinExtraEncryptedBytes {
 			get { return HeaderSize + MacSize + 1; }
 		}
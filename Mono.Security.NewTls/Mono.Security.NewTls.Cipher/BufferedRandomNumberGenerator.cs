@@ -0,0 +1,102 @@
+﻿//
+// BufferedRandomNumberGenerator.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.Security.Cryptography;
+
+namespace Mono.Security.NewTls.Cipher
+{
+	/*
+	 * Hands out random bytes from a block which is refilled from the system
+	 * generator, so the small per-record requests (CBC IVs, GCM nonces) don't
+	 * each pay for a call into the system RNG.
+	 */
+	public class BufferedRandomNumberGenerator : RandomNumberGenerator
+	{
+		public const int DefaultBufferSize = 1024;
+
+		RandomNumberGenerator generator;
+		byte[] buffer;
+		int position;
+		int refills;
+
+		public BufferedRandomNumberGenerator (RandomNumberGenerator generator, int bufferSize = DefaultBufferSize)
+		{
+			this.generator = generator;
+			buffer = new byte [bufferSize];
+			position = bufferSize;
+		}
+
+		public int Refills {
+			get { return refills; }
+		}
+
+		public void GetBytes (byte[] data, int offset, int count)
+		{
+			if (count > buffer.Length) {
+				var temp = new byte [count];
+				generator.GetBytes (temp);
+				Buffer.BlockCopy (temp, 0, data, offset, count);
+				return;
+			}
+
+			if (count > buffer.Length - position) {
+				generator.GetBytes (buffer);
+				position = 0;
+				refills++;
+			}
+
+			Buffer.BlockCopy (buffer, position, data, offset, count);
+			// Don't keep bytes which have already been handed out.
+			Array.Clear (buffer, position, count);
+			position += count;
+		}
+
+		public override void GetBytes (byte[] data)
+		{
+			GetBytes (data, 0, data.Length);
+		}
+
+		public override void GetNonZeroBytes (byte[] data)
+		{
+			generator.GetNonZeroBytes (data);
+		}
+
+		protected override void Dispose (bool disposing)
+		{
+			if (disposing) {
+				if (buffer != null) {
+					Array.Clear (buffer, 0, buffer.Length);
+					buffer = null;
+				}
+				if (generator != null) {
+					generator.Dispose ();
+					generator = null;
+				}
+			}
+			base.Dispose (disposing);
+		}
+	}
+}
@@ -40,6 +40,8 @@ namespace Mono.Security.NewTls.Cipher
 		SymmetricAlgorithm decryptionAlgorithm;
 		ICryptoTransform encryptionCipher;
 		ICryptoTransform decryptionCipher;
+		BufferedRandomNumberGenerator random;
+		byte[] encryptionChain;
 
 		public SymmetricAlgorithm EncryptionAlgorithm {
 			get { return encryptionAlgorithm; }
@@ -98,6 +100,24 @@ namespace Mono.Security.NewTls.Cipher
 
 				encryptionCipher = Add (EncryptionAlgorithm.CreateEncryptor ());
 				decryptionCipher = Add (DecryptionAlgorithm.CreateDecryptor ());
+			} else {
+				/*
+				 * The explicit IV is folded into the first plaintext block (see EncryptRecord),
+				 * so the encryptor is created once with a zero IV and keeps chaining across records.
+				 */
+				EncryptionAlgorithm.IV = new byte [BlockSize];
+				encryptionCipher = Add (EncryptionAlgorithm.CreateEncryptor ());
+				encryptionChain = new byte [BlockSize];
+
+#if !BOOTSTRAP_BASIC
+				random = Add (new BufferedRandomNumberGenerator (RandomNumberGenerator.Create ()));
+#endif
+
+				/*
+				 * In-place decryption runs the explicit IV through the cipher as the first
+				 * ciphertext block, so a single decryptor can be used for all records.
+				 */
+				decryptionCipher = Add (DecryptionAlgorithm.CreateDecryptor ());
 			}
 
 			base.InitializeCipher ();
@@ -107,24 +127,33 @@ namespace Mono.Security.NewTls.Cipher
 			get { return Cipher.HasFixedIV ? 0 : BlockSize; }
 		}
 
+		protected virtual void CreateExplicitIV (byte[] buffer, int offset)
+		{
+			random.GetBytes (buffer, offset, BlockSize);
+		}
+
 		protected override void EncryptRecord (DisposeContext d, IBufferOffsetSize input)
 		{
-			ICryptoTransform cipher;
 			if (!Cipher.HasFixedIV) {
-				EncryptionAlgorithm.GenerateIV ();
-				cipher = d.Add (EncryptionAlgorithm.CreateEncryptor ());
-			} else {
-				cipher = encryptionCipher;
+				CreateExplicitIV (input.Buffer, input.Offset);
+
+				/*
+				 * The encryptor chains from the last ciphertext block of the previous record;
+				 * XOR-ing that chain value out of the first plaintext block and the explicit IV
+				 * in gives exactly the same ciphertext as a fresh encryptor keyed with that IV.
+				 */
+				var first = input.Offset + HeaderSize;
+				for (int i = 0; i < BlockSize; i++)
+					input.Buffer [first + i] ^= (byte)(input.Buffer [input.Offset + i] ^ encryptionChain [i]);
 			}
 
-			if (!Cipher.HasFixedIV)
-				Buffer.BlockCopy (EncryptionAlgorithm.IV, 0, input.Buffer, input.Offset, BlockSize);
-
-			var ret = cipher.TransformBlock (input.Buffer, input.Offset + HeaderSize, input.Size - HeaderSize, input.Buffer, input.Offset + HeaderSize);
+			var ret = encryptionCipher.TransformBlock (input.Buffer, input.Offset + HeaderSize, input.Size - HeaderSize, input.Buffer, input.Offset + HeaderSize);
 			if (ret <= 0 || ret != input.Size - HeaderSize)
 				throw new InvalidOperationException ();
 
-			if (Cipher.HasFixedIV) {
+			if (!Cipher.HasFixedIV) {
+				Buffer.BlockCopy (input.Buffer, input.Offset + input.Size - BlockSize, encryptionChain, 0, BlockSize);
+			} else {
 				var IV = new byte [BlockSize];
 				Buffer.BlockCopy (input.Buffer, input.Offset + input.Size - BlockSize, IV, 0, BlockSize);
 				EncryptionAlgorithm.IV = IV;
@@ -136,6 +165,9 @@ namespace Mono.Security.NewTls.Cipher
 			if ((input.Size % BlockSize) != 0)
 				return -1;
 
+			if (output.Buffer == input.Buffer && output.Offset == input.Offset + HeaderSize)
+				return DecryptRecordInPlace (input);
+
 			int ivSize;
 			ICryptoTransform cipher;
 			if (!Cipher.HasFixedIV) {
@@ -162,6 +194,23 @@ namespace Mono.Security.NewTls.Cipher
 
 			return ret;
 		}
+
+		int DecryptRecordInPlace (IBufferOffsetSize input)
+		{
+			/*
+			 * CBC decryption of a block only depends on the previous ciphertext block, so
+			 * decrypting the explicit IV along with the record yields the plaintext for
+			 * all the following blocks; the first output block is garbage and discarded.
+			 *
+			 * The decryptor keeps the chaining state itself, so the TLS 1.0 fixed IV
+			 * doesn't need to be saved before the ciphertext is overwritten.
+			 */
+			var ret = decryptionCipher.TransformBlock (input.Buffer, input.Offset, input.Size, input.Buffer, input.Offset);
+			if (ret <= 0 || ret != input.Size)
+				return -1;
+
+			return ret - HeaderSize;
+		}
 	}
 }
 
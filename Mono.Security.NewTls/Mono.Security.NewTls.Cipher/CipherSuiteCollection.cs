@@ -15,6 +15,13 @@ namespace Mono.Security.NewTls.Cipher
 
 		List<CipherSuiteCode> innerList;
 
+		/*
+		 * Maps each code to its first position in innerList; built on the first lookup
+		 * and dropped whenever positions change, so Contains() and IndexOf() during cipher
+		 * selection neither scan the list nor box the enum.
+		 */
+		Dictionary<int,int> index;
+
 		public CipherSuiteCollection (TlsProtocolCode protocol, ICollection<CipherSuiteCode> codes)
 		{
 			Protocol = protocol;
@@ -33,8 +40,29 @@ namespace Mono.Security.NewTls.Cipher
 
 		internal void AddSCSV ()
 		{
-			if (!innerList.Contains (CipherSuiteCode.TLS_EMPTY_RENEGOTIATION_INFO_SCSV))
-				innerList.Add (CipherSuiteCode.TLS_EMPTY_RENEGOTIATION_INFO_SCSV);
+			if (!Contains (CipherSuiteCode.TLS_EMPTY_RENEGOTIATION_INFO_SCSV))
+				Append (CipherSuiteCode.TLS_EMPTY_RENEGOTIATION_INFO_SCSV);
+		}
+
+		void Append (CipherSuiteCode code)
+		{
+			if (index != null && !index.ContainsKey ((int)code))
+				index.Add ((int)code, innerList.Count);
+			innerList.Add (code);
+		}
+
+		int Find (CipherSuiteCode code)
+		{
+			if (index == null) {
+				index = new Dictionary<int,int> (innerList.Count);
+				for (int i = innerList.Count - 1; i >= 0; i--)
+					index [(int)innerList [i]] = i;
+			}
+
+			int position;
+			if (index.TryGetValue ((int)code, out position))
+				return position;
+			return -1;
 		}
 
 		public CipherSuiteCode[] ToArray ()
@@ -61,18 +89,20 @@ namespace Mono.Security.NewTls.Cipher
 
 		public int IndexOf (CipherSuiteCode item)
 		{
-			return innerList.IndexOf (item);
+			return Find (item);
 		}
 
 		public void Insert (int index, CipherSuiteCode code)
 		{
 			ValidateCipher (code);
 			innerList.Insert (index, code);
+			this.index = null;
 		}
 
 		public void RemoveAt (int index)
 		{
 			innerList.RemoveAt (index);
+			this.index = null;
 		}
 
 		public CipherSuiteCode this [int index] {
@@ -82,6 +112,7 @@ namespace Mono.Security.NewTls.Cipher
 			set {
 				ValidateCipher (value);
 				innerList [index] = value;
+				this.index = null;
 			}
 		}
 
@@ -92,17 +123,18 @@ namespace Mono.Security.NewTls.Cipher
 		public void Add (CipherSuiteCode code)
 		{
 			ValidateCipher (code);
-			innerList.Add (code);
+			Append (code);
 		}
 
 		public void Clear ()
 		{
 			innerList.Clear ();
+			index = null;
 		}
 
 		public bool Contains (CipherSuiteCode code)
 		{
-			return innerList.Contains (code);
+			return Find (code) >= 0;
 		}
 
 		public void CopyTo (CipherSuiteCode[] array, int arrayIndex)
@@ -112,7 +144,11 @@ namespace Mono.Security.NewTls.Cipher
 
 		public bool Remove (CipherSuiteCode item)
 		{
-			return innerList.Remove (item);
+			var position = Find (item);
+			if (position < 0)
+				return false;
+			RemoveAt (position);
+			return true;
 		}
 
 		public int Count {
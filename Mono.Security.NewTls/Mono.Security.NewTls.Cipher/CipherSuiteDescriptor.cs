@@ -0,0 +1,128 @@
+﻿//
+// CipherSuiteDescriptor.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using Mono.Security.Interface;
+
+namespace Mono.Security.NewTls.Cipher
+{
+	/*
+	 * Immutable description of a cipher suite for one protocol version.  These are
+	 * computed once by CipherSuiteFactory, so looking up the parameters of a cipher
+	 * suite doesn't need to construct a CipherSuite instance.
+	 */
+	[CLSCompliant (false)]
+	public sealed class CipherSuiteDescriptor
+	{
+		internal CipherSuiteDescriptor (TlsProtocolCode protocol, CipherSuite cipher)
+		{
+			Protocol = protocol;
+			Code = cipher.Code;
+			CipherAlgorithmType = cipher.CipherAlgorithmType;
+			HashAlgorithmType = cipher.HashAlgorithmType;
+			ExchangeAlgorithmType = cipher.ExchangeAlgorithmType;
+			HashSize = cipher.HashSize;
+			KeyMaterialSize = cipher.KeyMaterialSize;
+			ExpandedKeyMaterialSize = cipher.ExpandedKeyMaterialSize;
+			FixedIvSize = cipher.FixedIvSize;
+			BlockSize = cipher.BlockSize;
+			HasHMac = cipher.HasHMac;
+		}
+
+		public TlsProtocolCode Protocol {
+			get;
+			private set;
+		}
+
+		public CipherSuiteCode Code {
+			get;
+			private set;
+		}
+
+		public CipherAlgorithmType CipherAlgorithmType {
+			get;
+			private set;
+		}
+
+		public HashAlgorithmType HashAlgorithmType {
+			get;
+			private set;
+		}
+
+		public ExchangeAlgorithmType ExchangeAlgorithmType {
+			get;
+			private set;
+		}
+
+		public int HashSize {
+			get;
+			private set;
+		}
+
+		public byte KeyMaterialSize {
+			get;
+			private set;
+		}
+
+		public byte ExpandedKeyMaterialSize {
+			get;
+			private set;
+		}
+
+		public byte FixedIvSize {
+			get;
+			private set;
+		}
+
+		public byte BlockSize {
+			get;
+			private set;
+		}
+
+		public bool HasHMac {
+			get;
+			private set;
+		}
+
+		public CipherSuite Create ()
+		{
+			switch (Protocol) {
+			case TlsProtocolCode.Tls12:
+				return new TlsCipherSuite12 (Code, CipherAlgorithmType, HashAlgorithmType, ExchangeAlgorithmType);
+			case TlsProtocolCode.Tls11:
+				return new TlsCipherSuite11 (Code, CipherAlgorithmType, HashAlgorithmType, ExchangeAlgorithmType);
+			case TlsProtocolCode.Tls10:
+				return new TlsCipherSuite10 (Code, CipherAlgorithmType, HashAlgorithmType, ExchangeAlgorithmType);
+			default:
+				throw new TlsException (AlertDescription.ProtocolVersion);
+			}
+		}
+
+		public override string ToString ()
+		{
+			return string.Format ("[CipherSuiteDescriptor: {0} {1}]", Protocol, Code);
+		}
+	}
+}
@@ -1,4 +1,5 @@
 ﻿using System;
+using System.Collections.Generic;
 using Mono.Security.Interface;
 
 namespace Mono.Security.NewTls.Cipher
@@ -7,29 +8,51 @@ namespace Mono.Security.NewTls.Cipher
 	public static class CipherSuiteFactory
 	{
 		public static CipherSuite CreateCipherSuite (TlsProtocolCode protocol, CipherSuiteCode code)
+		{
+			return GetDescriptor (protocol, code).Create ();
+		}
+
+		public static ExchangeAlgorithmType GetExchangeAlgorithmType (TlsProtocolCode protocol, CipherSuiteCode code)
+		{
+			return GetDescriptor (protocol, code).ExchangeAlgorithmType;
+		}
+
+		public static CipherSuiteDescriptor GetDescriptor (TlsProtocolCode protocol, CipherSuiteCode code)
+		{
+			CipherSuiteDescriptor descriptor;
+			if (!GetDescriptorTable (protocol).TryGetValue ((int)code, out descriptor))
+				throw new TlsException (AlertDescription.InsuficientSecurity, "Unknown cipher suite: {0}", code);
+			return descriptor;
+		}
+
+		static Dictionary<int,CipherSuiteDescriptor> GetDescriptorTable (TlsProtocolCode protocol)
 		{
 			if (protocol == TlsProtocolCode.Tls12)
-				return CreateCipherSuiteTls12 (code);
+				return DescriptorsTls12;
 			else if (protocol == TlsProtocolCode.Tls11)
-				return CreateCipherSuiteTls11 (code);
+				return DescriptorsTls11;
 			else if (protocol == TlsProtocolCode.Tls10)
-				return CreateCipherSuiteTls10 (code);
+				return DescriptorsTls10;
 			else
 				throw new TlsException (AlertDescription.ProtocolVersion);
 		}
 
-		public static ExchangeAlgorithmType GetExchangeAlgorithmType (TlsProtocolCode protocol, CipherSuiteCode code)
+		/*
+		 * The CreateCipherSuiteTls1x() switches are only run once per supported cipher
+		 * suite, when the descriptor tables are built.  The tables are keyed by the
+		 * numeric code to avoid boxing the enum in the default equality comparer.
+		 */
+		static Dictionary<int,CipherSuiteDescriptor> CreateDescriptorTable (
+			TlsProtocolCode protocol, CipherSuiteCode[] supported, Func<CipherSuiteCode,CipherSuite> factory)
 		{
-			var cipher = CreateCipherSuite (protocol, code);
-			return cipher.ExchangeAlgorithmType;
+			var table = new Dictionary<int,CipherSuiteDescriptor> (supported.Length);
+			foreach (var code in supported)
+				table.Add ((int)code, new CipherSuiteDescriptor (protocol, factory (code)));
+			return table;
 		}
 
 		static CipherSuite CreateCipherSuiteTls12 (CipherSuiteCode code)
 		{
-			// Sanity check.
-			if (!IsCipherSupported (TlsProtocolCode.Tls12, code))
-				throw new TlsException (AlertDescription.InsuficientSecurity, "Unknown cipher suite: {0}", code);
-
 			switch (code) {
 			// Galois-Counter Cipher Suites
 			case CipherSuiteCode.TLS_DHE_RSA_WITH_AES_256_GCM_SHA384:
@@ -84,10 +107,6 @@ namespace Mono.Security.NewTls.Cipher
 
 		static CipherSuite CreateCipherSuiteTls11 (CipherSuiteCode code)
 		{
-			// Sanity check.
-			if (!IsCipherSupported (TlsProtocolCode.Tls11, code))
-				throw new TlsException (AlertDescription.InsuficientSecurity, "Unknown cipher suite: {0}", code);
-
 			switch (code) {
 			case CipherSuiteCode.TLS_RSA_WITH_AES_256_CBC_SHA:
 				return new TlsCipherSuite11 (code, CipherAlgorithmType.Aes256, HashAlgorithmType.Sha1, ExchangeAlgorithmType.Rsa);
@@ -104,10 +123,6 @@ namespace Mono.Security.NewTls.Cipher
 
 		static CipherSuite CreateCipherSuiteTls10 (CipherSuiteCode code)
 		{
-			// Sanity check.
-			if (!IsCipherSupported (TlsProtocolCode.Tls10, code))
-				throw new TlsException (AlertDescription.InsuficientSecurity, "Unknown cipher suite: {0}", code);
-
 			switch (code) {
 			case CipherSuiteCode.TLS_RSA_WITH_AES_256_CBC_SHA:
 				return new TlsCipherSuite10 (code, CipherAlgorithmType.Aes256, HashAlgorithmType.Sha1, ExchangeAlgorithmType.Rsa);
@@ -124,11 +139,7 @@ namespace Mono.Security.NewTls.Cipher
 
 		public static bool IsCipherSupported (TlsProtocolCode protocol, CipherSuiteCode code)
 		{
-			var array = GetSupportedCiphersArray (protocol);
-			for (int i = 0; i < array.Length; i++)
-				if (array [i] == code)
-					return true;
-			return false;
+			return GetDescriptorTable (protocol).ContainsKey ((int)code);
 		}
 
 		public static CipherSuiteCollection GetDefaultCiphers (TlsProtocolCode protocol)
@@ -223,6 +234,13 @@ namespace Mono.Security.NewTls.Cipher
 		static readonly CipherSuiteCode[] DefaultCiphersTls12 = SupportedCiphersTls12;
 		static readonly CipherSuiteCode[] DefaultCiphersTls11 = SupportedCiphersTls11;
 		static readonly CipherSuiteCode[] DefaultCiphersTls10 = SupportedCiphersTls10;
+
+		static readonly Dictionary<int,CipherSuiteDescriptor> DescriptorsTls12 = CreateDescriptorTable (
+			TlsProtocolCode.Tls12, SupportedCiphersTls12, CreateCipherSuiteTls12);
+		static readonly Dictionary<int,CipherSuiteDescriptor> DescriptorsTls11 = CreateDescriptorTable (
+			TlsProtocolCode.Tls11, SupportedCiphersTls11, CreateCipherSuiteTls11);
+		static readonly Dictionary<int,CipherSuiteDescriptor> DescriptorsTls10 = CreateDescriptorTable (
+			TlsProtocolCode.Tls10, SupportedCiphersTls10, CreateCipherSuiteTls10);
 	}
 }
 
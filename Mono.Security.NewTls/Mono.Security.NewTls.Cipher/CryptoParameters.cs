@@ -153,6 +153,12 @@ namespace Mono.Security.NewTls.Cipher
 			readSequenceNumber = 0;
 		}
 
+		#if INSIDE_MONO_NEWTLS
+		internal virtual void Configure (TlsConfiguration configuration)
+		{
+		}
+		#endif
+
 		public abstract void InitializeCipher ();
 
 		public abstract int MinExtraEncryptedBytes {
@@ -163,6 +169,14 @@ namespace Mono.Security.NewTls.Cipher
 			get;
 		}
 
+		/*
+		 * Number of bytes in front of the ciphertext in an encrypted fragment,
+		 * such as the explicit IV or nonce.
+		 */
+		public abstract int EncryptedHeaderSize {
+			get;
+		}
+
 		public abstract int GetEncryptedSize (int size);
 
 		public IBufferOffsetSize Encrypt (ContentType contentType, IBufferOffsetSize data)
@@ -219,6 +233,31 @@ namespace Mono.Security.NewTls.Cipher
 			}
 		}
 
+		/*
+		 * Authenticates and decrypts the fragment within its own buffer and returns
+		 * a view of the plaintext, which starts right after the EncryptedHeaderSize
+		 * header bytes.  The ciphertext is overwritten.
+		 */
+		public IBufferOffsetSize DecryptInPlace (ContentType contentType, IBufferOffsetSize input)
+		{
+			if (input.Size < EncryptedHeaderSize)
+				throw new TlsException (AlertDescription.BadRecordMAC);
+
+			var output = new BufferOffsetSize (input.Buffer, input.Offset + EncryptedHeaderSize, input.Size - EncryptedHeaderSize);
+
+			using (var d = new DisposeContext ()) {
+				var ret = Decrypt (d, contentType, input, output);
+
+				// Update sequence number
+				ReadSequenceNumber++;
+
+				if (ret < 0)
+					throw new TlsException (AlertDescription.BadRecordMAC);
+				output.TruncateTo (ret);
+				return output;
+			}
+		}
+
 		/*
 		 * Returns -1 on error because for some of the Cipher Suites (such as the CBC Block Cipher) it is strictly forbidden
 		 * to throw any Exceptions in here.
@@ -44,7 +44,9 @@ namespace Mono.Security.NewTls.Cipher
 
 		public override void GenerateClient (TlsContext ctx)
 		{
-			using (var dh = new DiffieHellmanManaged (P, G, 0)) {
+			// The private value comes from the session's generator, like all other handshake randomness.
+			using (var x = ctx.Session.GetSecureRandomBytes (P.Length - 1))
+			using (var dh = new DiffieHellmanManaged (P, G, x.Buffer)) {
 				using (var X = new SecureBuffer (dh.DecryptKeyExchange (Y))) {
 					Y = dh.CreateKeyExchange ();
 					ComputeMasterSecret (ctx, X);
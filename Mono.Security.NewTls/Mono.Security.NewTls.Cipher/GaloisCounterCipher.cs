@@ -31,6 +31,7 @@ namespace Mono.Security.NewTls.Cipher
 {
 	using Org.BouncyCastle.Crypto.Engines;
 	using Org.BouncyCastle.Crypto.Modes;
+	using Org.BouncyCastle.Crypto.Modes.Gcm;
 	using Org.BouncyCastle.Crypto.Parameters;
 	using Org.BouncyCastle.Crypto;
 
@@ -51,11 +52,86 @@ namespace Mono.Security.NewTls.Cipher
 			if (MacSize != Cipher.BlockSize)
 				throw new TlsException (AlertDescription.IlegalParameter);
 #if !BOOTSTRAP_BASIC
-			random = Add (RandomNumberGenerator.Create ()); 
+			if (NonceType == GcmNonceType.Random)
+				random = Add (new BufferedRandomNumberGenerator (RandomNumberGenerator.Create ()));
 #endif
+
+			/*
+			 * The key schedule and the GHASH tables only depend on the write key,
+			 * so we set them up once per direction and only pass the nonce and
+			 * the additional data when processing a record.
+			 */
+			encryptor = CreateGcm (IsClient ? ClientWriteKey : ServerWriteKey);
+			decryptor = CreateGcm (IsClient ? ServerWriteKey : ClientWriteKey);
+
+			// Per-record scratch space, so processing a record doesn't allocate.
+			encryptNonce = CreateBuffer (ImplicitNonceSize + ExplicitNonceSize);
+			decryptNonce = CreateBuffer (ImplicitNonceSize + ExplicitNonceSize);
+			explicitNonce = CreateBuffer (ExplicitNonceSize);
+			encryptAad = new byte [13];
+			decryptAad = new byte [13];
+		}
+
+		BufferedRandomNumberGenerator random;
+		GcmBlockCipher encryptor;
+		GcmBlockCipher decryptor;
+		SecureBuffer encryptNonce;
+		SecureBuffer decryptNonce;
+		SecureBuffer explicitNonce;
+		byte[] encryptAad;
+		byte[] decryptAad;
+
+		public AesEngineType EngineType {
+			get; set;
+		}
+
+		public GcmMultiplierType MultiplierType {
+			get; set;
+		}
+
+		public GcmNonceType NonceType {
+			get; set;
+		}
+
+		#if INSIDE_MONO_NEWTLS
+		internal override void Configure (TlsConfiguration configuration)
+		{
+			EngineType = configuration.AesEngineType;
+			MultiplierType = configuration.GcmMultiplierType;
+			NonceType = configuration.GcmNonceType;
 		}
+		#endif
 
-		RandomNumberGenerator random;
+		IBlockCipher CreateEngine ()
+		{
+			switch (EngineType) {
+			case AesEngineType.Fast:
+				return new AesFastEngine ();
+			case AesEngineType.Light:
+				return new AesLightEngine ();
+			default:
+				return new AesEngine ();
+			}
+		}
+
+		IGcmMultiplier CreateMultiplier ()
+		{
+			switch (MultiplierType) {
+			case GcmMultiplierType.Basic:
+				return new BasicGcmMultiplier ();
+			case GcmMultiplierType.Tables64k:
+				return new Tables64kGcmMultiplier ();
+			default:
+				return new Tables8kGcmMultiplier ();
+			}
+		}
+
+		GcmBlockCipher CreateGcm (SecureBuffer writeKey)
+		{
+			var gcm = new GcmBlockCipher (CreateEngine (), CreateMultiplier ());
+			gcm.Init (true, new AeadParameters (new KeyParameter (writeKey.Buffer), 128, new byte [ImplicitNonceSize + ExplicitNonceSize], null));
+			return gcm;
+		}
 
 		public int ImplicitNonceSize {
 			get;
@@ -80,41 +156,53 @@ namespace Mono.Security.NewTls.Cipher
 			get { return ExplicitNonceSize + MacSize; }
 		}
 
+		public override int EncryptedHeaderSize {
+			get { return ExplicitNonceSize; }
+		}
+
 		public override int GetEncryptedSize (int size)
 		{
 			return size + ExplicitNonceSize + MacSize;
 		}
 
+		void EncodeAdditionalData (byte[] aad, ulong sequenceNumber, ContentType contentType, int length)
+		{
+			for (int i = 0; i < 8; i++)
+				aad [i] = (byte)(sequenceNumber >> (56 - i * 8));
+			aad [8] = (byte)contentType;
+			aad [9] = (byte)((short)Protocol >> 8);
+			aad [10] = (byte)Protocol;
+			aad [11] = (byte)(length >> 8);
+			aad [12] = (byte)length;
+		}
+
 		protected override int Decrypt (DisposeContext d, ContentType contentType, IBufferOffsetSize input, IBufferOffsetSize output)
 		{
 			var implicitNonce = IsClient ? ServerWriteIV : ClientWriteIV;
-			var writeKey = IsClient ? ServerWriteKey : ClientWriteKey;
 
 			#if DEBUG_FULL
 			if (Cipher.EnableDebugging) {
 				DebugHelper.WriteLine ("FIXED IV", implicitNonce);
-				DebugHelper.WriteLine ("WRITE KEY", writeKey);
+				DebugHelper.WriteLine ("WRITE KEY", IsClient ? ServerWriteKey : ClientWriteKey);
 				DebugHelper.WriteLine ("SEQUENCE: {0}", ReadSequenceNumber);
 			}
 			#endif
 
 			var length = input.Size - ExplicitNonceSize;
 
-			var aad = new TlsBuffer (13);
-			aad.Write (ReadSequenceNumber);
-			aad.Write ((byte)contentType);
-			aad.Write ((short)Protocol);
-			aad.Write ((short)(length - MacSize));
+			var aad = decryptAad;
+			EncodeAdditionalData (aad, ReadSequenceNumber, contentType, length - MacSize);
 
 			#if DEBUG_FULL
 			if (Cipher.EnableDebugging)
-				DebugHelper.WriteFull ("TAG", aad);
+				DebugHelper.WriteLine ("TAG", aad);
 			#endif
 
-			var gcm = new GcmBlockCipher (new AesEngine ());
-			var key = new KeyParameter (writeKey.Buffer);
-
-			var nonce = d.CreateBuffer (ImplicitNonceSize + ExplicitNonceSize);
+			/*
+			 * The explicit nonce is read before anything is written, so the output may
+			 * be the same buffer as the input, starting at the ciphertext.
+			 */
+			var nonce = decryptNonce;
 			Buffer.BlockCopy (implicitNonce.Buffer, 0, nonce.Buffer, 0, ImplicitNonceSize);
 			Buffer.BlockCopy (input.Buffer, input.Offset, nonce.Buffer, ImplicitNonceSize, ExplicitNonceSize);
 
@@ -123,8 +211,8 @@ namespace Mono.Security.NewTls.Cipher
 				DebugHelper.WriteLine ("NONCE", nonce);
 			#endif
 
-			var parameters = new AeadParameters (key, 128, nonce.Buffer, aad.Buffer);
-			gcm.Init (false, parameters);
+			var gcm = decryptor;
+			gcm.Init (false, new AeadParameters (null, 128, nonce.Buffer, aad));
 
 			int ret;
 			try {
@@ -138,41 +226,48 @@ namespace Mono.Security.NewTls.Cipher
 			return ret;
 		}
 
+		protected override void Clear ()
+		{
+			encryptor = null;
+			decryptor = null;
+			base.Clear ();
+		}
+
 		protected virtual void CreateExplicitNonce (SecureBuffer explicitNonce)
 		{
-			random.GetBytes (explicitNonce.Buffer);
+			if (random != null) {
+				random.GetBytes (explicitNonce.Buffer, 0, ExplicitNonceSize);
+				return;
+			}
+
+			var sequenceNumber = WriteSequenceNumber;
+			for (int i = 0; i < ExplicitNonceSize; i++)
+				explicitNonce.Buffer [i] = (byte)(sequenceNumber >> (56 - i * 8));
 		}
 
 		protected override int Encrypt (DisposeContext d, ContentType contentType, IBufferOffsetSize input, IBufferOffsetSize output)
 		{
 			var implicitNonce = IsClient ? ClientWriteIV : ServerWriteIV;
-			var writeKey = IsClient ? ClientWriteKey : ServerWriteKey;
 
 			#if DEBUG_FULL
 			if (Cipher.EnableDebugging) {
 				DebugHelper.WriteLine ("FIXED IV", implicitNonce);
-				DebugHelper.WriteLine ("WRITE KEY", writeKey);
+				DebugHelper.WriteLine ("WRITE KEY", IsClient ? ClientWriteKey : ServerWriteKey);
 				DebugHelper.WriteLine ("SEQUENCE: {0}", WriteSequenceNumber);
 			}
 			#endif
 
 			var length = input.Size;
 
-			var aad = new TlsBuffer (13);
-			aad.Write (WriteSequenceNumber);
-			aad.Write ((byte)contentType);
-			aad.Write ((short)Protocol);
-			aad.Write ((short)length);
+			var aad = encryptAad;
+			EncodeAdditionalData (aad, WriteSequenceNumber, contentType, length);
 
 			#if DEBUG_FULL
 			if (Cipher.EnableDebugging)
-				DebugHelper.WriteFull ("TAG", aad);
+				DebugHelper.WriteLine ("TAG", aad);
 			#endif
 
-			var gcm = new GcmBlockCipher (new AesEngine ());
-			var key = new KeyParameter (writeKey.Buffer);
-			var nonce = d.CreateBuffer (ImplicitNonceSize + ExplicitNonceSize);
-			var explicitNonce = d.CreateBuffer (ExplicitNonceSize);
+			var nonce = encryptNonce;
 			CreateExplicitNonce (explicitNonce);
 			Buffer.BlockCopy (implicitNonce.Buffer, 0, nonce.Buffer, 0, ImplicitNonceSize);
 			Buffer.BlockCopy (explicitNonce.Buffer, 0, nonce.Buffer, ImplicitNonceSize, ExplicitNonceSize);
@@ -184,8 +279,8 @@ namespace Mono.Security.NewTls.Cipher
 				DebugHelper.WriteLine ("NONCE", nonce);
 			#endif
 
-			var parameters = new AeadParameters (key, 128, nonce.Buffer, aad.Buffer);
-			gcm.Init (true, parameters);
+			var gcm = encryptor;
+			gcm.Init (true, new AeadParameters (null, 128, nonce.Buffer, aad));
 
 			int ret;
 
@@ -7,38 +7,118 @@ namespace Mono.Security.NewTls.Cipher
 {
 	using Handshake;
 
-	class HandshakeHash : SecretParameters
+	public class HandshakeHash : SecretParameters
 	{
+		/*
+		 * Only one or two of these are ever read, so we keep the raw handshake messages
+		 * around and only create a hash algorithm - replaying the transcript into it -
+		 * once it's actually needed.
+		 */
 		IHashAlgorithm[] hashes;
+		byte[] transcript;
+		int transcriptLength;
+		long bytesHashed;
+
+		const int InitialTranscriptSize = 4096;
 
 		public HandshakeHash ()
 		{
 			hashes = new IHashAlgorithm [6];
-			hashes [0] = new MSC.MD5SHA1 ();
-			hashes [1] = new MSC.SHA1CryptoServiceProvider ();
-			hashes [2] = new MSC.SHA224Managed ();
-			hashes [3] = new MSC.SHA256Managed ();
-			hashes [4] = new MSC.SHA384Managed ();
-			hashes [5] = new MSC.SHA512Managed ();
+			transcript = new byte [InitialTranscriptSize];
+		}
+
+		public long BytesHashed {
+			get { return bytesHashed; }
+		}
+
+		public int TranscriptLength {
+			get { return transcriptLength; }
+		}
+
+		// Hash algorithms which have been created so far.
+		public int Algorithms {
+			get {
+				int count = 0;
+				for (int i = 0; i < hashes.Length; i++) {
+					if (hashes [i] != null)
+						count++;
+				}
+				return count;
+			}
 		}
 
-		public void Add (HandshakeMessage message, IBufferOffsetSize buffer)
+		internal void Add (HandshakeMessage message, IBufferOffsetSize buffer)
 		{
 			if (message is TlsHelloRequest)
 				throw new InvalidOperationException ();
-			for (int i = 0; i < hashes.Length; i++)
+
+			Add (buffer);
+		}
+
+		public void Add (IBufferOffsetSize buffer)
+		{
+			for (int i = 0; i < hashes.Length; i++) {
+				if (hashes [i] == null)
+					continue;
 				hashes [i].TransformBlock (buffer.Buffer, buffer.Offset, buffer.Size);
+				bytesHashed += buffer.Size;
+			}
+
+			if (transcriptLength + buffer.Size > transcript.Length) {
+				var newSize = transcript.Length;
+				while (newSize < transcriptLength + buffer.Size)
+					newSize <<= 1;
+				var newTranscript = new byte [newSize];
+				Buffer.BlockCopy (transcript, 0, newTranscript, 0, transcriptLength);
+				Array.Clear (transcript, 0, transcriptLength);
+				transcript = newTranscript;
+			}
+
+			Buffer.BlockCopy (buffer.Buffer, buffer.Offset, transcript, transcriptLength, buffer.Size);
+			transcriptLength += buffer.Size;
+		}
+
+		static IHashAlgorithm CreateAlgorithm (int index)
+		{
+			switch (index) {
+			case 0:
+				return new MSC.MD5SHA1 ();
+			case 1:
+				return new MSC.SHA1CryptoServiceProvider ();
+			case 2:
+				return new MSC.SHA224Managed ();
+			case 3:
+				return new MSC.SHA256Managed ();
+			case 4:
+				return new MSC.SHA384Managed ();
+			case 5:
+				return new MSC.SHA512Managed ();
+			default:
+				throw new InvalidOperationException ();
+			}
+		}
+
+		IHashAlgorithm GetOrCreateAlgorithm (int index)
+		{
+			var algorithm = hashes [index];
+			if (algorithm != null)
+				return algorithm;
+
+			algorithm = hashes [index] = CreateAlgorithm (index);
+			algorithm.TransformBlock (transcript, 0, transcriptLength);
+			bytesHashed += transcriptLength;
+			return algorithm;
 		}
 
 		IHashAlgorithm GetAlgorithm (HandshakeHashType type)
 		{
 			switch (type) {
 			case HandshakeHashType.MD5SHA1:
-				return hashes [0];
+				return GetOrCreateAlgorithm (0);
 			case HandshakeHashType.SHA256:
-				return hashes [3];
+				return GetOrCreateAlgorithm (3);
 			case HandshakeHashType.SHA384:
-				return hashes [4];
+				return GetOrCreateAlgorithm (4);
 			default:
 				throw new InvalidOperationException ();
 			}
@@ -48,17 +128,17 @@ namespace Mono.Security.NewTls.Cipher
 		{
 			switch (type) {
 			case HashAlgorithmType.Md5Sha1:
-				return hashes [0];
+				return GetOrCreateAlgorithm (0);
 			case HashAlgorithmType.Sha1:
-				return hashes [1];
+				return GetOrCreateAlgorithm (1);
 			case HashAlgorithmType.Sha224:
-				return hashes [2];
+				return GetOrCreateAlgorithm (2);
 			case HashAlgorithmType.Sha256:
-				return hashes [3];
+				return GetOrCreateAlgorithm (3);
 			case HashAlgorithmType.Sha384:
-				return hashes [4];
+				return GetOrCreateAlgorithm (4);
 			case HashAlgorithmType.Sha512:
-				return hashes [5];
+				return GetOrCreateAlgorithm (5);
 			default:
 				throw new NotSupportedException ();
 			}
@@ -69,13 +149,13 @@ namespace Mono.Security.NewTls.Cipher
 			return new SecureBuffer (GetAlgorithm (type).GetRunningHash ());
 		}
 
-		public void CreateSignature (Signature signature, AsymmetricAlgorithm key)
+		internal void CreateSignature (Signature signature, AsymmetricAlgorithm key)
 		{
 			var algorithm = GetAlgorithm (signature.HashAlgorithm);
 			signature.Create (algorithm.GetRunningHash (), key);
 		}
 
-		public bool VerifySignature (Signature signature, AsymmetricAlgorithm key)
+		internal bool VerifySignature (Signature signature, AsymmetricAlgorithm key)
 		{
 			var algorithm = GetAlgorithm (signature.HashAlgorithm);
 			return signature.Verify (algorithm.GetRunningHash (), key);
@@ -84,8 +164,13 @@ namespace Mono.Security.NewTls.Cipher
 		protected override void Clear ()
 		{
 			for (int i = 0; i < hashes.Length; i++) {
-				hashes [0].Dispose ();
+				if (hashes [i] != null) {
+					hashes [i].Dispose ();
+					hashes [i] = null;
+				}
 			}
+			Array.Clear (transcript, 0, transcriptLength);
+			transcriptLength = 0;
 		}
 	}
 }
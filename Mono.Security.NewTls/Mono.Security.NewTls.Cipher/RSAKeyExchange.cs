@@ -60,6 +60,7 @@ namespace Mono.Security.NewTls.Cipher
 
 				// Encrypt premaster_sercret
 				var formatter = new RSAPKCS1KeyExchangeFormatter (rsa);
+				formatter.Rng = ctx.Session.RandomNumberGenerator;
 				encryptedPreMasterSecret = formatter.CreateKeyExchange (preMasterSecret.Buffer);
 				rsa.Clear ();
 			}
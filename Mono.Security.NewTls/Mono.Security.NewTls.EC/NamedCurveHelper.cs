@@ -1,12 +1,36 @@
 using System;
+using System.Collections.Generic;
 using BCA = Org.BouncyCastle.Asn1;
 using Org.BouncyCastle.Crypto.Parameters;
+using Org.BouncyCastle.Math.EC.Multiplier;
 
 namespace Mono.Security.NewTls.EC
 {
 	internal static class NamedCurveHelper
 	{
+		static readonly Dictionary<NamedCurve, ECDomainParameters> cache = new Dictionary<NamedCurve, ECDomainParameters> ();
+
+		/*
+		 * The returned parameters are shared between all connections using the same curve,
+		 * so they must be treated as immutable.  The generator carries a precomputed fixed-base
+		 * comb table, which makes key generation considerably cheaper than the generic WNAF
+		 * multiplication.
+		 */
 		internal static ECDomainParameters GetECParameters (NamedCurve namedCurve)
+		{
+			lock (cache) {
+				ECDomainParameters parameters;
+				if (cache.TryGetValue (namedCurve, out parameters))
+					return parameters;
+
+				parameters = CreateECParameters (namedCurve);
+				if (parameters != null)
+					cache.Add (namedCurve, parameters);
+				return parameters;
+			}
+		}
+
+		static ECDomainParameters CreateECParameters (NamedCurve namedCurve)
 		{
  			if (!Enum.IsDefined (typeof(NamedCurve), namedCurve))
 				return null;
@@ -19,8 +43,14 @@ namespace Mono.Security.NewTls.EC
 			if (ecP == null)
 				return null;
 
-			// It's a bit inefficient to do this conversion every time
-			return new ECDomainParameters (ecP.Curve, ecP.G, ecP.N, ecP.H, ecP.GetSeed ());
+			/*
+			 * Use a private copy of the generator, so the precomputation does not leak into
+			 * the X9ECParameters instance which SecNamedCurves hands out to everybody else.
+			 */
+			var g = ecP.Curve.CreatePoint (ecP.G.X.ToBigInteger (), ecP.G.Y.ToBigInteger (), false);
+			FixedPointCombMultiplier.Precompute (g, ecP.N);
+
+			return new ECDomainParameters (ecP.Curve, g, ecP.N, ecP.H, ecP.GetSeed ());
 		}
 	}
 }
@@ -6,6 +6,7 @@ using System.Globalization;
 using Org.BouncyCastle.Asn1.X9;
 using Org.BouncyCastle.Math;
 using Org.BouncyCastle.Math.EC;
+using Org.BouncyCastle.Math.EC.Custom.Sec;
 using Org.BouncyCastle.Utilities.Encoders;
 
 namespace Mono.Security.NewTls.EC
@@ -440,7 +441,7 @@ namespace Mono.Security.NewTls.EC
 				BigInteger n = FromHex ("FFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551");
 				BigInteger h = BigInteger.ValueOf (1);
 
-				ECCurve curve = new FpCurve (p, a, b);
+				ECCurve curve = new SecP256R1Curve (p, a, b);
 				//ECPoint G = curve.DecodePoint(Hex.Decode("03"
 				//+ "6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296"));
 				ECPoint G = curve.DecodePoint (Hex.Decode ("04"
@@ -473,7 +474,7 @@ namespace Mono.Security.NewTls.EC
 				BigInteger n = FromHex ("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFC7634D81F4372DDF581A0DB248B0A77AECEC196ACCC52973");
 				BigInteger h = BigInteger.ValueOf (1);
 
-				ECCurve curve = new FpCurve (p, a, b);
+				ECCurve curve = new SecP384R1Curve (p, a, b);
 				//ECPoint G = curve.DecodePoint(Hex.Decode("03"
 				//+ "AA87CA22BE8B05378EB1C71EF320AD746E1D3B628BA79B9859F741E082542A385502F25DBF55296C3A545E3872760AB7"));
 				ECPoint G = curve.DecodePoint (Hex.Decode ("04"
@@ -10,7 +10,7 @@ namespace Mono.Security.NewTls.Handshake
 		{
 		}
 
-		public IBufferOffsetSize EncodeMessage ()
+		public virtual IBufferOffsetSize EncodeMessage ()
 		{
 			var stream = new TlsStream ();
 			stream.Write (0);
@@ -7,12 +7,24 @@ namespace Mono.Security.NewTls.Handshake
 
 	class TlsCertificate : HandshakeMessage
 	{
+		readonly IBufferOffsetSize encoded;
+
 		public TlsCertificate (X509CertificateCollection certificates)
 			: base (HandshakeType.Certificate)
 		{
 			Certificates = certificates;
 		}
 
+		/*
+		 * @encoded is the complete, previously encoded message (including the
+		 * handshake header), which is sent instead of encoding @certificates again.
+		 */
+		public TlsCertificate (X509CertificateCollection certificates, IBufferOffsetSize encoded)
+			: this (certificates)
+		{
+			this.encoded = encoded;
+		}
+
 		public TlsCertificate (TlsBuffer incoming)
 			: base (HandshakeType.Certificate)
 		{
@@ -47,6 +59,13 @@ namespace Mono.Security.NewTls.Handshake
 
 		}
 
+		public override IBufferOffsetSize EncodeMessage ()
+		{
+			if (encoded != null)
+				return encoded;
+			return base.EncodeMessage ();
+		}
+
 		protected override void Encode (TlsStream stream)
 		{
 			var startPosition = stream.Position;
@@ -14,6 +14,8 @@ namespace Mono.Security.NewTls.Handshake
 			private set;
 		}
 
+		readonly Func<string, byte[]> encodeIssuer;
+
 		public TlsCertificateRequest (TlsProtocolCode protocol, ClientCertificateParameters parameters)
 			: base (HandshakeType.CertificateRequest)
 		{
@@ -21,6 +23,16 @@ namespace Mono.Security.NewTls.Handshake
 			Parameters = parameters;
 		}
 
+		/*
+		 * @encodeIssuer returns the DER encoding of a certificate authority's name;
+		 * the server passes a cached lookup from its TlsConfiguration.
+		 */
+		public TlsCertificateRequest (TlsProtocolCode protocol, ClientCertificateParameters parameters, Func<string, byte[]> encodeIssuer)
+			: this (protocol, parameters)
+		{
+			this.encodeIssuer = encodeIssuer;
+		}
+
 		public TlsCertificateRequest (TlsProtocolCode protocol, TlsBuffer incoming)
 			: base (HandshakeType.CertificateRequest)
 		{
@@ -51,7 +63,7 @@ namespace Mono.Security.NewTls.Handshake
 			var startPos = stream.Position;
 			stream.Write ((short)0);
 			foreach (var issuer in Parameters.CertificateAuthorities) {
-				var bytes = X501.FromString (issuer).GetBytes ();
+				var bytes = encodeIssuer != null ? encodeIssuer (issuer) : X501.FromString (issuer).GetBytes ();
 				stream.Write ((short)bytes.Length);
 				stream.Write (bytes);
 			}
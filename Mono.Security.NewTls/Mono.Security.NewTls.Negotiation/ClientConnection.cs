@@ -70,7 +70,7 @@ namespace Mono.Security.NewTls.Negotiation
 
 		protected virtual TlsClientHello GenerateClientHello ()
 		{
-			var clientUnixTime = HandshakeParameters.GetUnixTime ();
+			var clientUnixTime = HandshakeParameters.GetUnixTime (Context.UtcNow);
 			TlsBuffer.WriteInt32 (HandshakeParameters.ClientRandom.Buffer, 0, clientUnixTime);
 
 			if (ServerNameExtension.IsLegalHostName (Config.TargetHost))
@@ -132,11 +132,9 @@ namespace Mono.Security.NewTls.Negotiation
 
 			CipherSuite selectedCipher = null;
 			foreach (var code in message.ClientCiphers) {
-				var idx = HandshakeParameters.SupportedCiphers.IndexOf (code);
-				if (idx < 0)
+				if (!HandshakeParameters.SupportedCiphers.Contains (code))
 					continue;
-				var cipher = HandshakeParameters.SupportedCiphers [idx];
-				selectedCipher = CipherSuiteFactory.CreateCipherSuite (Context.NegotiatedProtocol, cipher);
+				selectedCipher = CipherSuiteFactory.CreateCipherSuite (Context.NegotiatedProtocol, code);
 				break;
 			}
 
@@ -155,6 +153,7 @@ namespace Mono.Security.NewTls.Negotiation
 
 			// FIXME: Select best one.
 			Session.PendingCrypto = selectedCipher.Initialize (true, Context.NegotiatedProtocol);
+			Session.PendingCrypto.Configure (Config);
 			Session.PendingCrypto.ServerCertificates = new X509CertificateCollection ();
 			Session.PendingCrypto.ServerCertificates.Add (certificate);
 		}
@@ -174,7 +173,7 @@ namespace Mono.Security.NewTls.Negotiation
 
 		protected virtual TlsServerHello GenerateServerHello ()
 		{
-			var serverUnixTime = HandshakeParameters.GetUnixTime ();
+			var serverUnixTime = HandshakeParameters.GetUnixTime (Context.UtcNow);
 			HandshakeParameters.ServerRandom = Context.Session.GetSecureRandomBytes (32);
 			TlsBuffer.WriteInt32 (HandshakeParameters.ServerRandom.Buffer, 0, serverUnixTime);
 
@@ -185,7 +184,8 @@ namespace Mono.Security.NewTls.Negotiation
 
 		protected virtual TlsCertificate GenerateServerCertificate ()
 		{
-			return new TlsCertificate (PendingCrypto.ServerCertificates);
+			var certificates = PendingCrypto.ServerCertificates;
+			return new TlsCertificate (certificates, Config.GetEncodedCertificateMessage (certificates));
 		}
 
 		protected virtual TlsServerKeyExchange GenerateServerKeyExchange ()
@@ -216,7 +216,7 @@ namespace Mono.Security.NewTls.Negotiation
 				return null;
 
 			Session.ClientCertificateParameters = Context.SignatureProvider.GetServerCertificateParameters (Context);
-			return new TlsCertificateRequest (Context.NegotiatedProtocol, Session.ClientCertificateParameters);
+			return new TlsCertificateRequest (Context.NegotiatedProtocol, Session.ClientCertificateParameters, Config.EncodeCertificateAuthority);
 		}
 
 		protected virtual void Resolve ()
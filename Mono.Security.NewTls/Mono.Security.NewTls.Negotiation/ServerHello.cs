@@ -126,6 +126,7 @@ namespace Mono.Security.NewTls.Negotiation
 				cipher.EnableDebugging = true;
 			#endif
 			Session.PendingCrypto = cipher.Initialize (false, Context.NegotiatedProtocol);
+			Session.PendingCrypto.Configure (Config);
 		}
 
 		protected virtual void HandleExtensions (TlsServerHello message)
@@ -24,10 +24,8 @@ namespace Mono.Security.NewTls
 
 		internal const long  UNIX_BASE_TICKS = 621355968000000000;
 
-		internal int GetUnixTime ()
+		internal int GetUnixTime (DateTime now)
 		{
-			DateTime now = DateTime.UtcNow;
-
 			return (int)((now.Ticks - UNIX_BASE_TICKS) / TimeSpan.TicksPerSecond);
 		}
 
@@ -0,0 +1,146 @@
+﻿//
+// HandshakeReassemblyBuffer.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using Mono.Security.Interface;
+
+namespace Mono.Security.NewTls
+{
+	/*
+	 * Collects handshake messages which span several records.
+	 *
+	 * Fragments are appended into a single growable buffer which is rented from
+	 * the context's RecordBufferPool; once the first message is complete, the
+	 * whole contents are handed out as one TlsBuffer view and the messages are
+	 * decoded straight out of it.  Any trailing partial message is moved back to
+	 * the front of the buffer, so it is reused for the entire handshake.
+	 */
+	class HandshakeReassemblyBuffer
+	{
+		const int InitialSize = 4096;
+
+		readonly RecordBufferPool pool;
+		byte[] buffer;
+		int size;
+		int takenSize;
+		long rents;
+
+		public HandshakeReassemblyBuffer (RecordBufferPool pool)
+		{
+			this.pool = pool;
+		}
+
+		public bool IsEmpty {
+			get { return size == 0; }
+		}
+
+		// Buffers rented from the pool, whether it allocated them or not.
+		public long Rents {
+			get { return rents; }
+		}
+
+		public bool HasCompleteMessage {
+			get {
+				if (size < 4)
+					return false;
+				var length = (buffer [1] << 16) | (buffer [2] << 8) | buffer [3];
+				return size >= length + 4;
+			}
+		}
+
+		public void Append (byte[] data, int offset, int count)
+		{
+			if (buffer == null || size + count > buffer.Length) {
+				var newSize = buffer != null ? buffer.Length : InitialSize;
+				while (newSize < size + count)
+					newSize <<= 1;
+				var newBuffer = pool.Rent (newSize);
+				rents++;
+				if (buffer != null) {
+					Buffer.BlockCopy (buffer, 0, newBuffer, 0, size);
+					Release ();
+				}
+				buffer = newBuffer;
+			}
+
+			Buffer.BlockCopy (data, offset, buffer, size, count);
+			size += count;
+		}
+
+		/*
+		 * Hands out everything collected so far and empties the buffer; the returned
+		 * view stays valid until the next Append() or Clear().
+		 */
+		public TlsBuffer Take ()
+		{
+			var view = new TlsBuffer (new BufferOffsetSize (buffer, 0, size));
+			takenSize = size;
+			size = 0;
+			return view;
+		}
+
+		/*
+		 * Undoes Take() when the caller needs to process the same data again.
+		 */
+		public void Restore ()
+		{
+			if (size != 0)
+				throw new InvalidOperationException ();
+			size = takenSize;
+		}
+
+		/*
+		 * @data may point into our own buffer, in which case BlockCopy() moves the
+		 * partial message to the front.
+		 */
+		public void Retain (byte[] data, int offset, int count)
+		{
+			if (data == buffer) {
+				if (size != 0)
+					throw new InvalidOperationException ();
+				Buffer.BlockCopy (buffer, offset, buffer, 0, count);
+				Array.Clear (buffer, count, offset);
+				size = count;
+				return;
+			}
+
+			Append (data, offset, count);
+		}
+
+		void Release ()
+		{
+			Array.Clear (buffer, 0, buffer.Length);
+			pool.Return (buffer);
+			buffer = null;
+		}
+
+		public void Clear ()
+		{
+			if (buffer != null)
+				Release ();
+			size = takenSize = 0;
+		}
+	}
+}
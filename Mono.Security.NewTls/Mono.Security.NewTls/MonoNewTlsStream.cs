@@ -33,7 +33,9 @@ using SslStream = NewSystemSource::System.Net.Security.SslStream;
 
 using System;
 using System.IO;
+using System.Threading;
 using System.Threading.Tasks;
+using System.Runtime.ExceptionServices;
 #if PREBUILT_MSI
 using MSI = PrebuiltSystem::Mono.Security.Interface;
 #else
@@ -51,6 +53,20 @@ namespace Mono.Security.Providers.NewTls
 	{
 		MSI.MonoTlsProvider provider;
 
+		/*
+		 * Write-behind buffer: small application writes are gathered here and handed to
+		 * SslStream in one piece, so they are encoded into full-size records and sent with
+		 * a single transport write.
+		 */
+		readonly object writeLock = new object ();
+		byte[] pendingWrites;
+		int pendingSize;
+		bool asyncWritePending;
+		Timer flushTimer;
+		Exception flushError;
+		long coalescedWrites;
+		long transportWrites;
+
 		internal MonoNewTlsStream (Stream innerStream, MSI.MonoTlsProvider provider, MSI.MonoTlsSettings settings)
 			: this (innerStream, false, provider, settings)
 		{
@@ -60,6 +76,12 @@ namespace Mono.Security.Providers.NewTls
 			: base (innerStream, leaveOpen, EncryptionPolicy.RequireEncryption, provider, settings)
 		{
 			this.provider = provider;
+
+			var userSettings = settings != null ? settings.UserSettings as UserSettings : null;
+			if (userSettings != null) {
+				WriteCoalescingThreshold = userSettings.WriteCoalescingThreshold;
+				WriteCoalescingDelay = userSettings.WriteCoalescingDelay;
+			}
 		}
 
 		public MSI.MonoTlsProvider Provider {
@@ -75,8 +97,234 @@ namespace Mono.Security.Providers.NewTls
 			return GetMonoConnectionInfo ();
 		}
 
+		/*
+		 * Writes smaller than this many bytes are held back until the threshold is
+		 * reached, the delay expires or Flush() is called.  Zero disables coalescing.
+		 */
+		public int WriteCoalescingThreshold {
+			get; set;
+		}
+
+		/*
+		 * Maximum time a coalesced write may sit in the buffer; null means that it is
+		 * only sent once the threshold is reached or on an explicit flush.
+		 */
+		public TimeSpan? WriteCoalescingDelay {
+			get; set;
+		}
+
+		public int PendingWriteSize {
+			get { return pendingSize; }
+		}
+
+		public long CoalescedWrites {
+			get { return coalescedWrites; }
+		}
+
+		public long TransportWrites {
+			get { return transportWrites; }
+		}
+
+		bool Coalesce (byte[] buffer, int offset, int count, out byte[] flushBuffer, out int flushSize)
+		{
+			lock (writeLock) {
+				if (pendingSize == 0 && count >= WriteCoalescingThreshold) {
+					flushBuffer = null;
+					flushSize = 0;
+					return false;
+				}
+
+				var size = pendingSize + count;
+				if (pendingWrites == null || pendingWrites.Length < size)
+					Array.Resize (ref pendingWrites, Math.Max (size, WriteCoalescingThreshold));
+				Buffer.BlockCopy (buffer, offset, pendingWrites, pendingSize, count);
+				pendingSize = size;
+				coalescedWrites++;
+
+				if (size < WriteCoalescingThreshold) {
+					StartFlushTimer ();
+					flushBuffer = null;
+					flushSize = 0;
+					return true;
+				}
+
+				TakePendingWrites (out flushBuffer, out flushSize);
+				return false;
+			}
+		}
+
+		void TakePendingWrites (out byte[] flushBuffer, out int flushSize)
+		{
+			flushBuffer = pendingWrites;
+			flushSize = pendingSize;
+			pendingWrites = null;
+			pendingSize = 0;
+
+			if (flushTimer != null) {
+				flushTimer.Dispose ();
+				flushTimer = null;
+			}
+		}
+
+		void StartFlushTimer ()
+		{
+			if (flushTimer != null || WriteCoalescingDelay == null)
+				return;
+			// This constructor passes the timer itself as the callback's state.
+			flushTimer = new Timer (FlushTimerCallback);
+			flushTimer.Change (WriteCoalescingDelay.Value, Timeout.InfiniteTimeSpan);
+		}
+
+		void FlushTimerCallback (object state)
+		{
+			lock (writeLock) {
+				/*
+				 * The data which this timer was started for has already been sent and the
+				 * timer disposed; the callback may still run once, after a new one was started.
+				 */
+				if (state != flushTimer)
+					return;
+				if (asyncWritePending) {
+					// Retry once the in-flight write has completed.
+					flushTimer.Change (WriteCoalescingDelay.Value, Timeout.InfiniteTimeSpan);
+					return;
+				}
+				flushTimer.Dispose ();
+				flushTimer = null;
+			}
+
+			try {
+				FlushPendingWrites ();
+			} catch (Exception ex) {
+				// Nobody is waiting for this write; the next Write() or Flush() reports the error.
+				lock (writeLock)
+					flushError = ex;
+			}
+		}
+
+		void ThrowFlushError ()
+		{
+			Exception error;
+			lock (writeLock) {
+				error = flushError;
+				flushError = null;
+			}
+			if (error != null)
+				ExceptionDispatchInfo.Capture (error).Throw ();
+		}
+
+		/*
+		 * Sends everything that is currently held back in the write-behind buffer.
+		 */
+		public void FlushPendingWrites ()
+		{
+			ThrowFlushError ();
+
+			byte[] flushBuffer;
+			int flushSize;
+			lock (writeLock) {
+				TakePendingWrites (out flushBuffer, out flushSize);
+				if (flushSize == 0)
+					return;
+				transportWrites++;
+				base.Write (flushBuffer, 0, flushSize);
+			}
+		}
+
+		public override void Write (byte[] buffer, int offset, int count)
+		{
+			ThrowFlushError ();
+
+			if (WriteCoalescingThreshold <= 0) {
+				base.Write (buffer, offset, count);
+				return;
+			}
+
+			byte[] flushBuffer;
+			int flushSize;
+			if (Coalesce (buffer, offset, count, out flushBuffer, out flushSize))
+				return;
+
+			lock (writeLock) {
+				transportWrites++;
+				if (flushBuffer != null)
+					base.Write (flushBuffer, 0, flushSize);
+				else
+					base.Write (buffer, offset, count);
+			}
+		}
+
+		public override IAsyncResult BeginWrite (byte[] buffer, int offset, int count, AsyncCallback asyncCallback, object asyncState)
+		{
+			ThrowFlushError ();
+
+			if (WriteCoalescingThreshold <= 0)
+				return base.BeginWrite (buffer, offset, count, asyncCallback, asyncState);
+
+			byte[] flushBuffer;
+			int flushSize;
+			if (Coalesce (buffer, offset, count, out flushBuffer, out flushSize)) {
+				var tcs = new TaskCompletionSource<object> (asyncState);
+				tcs.SetResult (null);
+				if (asyncCallback != null)
+					asyncCallback (tcs.Task);
+				return tcs.Task;
+			}
+
+			lock (writeLock) {
+				asyncWritePending = true;
+				transportWrites++;
+			}
+
+			try {
+				if (flushBuffer != null)
+					return base.BeginWrite (flushBuffer, 0, flushSize, asyncCallback, asyncState);
+				return base.BeginWrite (buffer, offset, count, asyncCallback, asyncState);
+			} catch {
+				lock (writeLock)
+					asyncWritePending = false;
+				throw;
+			}
+		}
+
+		public override void EndWrite (IAsyncResult asyncResult)
+		{
+			var task = asyncResult as Task;
+			if (task != null) {
+				task.GetAwaiter ().GetResult ();
+				return;
+			}
+
+			try {
+				base.EndWrite (asyncResult);
+			} finally {
+				lock (writeLock)
+					asyncWritePending = false;
+			}
+		}
+
+		public override void Flush ()
+		{
+			FlushPendingWrites ();
+			base.Flush ();
+		}
+
+		protected override void Dispose (bool disposing)
+		{
+			if (disposing && pendingSize > 0 && !IsClosed) {
+				try {
+					FlushPendingWrites ();
+				} catch {
+					// Don't let a broken connection prevent the stream from being closed.
+				}
+			}
+
+			base.Dispose (disposing);
+		}
+
 		public Task Shutdown ()
 		{
+			FlushPendingWrites ();
 			return Task.Factory.FromAsync ((state, result) => BeginShutdown (state, result), EndShutdown, null);
 		}
 
@@ -0,0 +1,110 @@
+﻿//
+// RecordBufferPool.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.Collections.Generic;
+
+namespace Mono.Security.NewTls
+{
+	/*
+	 * Output buffers for encoded records, bucketed by power-of-two size classes
+	 * starting at 512 bytes.  Requests which do not fit into the largest class
+	 * are allocated exactly and never pooled.
+	 */
+	class RecordBufferPool
+	{
+		const int MinSizeClassShift = 9;
+		const int SizeClassCount = 10;
+		const int MaxBuffersPerClass = 4;
+
+		readonly Stack<byte[]>[] buckets;
+		readonly TlsConnectionStatistics statistics;
+
+		long allocations;
+		long reuses;
+
+		public RecordBufferPool (TlsConnectionStatistics statistics)
+		{
+			this.statistics = statistics;
+			buckets = new Stack<byte[]> [SizeClassCount];
+			for (int i = 0; i < SizeClassCount; i++)
+				buckets [i] = new Stack<byte[]> (MaxBuffersPerClass);
+		}
+
+		public long Allocations {
+			get { return allocations; }
+		}
+
+		public long Reuses {
+			get { return reuses; }
+		}
+
+		static int GetSizeClass (int size)
+		{
+			var index = 0;
+			while (index < SizeClassCount && (1 << (index + MinSizeClassShift)) < size)
+				index++;
+			return index;
+		}
+
+		public byte[] Rent (int size)
+		{
+			var index = GetSizeClass (size);
+
+			lock (buckets) {
+				if (index < SizeClassCount && buckets [index].Count > 0) {
+					reuses++;
+					return buckets [index].Pop ();
+				}
+				allocations++;
+				if (statistics != null)
+					statistics.BufferAllocated ();
+			}
+
+			return new byte [index < SizeClassCount ? 1 << (index + MinSizeClassShift) : size];
+		}
+
+		public void Return (byte[] buffer)
+		{
+			var index = GetSizeClass (buffer.Length);
+			if (index == SizeClassCount || buffer.Length != 1 << (index + MinSizeClassShift))
+				return;
+
+			lock (buckets) {
+				var bucket = buckets [index];
+				if (bucket.Count < MaxBuffersPerClass)
+					bucket.Push (buffer);
+			}
+		}
+
+		public void Clear ()
+		{
+			lock (buckets) {
+				foreach (var bucket in buckets)
+					bucket.Clear ();
+			}
+		}
+	}
+}
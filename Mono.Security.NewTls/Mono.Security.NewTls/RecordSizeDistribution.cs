@@ -0,0 +1,107 @@
+﻿//
+// RecordSizeDistribution.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.Text;
+
+namespace Mono.Security.NewTls
+{
+	/*
+	 * Counts the application data records a TlsContext has written, bucketed
+	 * by the size of the encrypted record payload.  The first bucket covers
+	 * the records which fit into a single MTU.
+	 */
+	public class RecordSizeDistribution
+	{
+		static readonly int[] bucketLimits = { 1400, 2048, 4096, 8192, int.MaxValue };
+
+		readonly long[] counts = new long [bucketLimits.Length];
+		long totalBytes;
+
+		public int BucketCount {
+			get { return bucketLimits.Length; }
+		}
+
+		/*
+		 * Inclusive upper bound of the given bucket; the last one is unbounded.
+		 */
+		public int GetBucketLimit (int bucket)
+		{
+			return bucketLimits [bucket];
+		}
+
+		public long GetCount (int bucket)
+		{
+			lock (counts)
+				return counts [bucket];
+		}
+
+		public long TotalRecords {
+			get {
+				lock (counts) {
+					long total = 0;
+					for (int i = 0; i < counts.Length; i++)
+						total += counts [i];
+					return total;
+				}
+			}
+		}
+
+		public long TotalBytes {
+			get {
+				lock (counts)
+					return totalBytes;
+			}
+		}
+
+		internal void Add (int size)
+		{
+			var bucket = 0;
+			while (size > bucketLimits [bucket])
+				bucket++;
+
+			lock (counts) {
+				counts [bucket]++;
+				totalBytes += size;
+			}
+		}
+
+		public override string ToString ()
+		{
+			var sb = new StringBuilder ();
+			sb.Append ("[RecordSizeDistribution:");
+			lock (counts) {
+				for (int i = 0; i < counts.Length; i++) {
+					if (bucketLimits [i] == int.MaxValue)
+						sb.AppendFormat (" >{0}={1}", bucketLimits [i - 1], counts [i]);
+					else
+						sb.AppendFormat (" <={0}={1}", bucketLimits [i], counts [i]);
+				}
+			}
+			sb.Append ("]");
+			return sb.ToString ();
+		}
+	}
+}
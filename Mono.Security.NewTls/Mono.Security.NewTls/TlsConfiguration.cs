@@ -1,14 +1,18 @@
 ﻿using System;
+using System.Collections.Generic;
 using System.Net.Security;
 using System.Security.Cryptography;
 using MSI = Mono.Security.Interface;
 using MX = Mono.Security.X509;
 using SSCX = System.Security.Cryptography.X509Certificates;
+using Mono.Security.NewTls.Cipher;
 
 using XITlsConfiguration = Mono.Security.Providers.NewTls.ITlsConfiguration;
 
 namespace Mono.Security.NewTls
 {
+	using Handshake;
+
 	public delegate bool RemoteCertValidationCallback (string host, MX.X509Certificate certificate, MX.X509Chain chain, SslPolicyErrors sslPolicyErrors);
 	public delegate bool ClientCertValidationCallback (ClientCertificateParameters certParams, MX.X509Certificate certificate, MX.X509Chain chain, SslPolicyErrors sslPolicyErrors);
 	public delegate SSCX.X509Certificate LocalCertSelectionCallback (string targetHost, SSCX.X509CertificateCollection localCertificates, SSCX.X509Certificate remoteCertificate, string[] acceptableIssuers);
@@ -72,6 +76,7 @@ namespace Mono.Security.NewTls
 				UserSettings = new UserSettings (settings);
 
 			RenegotiationFlags = DefaultRenegotiationFlags;
+			InitializeRecordSizing ();
 		}
 
 		public TlsConfiguration (MSI.TlsProtocols protocols, MSI.MonoTlsSettings settings, MX.X509Certificate certificate, AsymmetricAlgorithm privateKey)
@@ -88,6 +93,15 @@ namespace Mono.Security.NewTls
 				UserSettings = new UserSettings (settings);
 
 			RenegotiationFlags = DefaultRenegotiationFlags;
+			InitializeRecordSizing ();
+		}
+
+		void InitializeRecordSizing ()
+		{
+			DynamicRecordSizing = true;
+			InitialRecordSize = DefaultInitialRecordSize;
+			DynamicRecordSizeThreshold = DefaultDynamicRecordSizeThreshold;
+			DynamicRecordIdleTimeout = DefaultDynamicRecordIdleTimeout;
 		}
 
 		#region Protocol Versions
@@ -190,9 +204,51 @@ namespace Mono.Security.NewTls
 			get { return Certificate != null && PrivateKey != null; }
 		}
 
+		public AesEngineType AesEngineType {
+			get; set;
+		}
+
+		public GcmMultiplierType GcmMultiplierType {
+			get; set;
+		}
+
+		public GcmNonceType GcmNonceType {
+			get; set;
+		}
+
+		/*
+		 * Application data is sent in small records of at most InitialRecordSize bytes
+		 * (including the cipher overhead) at the start of each burst, so the peer can
+		 * decrypt the first bytes without waiting for a full 16k record.  Once
+		 * DynamicRecordSizeThreshold bytes have been sent, we switch to full-size records
+		 * until the connection has been idle for DynamicRecordIdleTimeout.
+		 */
+		public bool DynamicRecordSizing {
+			get; set;
+		}
+
+		public int InitialRecordSize {
+			get; set;
+		}
+
+		public int DynamicRecordSizeThreshold {
+			get; set;
+		}
+
+		public TimeSpan DynamicRecordIdleTimeout {
+			get; set;
+		}
+
+		internal const int DefaultInitialRecordSize = 1369;
+		internal const int DefaultDynamicRecordSizeThreshold = 64 * 1024;
+		internal static readonly TimeSpan DefaultDynamicRecordIdleTimeout = TimeSpan.FromSeconds (1);
+
 		public void SetCertificate (MX.X509Certificate certificate, AsymmetricAlgorithm privateKey)
 		{
-			Certificate = certificate;
+			lock (encodeLock) {
+				Certificate = certificate;
+				encodedCertificate = null;
+			}
 			#if !BOOTSTRAP_BASIC
 			if (PrivateKey != null && PrivateKey != privateKey)
 				PrivateKey.Dispose ();
@@ -202,10 +258,85 @@ namespace Mono.Security.NewTls
 
 		#endregion
 
+		#region Encoded Handshake Messages
+
+		/*
+		 * The server's Certificate message only depends on its certificate, so we
+		 * encode it once and send the same bytes on every handshake.  The cache is
+		 * tied to the certificate instance and dropped by SetCertificate().
+		 *
+		 * Server contexts which share the configuration may handshake concurrently;
+		 * both caches are protected by encodeLock.
+		 */
+		class EncodedCertificate
+		{
+			public readonly MX.X509Certificate Certificate;
+			public readonly MSI.IBufferOffsetSize Message;
+
+			public EncodedCertificate (MX.X509Certificate certificate, MSI.IBufferOffsetSize message)
+			{
+				Certificate = certificate;
+				Message = message;
+			}
+		}
+
+		readonly object encodeLock = new object ();
+		EncodedCertificate encodedCertificate;
+		Dictionary<string, byte[]> encodedAuthorities;
+		int certificateMessagesEncoded;
+
+		// How often the Certificate message had to be encoded.
+		public int CertificateMessagesEncoded {
+			get {
+				lock (encodeLock)
+					return certificateMessagesEncoded;
+			}
+		}
+
+		internal MSI.IBufferOffsetSize GetEncodedCertificateMessage (MX.X509CertificateCollection certificates)
+		{
+			lock (encodeLock) {
+				var certificate = Certificate;
+				if (certificate == null || certificates.Count != 1 || certificates [0] != certificate)
+					return null;
+
+				if (encodedCertificate != null && encodedCertificate.Certificate == certificate)
+					return encodedCertificate.Message;
+
+				var message = new TlsCertificate (certificates).EncodeMessage ();
+				encodedCertificate = new EncodedCertificate (certificate, message);
+				certificateMessagesEncoded++;
+				return message;
+			}
+		}
+
+		/*
+		 * DER encoding of a certificate authority name for the server's CertificateRequest.
+		 */
+		internal byte[] EncodeCertificateAuthority (string issuer)
+		{
+			lock (encodeLock) {
+				if (encodedAuthorities == null)
+					encodedAuthorities = new Dictionary<string, byte[]> ();
+
+				byte[] bytes;
+				if (!encodedAuthorities.TryGetValue (issuer, out bytes)) {
+					bytes = X501.FromString (issuer).GetBytes ();
+					encodedAuthorities.Add (issuer, bytes);
+				}
+				return bytes;
+			}
+		}
+
+		#endregion
+
 		protected override void Clear ()
 		{
 			PrivateKey = null;
-			Certificate = null;
+			lock (encodeLock) {
+				Certificate = null;
+				encodedCertificate = null;
+			}
 		}
 	}
 }
@@ -0,0 +1,241 @@
+﻿//
+// TlsConnectionStatistics.cs
+//
+// Author:
+//       agent <agent@local>
+//
+// Copyright (c) 2026 agent
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+using System;
+using System.Diagnostics;
+using System.Text;
+using System.Threading;
+
+namespace Mono.Security.NewTls
+{
+	using Negotiation;
+
+	/*
+	 * Counters which a TlsContext keeps about its connection.  These are plain
+	 * increments and Stopwatch timestamps, so they are always compiled in.
+	 *
+	 * Each update is also added to the process-wide totals right away, so they
+	 * include contexts which are still in use or never cleared; Process returns
+	 * a snapshot of those.  Unlike a context's own counters, the totals are shared
+	 * between threads and only updated atomically.
+	 */
+	public class TlsConnectionStatistics
+	{
+		static readonly TlsConnectionStatistics process = new TlsConnectionStatistics (null);
+
+		const int StateCount = (int)NegotiationState.ServerHello + 1;
+
+		// The process-wide totals; null for those and for snapshots.
+		readonly TlsConnectionStatistics totals;
+
+		readonly long[] handshakeStateTicks = new long [StateCount];
+
+		long recordsSent;
+		long recordsReceived;
+		long bytesSent;
+		long bytesReceived;
+		long encryptTicks;
+		long decryptTicks;
+		long handshakeTicks;
+		long handshakes;
+		long renegotiations;
+		long bufferAllocations;
+		long handshakeBytesHashed;
+
+		TlsConnectionStatistics (TlsConnectionStatistics totals)
+		{
+			this.totals = totals;
+		}
+
+		internal static TlsConnectionStatistics CreateConnectionStatistics ()
+		{
+			return new TlsConnectionStatistics (process);
+		}
+
+		public long RecordsSent {
+			get { return recordsSent; }
+		}
+
+		public long RecordsReceived {
+			get { return recordsReceived; }
+		}
+
+		// Including the 5-byte record headers.
+		public long BytesSent {
+			get { return bytesSent; }
+		}
+
+		public long BytesReceived {
+			get { return bytesReceived; }
+		}
+
+		// Record encryption, including the MAC.
+		public TimeSpan EncryptTime {
+			get { return ToTimeSpan (encryptTicks); }
+		}
+
+		// Record decryption, including MAC verification.
+		public TimeSpan DecryptTime {
+			get { return ToTimeSpan (decryptTicks); }
+		}
+
+		// Wall-clock time from the start of each handshake until it finished.
+		public TimeSpan HandshakeTime {
+			get { return ToTimeSpan (handshakeTicks); }
+		}
+
+		public long Handshakes {
+			get { return handshakes; }
+		}
+
+		public long Renegotiations {
+			get { return renegotiations; }
+		}
+
+		// Record buffers which the context's pool had to allocate.
+		public long BufferAllocations {
+			get { return bufferAllocations; }
+		}
+
+		public long HandshakeBytesHashed {
+			get { return handshakeBytesHashed; }
+		}
+
+		/*
+		 * Time spent processing handshake input and generating output while the
+		 * handshake was in the given state.
+		 */
+		public TimeSpan GetHandshakeTime (NegotiationState state)
+		{
+			return ToTimeSpan (handshakeStateTicks [(int)state]);
+		}
+
+		public static TlsConnectionStatistics Process {
+			get {
+				var snapshot = new TlsConnectionStatistics (null);
+				snapshot.Add (process);
+				return snapshot;
+			}
+		}
+
+		static TimeSpan ToTimeSpan (long ticks)
+		{
+			return TimeSpan.FromTicks ((long)(ticks * ((double)TimeSpan.TicksPerSecond / Stopwatch.Frequency)));
+		}
+
+		internal void RecordSent (int size)
+		{
+			recordsSent++;
+			bytesSent += size;
+			if (totals != null) {
+				Interlocked.Increment (ref totals.recordsSent);
+				Interlocked.Add (ref totals.bytesSent, size);
+			}
+		}
+
+		internal void RecordReceived (int size)
+		{
+			recordsReceived++;
+			bytesReceived += size;
+			if (totals != null) {
+				Interlocked.Increment (ref totals.recordsReceived);
+				Interlocked.Add (ref totals.bytesReceived, size);
+			}
+		}
+
+		internal void AddEncryptTime (long ticks)
+		{
+			encryptTicks += ticks;
+			if (totals != null)
+				Interlocked.Add (ref totals.encryptTicks, ticks);
+		}
+
+		internal void AddDecryptTime (long ticks)
+		{
+			decryptTicks += ticks;
+			if (totals != null)
+				Interlocked.Add (ref totals.decryptTicks, ticks);
+		}
+
+		internal void AddHandshakeTime (NegotiationState state, long ticks)
+		{
+			handshakeStateTicks [(int)state] += ticks;
+			if (totals != null)
+				Interlocked.Add (ref totals.handshakeStateTicks [(int)state], ticks);
+		}
+
+		internal void BufferAllocated ()
+		{
+			bufferAllocations++;
+			if (totals != null)
+				Interlocked.Increment (ref totals.bufferAllocations);
+		}
+
+		internal void HandshakeFinished (long ticks, long bytesHashed, bool renegotiation)
+		{
+			handshakes++;
+			if (renegotiation)
+				renegotiations++;
+			handshakeTicks += ticks;
+			handshakeBytesHashed += bytesHashed;
+			if (totals != null) {
+				Interlocked.Increment (ref totals.handshakes);
+				if (renegotiation)
+					Interlocked.Increment (ref totals.renegotiations);
+				Interlocked.Add (ref totals.handshakeTicks, ticks);
+				Interlocked.Add (ref totals.handshakeBytesHashed, bytesHashed);
+			}
+		}
+
+		// Only used for snapshots of the totals, which may change while we read them.
+		internal void Add (TlsConnectionStatistics other)
+		{
+			recordsSent += Interlocked.Read (ref other.recordsSent);
+			recordsReceived += Interlocked.Read (ref other.recordsReceived);
+			bytesSent += Interlocked.Read (ref other.bytesSent);
+			bytesReceived += Interlocked.Read (ref other.bytesReceived);
+			encryptTicks += Interlocked.Read (ref other.encryptTicks);
+			decryptTicks += Interlocked.Read (ref other.decryptTicks);
+			handshakeTicks += Interlocked.Read (ref other.handshakeTicks);
+			handshakes += Interlocked.Read (ref other.handshakes);
+			renegotiations += Interlocked.Read (ref other.renegotiations);
+			bufferAllocations += Interlocked.Read (ref other.bufferAllocations);
+			handshakeBytesHashed += Interlocked.Read (ref other.handshakeBytesHashed);
+			for (int i = 0; i < StateCount; i++)
+				handshakeStateTicks [i] += Interlocked.Read (ref other.handshakeStateTicks [i]);
+		}
+
+		public override string ToString ()
+		{
+			var sb = new StringBuilder ();
+			sb.AppendFormat ("[TlsConnectionStatistics: RecordsSent={0}, BytesSent={1}, RecordsReceived={2}, BytesReceived={3}",
+				recordsSent, bytesSent, recordsReceived, bytesReceived);
+			sb.AppendFormat (", EncryptTime={0}, DecryptTime={1}, Handshakes={2}, HandshakeTime={3}, Renegotiations={4}",
+				EncryptTime, DecryptTime, handshakes, HandshakeTime, renegotiations);
+			sb.AppendFormat (", BufferAllocations={0}, HandshakeBytesHashed={1}]", bufferAllocations, handshakeBytesHashed);
+			return sb.ToString ();
+		}
+	}
+}
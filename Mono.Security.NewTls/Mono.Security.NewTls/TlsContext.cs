@@ -1,6 +1,7 @@
 ﻿using System;
 using System.Net;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Net.Security;
 using System.Security.Cryptography;
 using Mono.Security.Interface;
@@ -44,10 +45,24 @@ namespace Mono.Security.NewTls
 
 		MonoTlsConnectionInfo connectionInfo;
 
-		TlsBuffer cachedFragment;
 		int skipToOffset = -1;
+		bool retryReassembled;
+
+		readonly TlsConnectionStatistics statistics = TlsConnectionStatistics.CreateConnectionStatistics ();
+		readonly RecordBufferPool recordBufferPool;
+		readonly HandshakeReassemblyBuffer handshakeReassembly;
+		byte[] recordBuffer;
+		Func<DateTime> clock;
+
+		readonly RecordSizeDistribution recordSizeDistribution = new RecordSizeDistribution ();
+		long burstBytes;
+		DateTime lastRecordTime;
+
+		long handshakeStart;
+		bool renegotiating;
 
 		internal const short MAX_FRAGMENT_SIZE	= 16384; // 2^14
+		internal const short MIN_DYNAMIC_RECORD_SIZE	= 512;
 
 		public bool IsServer {
 			get { return isServer; }
@@ -79,6 +94,25 @@ namespace Mono.Security.NewTls
 			private set;
 		}
 
+		// Number of bytes fed into transcript hashes during the last completed handshake.
+		public long HandshakeBytesHashed {
+			get;
+			private set;
+		}
+
+		/*
+		 * Size of the last completed handshake's transcript; HandshakeBytesHashed is
+		 * this times the number of hash algorithms which were actually needed.
+		 */
+		public long HandshakeTranscriptLength {
+			get;
+			private set;
+		}
+
+		public TlsConnectionStatistics Statistics {
+			get { return statistics; }
+		}
+
 		public bool ReceivedCloseNotify {
 			get;
 			private set;
@@ -116,6 +150,9 @@ namespace Mono.Security.NewTls
 			this.isServer = isServer;
 			this.eventSink = eventSink;
 
+			recordBufferPool = new RecordBufferPool (statistics);
+			handshakeReassembly = new HandshakeReassemblyBuffer (recordBufferPool);
+
 			#if INSTRUMENTATION
 			var instrumentation = configuration.UserSettings.Instrumentation;
 			if (instrumentation != null) {
@@ -147,6 +184,24 @@ namespace Mono.Security.NewTls
 			settingsProvider.Initialize (this);
 		}
 
+		/*
+		 * Replaces the random number generator and the clock which the handshake draws from,
+		 * so that it can be reproduced exactly, for instance to replay a captured handshake.
+		 * Must be called before the first GenerateNextToken(); takes ownership of `rng'.
+		 */
+		public void SetHandshakeSources (RandomNumberGenerator rng, Func<DateTime> clock)
+		{
+			if (HandshakeParameters != null)
+				throw new InvalidOperationException ();
+
+			Session.RandomNumberGenerator = rng;
+			this.clock = clock;
+		}
+
+		internal DateTime UtcNow {
+			get { return clock != null ? clock () : DateTime.UtcNow; }
+		}
+
 		#if INSTRUMENTATION
 
 		internal bool HasInstrument (HandshakeInstrumentType type)
@@ -210,6 +265,10 @@ namespace Mono.Security.NewTls
 				session.Dispose ();
 				session = null;
 			}
+			recordBuffer = null;
+			handshakeReassembly.Clear ();
+			retryReassembled = false;
+			recordBufferPool.Clear ();
 		}
 
 		#region Protocol Versions
@@ -328,7 +387,11 @@ namespace Mono.Security.NewTls
 		{
 			try {
 				CheckValid ();
-				return _GenerateNextToken (incoming, outgoing);
+				var state = negotiationHandler.State;
+				var start = Stopwatch.GetTimestamp ();
+				var status = _GenerateNextToken (incoming, outgoing);
+				statistics.AddHandshakeTime (state, Stopwatch.GetTimestamp () - start);
+				return status;
 			} catch (TlsException ex) {
 				var alert = OnError (ex);
 				if (alert != null)
@@ -369,24 +432,37 @@ namespace Mono.Security.NewTls
 				return ProcessAlert (incoming);
 
 			bool decrypted = false;
-			if (cachedFragment != null) {
+			bool reassembled = false;
+			int plaintextStart = -1;
+			if (retryReassembled) {
+				/*
+				 * We were asked for credentials while processing reassembled or decrypted
+				 * messages; those are still in our buffer and the record which the caller
+				 * passes again has already been consumed.
+				 */
+				if (contentType != ContentType.Handshake)
+					throw new TlsException (AlertDescription.DecodeError);
+				retryReassembled = false;
+				incoming = handshakeReassembly.Take ();
+				reassembled = true;
+			} else if (!handshakeReassembly.IsEmpty) {
 				if (contentType != ContentType.Handshake)
 					throw new TlsException (AlertDescription.DecodeError);
 				decrypted = ReadStandardBuffer (ContentType.Handshake, ref incoming);
-				cachedFragment.Write (incoming.Buffer, incoming.Position, incoming.Remaining);
-				if (cachedFragment.Remaining > 0)
+				CheckDecrypted (decrypted);
+				handshakeReassembly.Append (incoming.Buffer, incoming.Position, incoming.Remaining);
+				if (decrypted)
+					incoming.Dispose ();
+				if (!handshakeReassembly.HasCompleteMessage)
 					return SecurityStatus.ContinueNeeded;
-				incoming.Dispose ();
-				incoming = cachedFragment;
-				cachedFragment = null;
-				incoming.Position = 0;
+				incoming = handshakeReassembly.Take ();
+				reassembled = true;
 			} else {
 				decrypted = ReadStandardBuffer (contentType, ref incoming);
+				CheckDecrypted (decrypted);
+				plaintextStart = incoming.Position;
 			}
 
-			if (Session.Read != null && Session.Read.Cipher != null && !decrypted)
-				throw new TlsException (AlertDescription.DecryptError, "Expected encrypted message.");
-
 			try {
 				if (contentType == ContentType.ChangeCipherSpec)
 					return negotiationHandler.ProcessMessage (new TlsChangeCipherSpec ());
@@ -414,8 +490,19 @@ namespace Mono.Security.NewTls
 					if (result == SecurityStatus.CredentialsNeeded) {
 						// Caller will call us again with the same input.
 						skipToOffset = startOffset;
-						if (decrypted)
-							Session.Read.ReadSequenceNumber--;
+						if (reassembled) {
+							handshakeReassembly.Restore ();
+							retryReassembled = true;
+						} else if (decrypted) {
+							/*
+							 * The record has been decrypted in place, so the caller's copy can't
+							 * be decrypted again; keep the plaintext for the retry instead.
+							 */
+							incoming.Position = plaintextStart;
+							handshakeReassembly.Retain (incoming.Buffer, plaintextStart, incoming.Remaining);
+							skipToOffset = startOffset - plaintextStart;
+							retryReassembled = true;
+						}
 						return result;
 					}
 					if (incoming.Remaining == 0)
@@ -429,11 +516,17 @@ namespace Mono.Security.NewTls
 
 				return result;
 			} finally {
-				if (decrypted)
+				if (decrypted && !reassembled)
 					incoming.Dispose ();
 			}
 		}
 
+		void CheckDecrypted (bool decrypted)
+		{
+			if (Session.Read != null && Session.Read.Cipher != null && !decrypted)
+				throw new TlsException (AlertDescription.DecryptError, "Expected encrypted message.");
+		}
+
 		SecurityStatus ProcessAlert (TlsBuffer buffer)
 		{
 			bool decrypted = false;
@@ -464,6 +557,17 @@ namespace Mono.Security.NewTls
 
 		bool ProcessHandshakeMessage (TlsBuffer incoming, out SecurityStatus status)
 		{
+			/*
+			 * The message - or even its header - continues in the next record; keep
+			 * what we have and decode it once it's complete.
+			 */
+			if (!HasCompleteHandshakeMessage (incoming)) {
+				handshakeReassembly.Retain (incoming.Buffer, incoming.Position, incoming.Remaining);
+				incoming.Position += incoming.Remaining;
+				status = SecurityStatus.ContinueNeeded;
+				return false;
+			}
+
 			var handshakeType = (HandshakeType)incoming.ReadByte ();
 			#if DEBUG_FULL
 			if (EnableDebugging) {
@@ -474,21 +578,31 @@ namespace Mono.Security.NewTls
 
 			// Read message length
 			int length = incoming.ReadInt24 ();
-			if (incoming.Remaining < length) {
-				cachedFragment = new TlsBuffer (length + 4);
-				cachedFragment.Position = incoming.Remaining + 4;
-				Buffer.BlockCopy (incoming.Buffer, incoming.Position - 4, cachedFragment.Buffer, 0, cachedFragment.Position);
-				incoming.Position += incoming.Remaining;
-				status = SecurityStatus.ContinueNeeded;
-				return false;
-			}
-
 			var buffer = incoming.ReadBuffer (length);
 			return negotiationHandler.ProcessHandshakeMessage (handshakeType, buffer, out status);
 		}
 
+		static bool HasCompleteHandshakeMessage (TlsBuffer incoming)
+		{
+			if (incoming.Remaining < 4)
+				return false;
+			var position = incoming.Position;
+			var length = (incoming.Buffer [position + 1] << 16) | (incoming.Buffer [position + 2] << 8) | incoming.Buffer [position + 3];
+			return incoming.Remaining - 4 >= length;
+		}
+
 		internal NegotiationHandler CreateNegotiationHandler (NegotiationState state)
 		{
+			switch (state) {
+			case NegotiationState.InitialClientConnection:
+			case NegotiationState.InitialServerConnection:
+			case NegotiationState.RenegotiatingClientConnection:
+			case NegotiationState.RenegotiatingServerConnection:
+				handshakeStart = Stopwatch.GetTimestamp ();
+				renegotiating = state == NegotiationState.RenegotiatingClientConnection || state == NegotiationState.RenegotiatingServerConnection;
+				break;
+			}
+
 			switch (state) {
 			case NegotiationState.InitialClientConnection:
 				return new ClientConnection (this, false);
@@ -511,6 +625,9 @@ namespace Mono.Security.NewTls
 
 		internal void FinishHandshake ()
 		{
+			HandshakeBytesHashed = HandshakeParameters.HandshakeMessages.BytesHashed;
+			HandshakeTranscriptLength = HandshakeParameters.HandshakeMessages.TranscriptLength;
+			statistics.HandshakeFinished (Stopwatch.GetTimestamp () - handshakeStart, HandshakeBytesHashed, renegotiating);
 			HandshakeParameters.Dispose ();
 			HandshakeParameters = null;
 
@@ -618,6 +735,12 @@ namespace Mono.Security.NewTls
 			return (int)EncryptMessage (ref incoming);
 		}
 
+		/*
+		 * Encrypts the remaining data of `incoming' into application data records and
+		 * replaces it with a view of them.  That view points into a pooled buffer, which
+		 * is only valid until the next call to EncryptMessage() or Clear(); callers must
+		 * copy or send the records before they encrypt the next message.
+		 */
 		public SecurityStatus EncryptMessage (ref TlsBuffer incoming)
 		{
 			try {
@@ -644,7 +767,49 @@ namespace Mono.Security.NewTls
 			DebugHelper.WriteRemaining ("EncryptMessage", incoming);
 			#endif
 
-			var buffer = EncodeRecord (ContentType.ApplicationData, incoming.GetRemaining ());
+			int fragmentSize = MAX_FRAGMENT_SIZE;
+			#if INSTRUMENTATION
+			if (HasInstrument (HandshakeInstrumentType.FragmentHandshakeMessages))
+				fragmentSize = 512;
+			#endif
+
+			var protocol = HasNegotiatedProtocol ? NegotiatedProtocol : Configuration.RequestedProtocol;
+			var crypto = Session != null ? Session.Write : null;
+			var data = incoming.GetRemaining ();
+
+			var smallBytes = GetSmallRecordBytes (data.Size);
+			var smallFragmentSize = Math.Min (fragmentSize, Math.Max (Configuration.InitialRecordSize, MIN_DYNAMIC_RECORD_SIZE));
+			var small = new BufferOffsetSize (data.Buffer, data.Offset, smallBytes);
+			var rest = new BufferOffsetSize (data.Buffer, data.Offset + smallBytes, data.Size - smallBytes);
+
+			var size = 0;
+			if (small.Size > 0)
+				size += GetEncodedSize (crypto, small.Size, smallFragmentSize);
+			if (rest.Size > 0 || small.Size == 0)
+				size += GetEncodedSize (crypto, rest.Size, fragmentSize);
+
+			/*
+			 * The caller copies the encrypted data out before it asks us to encrypt
+			 * the next message, so the previous record buffer can go back to the pool
+			 * and we encrypt straight into a pooled one, without any intermediate copy.
+			 */
+			if (recordBuffer != null)
+				recordBufferPool.Return (recordBuffer);
+			recordBuffer = recordBufferPool.Rent (size);
+
+			var start = Stopwatch.GetTimestamp ();
+			var length = 0;
+			if (small.Size > 0)
+				length += EncodeRecord_internal (protocol, ContentType.ApplicationData, crypto, small, recordBuffer, 0, smallFragmentSize);
+			if (rest.Size > 0 || small.Size == 0)
+				length += EncodeRecord_internal (protocol, ContentType.ApplicationData, crypto, rest, recordBuffer, length, fragmentSize);
+			if (length != size)
+				throw new TlsException (AlertDescription.InternalError);
+
+			statistics.AddEncryptTime (Stopwatch.GetTimestamp () - start);
+
+			var buffer = new BufferOffsetSize (recordBuffer, 0, length);
+			CountRecords (recordBuffer, 0, length, true);
 
 			#if DEBUG_FULL
 			if (EnableDebugging)
@@ -655,6 +820,61 @@ namespace Mono.Security.NewTls
 			return SecurityStatus.OK;
 		}
 
+		/*
+		 * Returns how many of the next @size bytes of application data should be sent
+		 * in small records.  Each burst starts with small records, which lets the peer
+		 * start decrypting after the first round-trip; once DynamicRecordSizeThreshold
+		 * bytes have been written without going idle, we switch to full-size records.
+		 */
+		int GetSmallRecordBytes (int size)
+		{
+			if (!Configuration.DynamicRecordSizing)
+				return 0;
+
+			var now = UtcNow;
+			if (now - lastRecordTime > Configuration.DynamicRecordIdleTimeout)
+				burstBytes = 0;
+			lastRecordTime = now;
+
+			var threshold = Configuration.DynamicRecordSizeThreshold;
+			var smallBytes = burstBytes < threshold ? (int)Math.Min (size, threshold - burstBytes) : 0;
+			burstBytes = Math.Min (burstBytes + size, threshold);
+			return smallBytes;
+		}
+
+		void CountRecords (byte[] buffer, int offset, int size, bool applicationData)
+		{
+			var end = offset + size;
+			while (offset + 5 <= end) {
+				var length = (buffer [offset + 3] << 8) | buffer [offset + 4];
+				statistics.RecordSent (5 + length);
+				if (applicationData)
+					recordSizeDistribution.Add (length);
+				offset += 5 + length;
+			}
+		}
+
+		public RecordSizeDistribution RecordSizeDistribution {
+			get { return recordSizeDistribution; }
+		}
+
+		/*
+		 * The record buffer pool is shared by EncryptMessage() and handshake reassembly,
+		 * so these count the buffers of both; HandshakeReassemblyBuffers tells how many
+		 * of them went to the latter.
+		 */
+		public long RecordBufferAllocations {
+			get { return recordBufferPool.Allocations; }
+		}
+
+		public long RecordBufferReuses {
+			get { return recordBufferPool.Reuses; }
+		}
+
+		public long HandshakeReassemblyBuffers {
+			get { return handshakeReassembly.Rents; }
+		}
+
 		#endregion
 
 		#region Encoding
@@ -713,12 +933,15 @@ namespace Mono.Security.NewTls
 			CheckValid ();
 			var protocol = HasNegotiatedProtocol ? NegotiatedProtocol : Configuration.RequestedProtocol;
 
-			var output = new TlsStream ();
-			EncodeRecord_internal (protocol, contentType, Session != null ? Session.Write : null, buffer, output, fragmentSize);
-			output.Finish ();
+			var crypto = Session != null ? Session.Write : null;
 
-			var result = new byte [output.Size];
-			Buffer.BlockCopy (output.Buffer, output.Offset, result, 0, output.Size);
+			var result = new byte [GetEncodedSize (crypto, buffer.Size, fragmentSize)];
+			var start = Stopwatch.GetTimestamp ();
+			var length = EncodeRecord_internal (protocol, contentType, crypto, buffer, result, 0, fragmentSize);
+			statistics.AddEncryptTime (Stopwatch.GetTimestamp () - start);
+			if (length != result.Length)
+				throw new TlsException (AlertDescription.InternalError);
+			CountRecords (result, 0, length, false);
 			return result;
 		}
 
@@ -729,15 +952,47 @@ namespace Mono.Security.NewTls
 
 		static void EncodeRecord_internal (TlsProtocolCode protocol, ContentType contentType, CryptoParameters crypto, IBufferOffsetSize buffer, TlsStream output,
 			int fragmentSize = MAX_FRAGMENT_SIZE)
+		{
+			output.MakeRoom (GetEncodedSize (crypto, buffer.Size, fragmentSize));
+			output.Position += EncodeRecord_internal (protocol, contentType, crypto, buffer, output.Buffer, output.Position, fragmentSize);
+		}
+
+		static int GetEncodedSize (CryptoParameters crypto, int size, int fragmentSize)
+		{
+			var maxExtraBytes = crypto != null ? crypto.MaxExtraEncryptedBytes : 0;
+			var total = 0;
+
+			// Callers may only ask for smaller records than the protocol allows.
+			if (fragmentSize <= maxExtraBytes || fragmentSize > MAX_FRAGMENT_SIZE)
+				throw new TlsException (AlertDescription.InternalError);
+
+			do {
+				var fragment = size;
+				var encryptedSize = crypto != null ? crypto.GetEncryptedSize (fragment) : fragment;
+				if (encryptedSize > fragmentSize) {
+					fragment = fragmentSize - maxExtraBytes;
+					encryptedSize = crypto != null ? crypto.GetEncryptedSize (fragment) : fragment;
+				}
+
+				total += 5 + encryptedSize;
+				size -= fragment;
+			} while (size > 0);
+
+			return total;
+		}
+
+		/*
+		 * Encodes the records into @output, which must have room for GetEncodedSize() bytes,
+		 * and returns the number of bytes written.
+		 */
+		static int EncodeRecord_internal (TlsProtocolCode protocol, ContentType contentType, CryptoParameters crypto, IBufferOffsetSize buffer,
+			byte[] output, int outputOffset, int fragmentSize)
 		{
 			var maxExtraBytes = crypto != null ? crypto.MaxExtraEncryptedBytes : 0;
 
 			var offset = buffer.Offset;
 			var remaining = buffer.Size;
-
-			#if !INSTRUMENTATION
-			fragmentSize = MAX_FRAGMENT_SIZE;
-			#endif
+			var position = outputOffset;
 
 			do {
 				BufferOffsetSize fragment;
@@ -751,21 +1006,25 @@ namespace Mono.Security.NewTls
 				}
 
 				// Write tls message
-				output.Write ((byte)contentType);
-				output.Write ((short)protocol);
-				output.Write ((short)encryptedSize);
+				output [position++] = (byte)contentType;
+				output [position++] = (byte)((short)protocol >> 8);
+				output [position++] = (byte)protocol;
+				output [position++] = (byte)(encryptedSize >> 8);
+				output [position++] = (byte)encryptedSize;
 
 				if (crypto != null) {
-					output.MakeRoom (encryptedSize);
-					var ret = crypto.Encrypt (contentType, fragment, output.GetRemaining ());
-					output.Position += ret;
+					var ret = crypto.Encrypt (contentType, fragment, new BufferOffsetSize (output, position, encryptedSize));
+					position += ret;
 				} else {
-					output.Write (fragment.Buffer, fragment.Offset, fragment.Size);
+					Buffer.BlockCopy (fragment.Buffer, fragment.Offset, output, position, fragment.Size);
+					position += fragment.Size;
 				}
 
 				offset += fragment.Size;
 				remaining -= fragment.Size;
 			} while (remaining > 0);
+
+			return position - outputOffset;
 		}
 
 		bool ReadStandardBuffer (ContentType contentType, ref TlsBuffer buffer)
@@ -797,6 +1056,7 @@ namespace Mono.Security.NewTls
 				throw new TlsException (
 					AlertDescription.DecodeError, "Invalid buffer size");
 
+			statistics.RecordReceived (5 + length);
 			return DecryptRecordFragment (contentType, ref buffer);
 		}
 
@@ -806,7 +1066,10 @@ namespace Mono.Security.NewTls
 			if (read == null || read.Cipher == null)
 				return false;
 
-			var output = read.Decrypt (contentType, buffer.GetRemaining ());
+			// The record is decrypted within the caller's buffer; we only hand back a view of the plaintext.
+			var start = Stopwatch.GetTimestamp ();
+			var output = read.DecryptInPlace (contentType, buffer.GetRemaining ());
+			statistics.AddDecryptTime (Stopwatch.GetTimestamp () - start);
 			buffer = new TlsBuffer (output);
 			return true;
 		}
@@ -8,72 +8,356 @@
 
 #include <NativeOpenSsl.h>
 #include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
+#include <netdb.h>
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
 #include <openssl/conf.h>
 #include <openssl/err.h>
 #include <openssl/pkcs12.h>
 #include <openssl/dh.h>
+#include <openssl/hmac.h>
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#include <linux/tls.h>
+#define HAVE_KERNEL_TLS 1
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#endif
+
+static long long
+get_time_usec (void)
+{
+	struct timespec ts;
+
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/*
+ * Counting allocator hooks: every OpenSSL allocation gets a small header which
+ * records the connection it was made on behalf of (the one whose SSL_*() call is
+ * currently running on this thread), so it is also accounted to that connection
+ * when it is freed from somewhere else.
+ */
+
+#define MEMORY_HEADER_SIZE	16
+
+typedef struct {
+	NativeOpenSslMemoryStats *stats;
+	size_t size;
+} MemoryHeader;
+
+static __thread NativeOpenSslMemoryStats *memory_current;
+static int memory_hooks_installed;
+
+static void
+memory_account (NativeOpenSslMemoryStats *stats, long long delta, int allocation)
+{
+	long long live, peak;
+
+	live = __sync_add_and_fetch (&stats->live_bytes, delta);
+	while ((peak = stats->peak_bytes) < live && !__sync_bool_compare_and_swap (&stats->peak_bytes, peak, live))
+		;
+
+	if (!allocation)
+		return;
+
+	__sync_add_and_fetch (&stats->allocations, 1);
+	if (stats->in_handshake) {
+		__sync_add_and_fetch (&stats->handshake_allocations, 1);
+		__sync_add_and_fetch (&stats->handshake_bytes, delta);
+	}
+}
+
+static void
+memory_release_stats (NativeOpenSslMemoryStats *stats)
+{
+	if (__sync_sub_and_fetch (&stats->refcount, 1) == 0)
+		free (stats);
+}
+
+static void *
+memory_malloc (size_t size)
+{
+	MemoryHeader *header;
+
+	header = malloc (size + MEMORY_HEADER_SIZE);
+	if (!header)
+		return NULL;
+
+	header->stats = memory_current;
+	header->size = size;
+	if (header->stats) {
+		__sync_add_and_fetch (&header->stats->refcount, 1);
+		memory_account (header->stats, size, 1);
+	}
+
+	return (char *)header + MEMORY_HEADER_SIZE;
+}
+
+static void *
+memory_realloc (void *ptr, size_t size)
+{
+	MemoryHeader *header;
+	size_t old_size;
+
+	if (!ptr)
+		return memory_malloc (size);
+
+	header = (MemoryHeader *)((char *)ptr - MEMORY_HEADER_SIZE);
+	old_size = header->size;
+
+	header = realloc (header, size + MEMORY_HEADER_SIZE);
+	if (!header)
+		return NULL;
+
+	header->size = size;
+	if (header->stats)
+		memory_account (header->stats, (long long)size - (long long)old_size, 0);
+
+	return (char *)header + MEMORY_HEADER_SIZE;
+}
+
+static void
+memory_free (void *ptr)
+{
+	MemoryHeader *header;
+
+	if (!ptr)
+		return;
+
+	header = (MemoryHeader *)((char *)ptr - MEMORY_HEADER_SIZE);
+	if (header->stats) {
+		memory_account (header->stats, -(long long)header->size, 0);
+		memory_release_stats (header->stats);
+	}
+
+	free (header);
+}
+
+/*
+ * OpenSSL only accepts the hooks before it has made its first allocation, so this
+ * must be called before the first native_openssl_initialize().
+ */
+int
+native_openssl_install_memory_hooks (void)
+{
+	if (!memory_hooks_installed)
+		memory_hooks_installed = CRYPTO_set_mem_functions (memory_malloc, memory_realloc, memory_free);
+	return memory_hooks_installed;
+}
+
+static NativeOpenSslMemoryStats *
+memory_enter (NativeOpenSsl *ptr, int handshake)
+{
+	NativeOpenSslMemoryStats *saved = memory_current;
+
+	memory_current = ptr->memory_stats;
+	if (ptr->memory_stats && handshake)
+		ptr->memory_stats->in_handshake = 1;
+	return saved;
+}
+
+static void
+memory_leave (NativeOpenSsl *ptr, NativeOpenSslMemoryStats *saved)
+{
+	if (ptr->memory_stats)
+		ptr->memory_stats->in_handshake = 0;
+	memory_current = saved;
+}
+
+int
+native_openssl_get_memory_stats (NativeOpenSsl *ptr, long long *live_bytes, long long *peak_bytes,
+				 long long *allocations, long long *handshake_allocations, long long *handshake_bytes)
+{
+	NativeOpenSslMemoryStats *stats = ptr->memory_stats;
+
+	if (!stats)
+		return 0;
+
+	*live_bytes = stats->live_bytes;
+	*peak_bytes = stats->peak_bytes;
+	*allocations = stats->allocations;
+	*handshake_allocations = stats->handshake_allocations;
+	*handshake_bytes = stats->handshake_bytes;
+	return 1;
+}
+
+/*
+ * Lean mode: OpenSSL frees the read and write buffers of a connection whenever they
+ * are empty, so an idle connection doesn't hold on to them.
+ */
+void
+native_openssl_set_lean_mode (NativeOpenSsl *ptr, int enable)
+{
+	ptr->lean_mode = enable;
+
+	if (ptr->ctx) {
+		if (enable)
+			SSL_CTX_set_mode (ptr->ctx, SSL_MODE_RELEASE_BUFFERS);
+		else
+			SSL_CTX_clear_mode (ptr->ctx, SSL_MODE_RELEASE_BUFFERS);
+	}
+
+	if (ptr->ssl) {
+		if (enable)
+			SSL_set_mode (ptr->ssl, SSL_MODE_RELEASE_BUFFERS);
+		else
+			SSL_clear_mode (ptr->ssl, SSL_MODE_RELEASE_BUFFERS);
+	}
+}
+
+/*
+ * Options which must be set before connect() / listen(): the buffer sizes
+ * determine the advertised window scale and fast open needs to be enabled
+ * before the SYN is sent / received.
+ */
+static void
+apply_socket_options (NativeOpenSsl *ptr, int s, int listening)
+{
+	int value;
+
+	if (ptr->send_buffer > 0)
+		setsockopt (s, SOL_SOCKET, SO_SNDBUF, &ptr->send_buffer, sizeof (ptr->send_buffer));
+	if (ptr->receive_buffer > 0)
+		setsockopt (s, SOL_SOCKET, SO_RCVBUF, &ptr->receive_buffer, sizeof (ptr->receive_buffer));
+
+	if (ptr->socket_flags & NATIVE_OPENSSL_SOCKET_FASTOPEN) {
+		if (listening) {
+#ifdef TCP_FASTOPEN
+			value = ptr->backlog;
+			if (setsockopt (s, IPPROTO_TCP, TCP_FASTOPEN, &value, sizeof (value)) == 0)
+				ptr->applied_socket_flags |= NATIVE_OPENSSL_SOCKET_FASTOPEN;
+#endif
+		} else {
+#ifdef TCP_FASTOPEN_CONNECT
+			value = 1;
+			if (setsockopt (s, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, &value, sizeof (value)) == 0)
+				ptr->applied_socket_flags |= NATIVE_OPENSSL_SOCKET_FASTOPEN;
+#endif
+		}
+	}
+}
+
+/*
+ * Options for the connected socket, set right before the handshake starts.
+ * TCP_QUICKACK is not sticky - the kernel drops back to delayed ACKs on its
+ * own - so socket_bio_callback() re-arms it before every handshake read.
+ */
+static void
+apply_connected_socket_options (NativeOpenSsl *ptr, int s)
+{
+	int value = 1;
+
+	if (ptr->socket_flags & NATIVE_OPENSSL_SOCKET_NODELAY) {
+		if (setsockopt (s, IPPROTO_TCP, TCP_NODELAY, &value, sizeof (value)) == 0)
+			ptr->applied_socket_flags |= NATIVE_OPENSSL_SOCKET_NODELAY;
+	}
+
+	if (ptr->socket_flags & NATIVE_OPENSSL_SOCKET_QUICKACK) {
+#ifdef TCP_QUICKACK
+		if (setsockopt (s, IPPROTO_TCP, TCP_QUICKACK, &value, sizeof (value)) == 0)
+			ptr->applied_socket_flags |= NATIVE_OPENSSL_SOCKET_QUICKACK;
+#endif
+	}
+}
 
 static int
-init_client (unsigned char ip[4], int port)
+init_client (NativeOpenSsl *ptr, const char *host, int port)
 {
-	int s, ret;
-	struct sockaddr_in addr;
-	unsigned long ipaddr;
+	struct addrinfo hints, *res, *ai;
+	char service [16];
+	int s = -1;
 
-	s = socket (AF_INET, SOCK_STREAM, IPPROTO_TCP);
-	if (s < 0)
-		return -1;
-	
-	memset ((char*)&addr, 0, sizeof (addr));
-	addr.sin_port = htons (port);
-	addr.sin_family = AF_INET;
-	ipaddr = (unsigned long)
-	((unsigned long)ip[0]<<24L)|((unsigned long)ip[1]<<16L)|
-	((unsigned long)ip[2]<< 8L)|((unsigned long)ip[3]);
-	addr.sin_addr.s_addr = htonl(ipaddr);
-	
-	ret = connect (s, (struct sockaddr *)&addr, sizeof (addr));
-	if (ret < 0)
+	memset (&hints, 0, sizeof (hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+	snprintf (service, sizeof (service), "%d", port);
+
+	if (getaddrinfo (host, service, &hints, &res) != 0)
 		return -1;
-	
+
+	for (ai = res; ai; ai = ai->ai_next) {
+		s = socket (ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+		if (s < 0)
+			continue;
+
+		apply_socket_options (ptr, s, 0);
+
+		if (connect (s, ai->ai_addr, ai->ai_addrlen) == 0)
+			break;
+
+		close (s);
+		s = -1;
+	}
+
+	freeaddrinfo (res);
 	return s;
 }
 
 static int
-init_server (unsigned char ip[4], int port)
+init_server (NativeOpenSsl *ptr, const char *host, int port)
 {
-	int s, ret;
-	struct sockaddr_in addr;
-	unsigned long ipaddr;
+	struct addrinfo hints, *res, *ai;
+	char service [16];
 	int value = 1;
-	
-	s = socket (AF_INET, SOCK_STREAM, IPPROTO_TCP);
-	if (s < 0)
-		return -1;
-	
-	setsockopt (s, SOL_SOCKET, SO_REUSEADDR, &value, sizeof(value));
-	
-	memset ((char*)&addr, 0, sizeof (addr));
-	addr.sin_port = htons (port);
-	addr.sin_family = AF_INET;
-	ipaddr = (unsigned long)
-	((unsigned long)ip[0]<<24L)|((unsigned long)ip[1]<<16L)|
-	((unsigned long)ip[2]<< 8L)|((unsigned long)ip[3]);
-	addr.sin_addr.s_addr = htonl (ipaddr);
-	
-	ret = bind (s, (struct sockaddr *)&addr, sizeof (addr));
-	if (ret < 0)
-		return -1;
-	
-	ret = listen (s, 1);
-	if (ret < 0)
+	int s = -1;
+
+	memset (&hints, 0, sizeof (hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+	hints.ai_flags = AI_PASSIVE;
+	snprintf (service, sizeof (service), "%d", port);
+
+	if (getaddrinfo (host, service, &hints, &res) != 0)
 		return -1;
-	
+
+	for (ai = res; ai; ai = ai->ai_next) {
+		s = socket (ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+		if (s < 0)
+			continue;
+
+		setsockopt (s, SOL_SOCKET, SO_REUSEADDR, &value, sizeof (value));
+
+		if (ptr->reuse_port) {
+#ifdef SO_REUSEPORT
+			if (setsockopt (s, SOL_SOCKET, SO_REUSEPORT, &value, sizeof (value)) < 0) {
+				close (s);
+				s = -1;
+				continue;
+			}
+#else
+			close (s);
+			s = -1;
+			errno = ENOPROTOOPT;
+			break;
+#endif
+		}
+
+		apply_socket_options (ptr, s, 1);
+
+		if (bind (s, ai->ai_addr, ai->ai_addrlen) == 0 && listen (s, ptr->backlog) == 0)
+			break;
+
+		close (s);
+		s = -1;
+	}
+
+	freeaddrinfo (res);
 	return s;
 }
 
@@ -116,6 +400,9 @@ native_openssl_set_dh_params (NativeOpenSsl *ptr, const unsigned char *p, int p_
 	if (!dh->p || !dh->g)
 		return -1;
 
+	// A reset connection gets its parameters again.
+	if (ptr->dh_params)
+		DH_free (ptr->dh_params);
 	ptr->dh_params = dh;
 	return 0;
 }
@@ -129,6 +416,8 @@ native_openssl_set_named_curve (NativeOpenSsl *ptr, const char *curve_name)
 	if (nid == 0)
 		return NATIVE_OPENSSL_ERROR_UNKNOWN_CURVE_NAME;
 
+	if (ptr->ecdh)
+		EC_KEY_free (ptr->ecdh);
 	ptr->ecdh = EC_KEY_new_by_curve_name (nid);
 	if (!ptr->ecdh)
 		return NATIVE_OPENSSL_ERROR_INVALID_CURVE;
@@ -136,10 +425,332 @@ native_openssl_set_named_curve (NativeOpenSsl *ptr, const char *curve_name)
 	return 0;
 }
 
+#if HAVE_KERNEL_TLS
+
+#define TLS_RECORD_TYPE_ALERT		21
+#define TLS_RECORD_TYPE_APPLICATION_DATA	23
+
+/*
+ * OpenSSL discards the key block once the handshake is finished, so we derive
+ * it again from the master secret with the TLS 1.2 PRF (RFC 5246, section 5 and
+ * 6.3).  This only uses the one-shot HMAC() and the session's own secrets, so
+ * it's safe to call from several connections at once.  For the AEAD ciphers
+ * there are no MAC keys, so the layout is
+ *
+ *   client_write_key, server_write_key, client_write_IV[4], server_write_IV[4]
+ */
+static int
+ktls_derive_key_block (NativeOpenSsl *ptr, const EVP_MD *md, unsigned char *out, int olen)
+{
+	unsigned char seed [TLS_MD_KEY_EXPANSION_CONST_SIZE + 2 * SSL3_RANDOM_SIZE];
+	unsigned char buf [EVP_MAX_MD_SIZE + sizeof (seed)];
+	unsigned char a [EVP_MAX_MD_SIZE], block [EVP_MAX_MD_SIZE];
+	unsigned int a_len, block_len;
+	SSL *ssl = ptr->ssl;
+	const unsigned char *secret = ssl->session->master_key;
+	int secret_len = ssl->session->master_key_length;
+	int done = 0, chunk, ret = 0;
+
+	memcpy (seed, TLS_MD_KEY_EXPANSION_CONST, TLS_MD_KEY_EXPANSION_CONST_SIZE);
+	memcpy (seed + TLS_MD_KEY_EXPANSION_CONST_SIZE, ssl->s3->server_random, SSL3_RANDOM_SIZE);
+	memcpy (seed + TLS_MD_KEY_EXPANSION_CONST_SIZE + SSL3_RANDOM_SIZE, ssl->s3->client_random, SSL3_RANDOM_SIZE);
+
+	// A(1) = HMAC (secret, seed)
+	if (!HMAC (md, secret, secret_len, seed, sizeof (seed), a, &a_len))
+		goto out;
+
+	while (done < olen) {
+		// P_hash output: HMAC (secret, A(i) + seed)
+		memcpy (buf, a, a_len);
+		memcpy (buf + a_len, seed, sizeof (seed));
+		if (!HMAC (md, secret, secret_len, buf, a_len + sizeof (seed), block, &block_len))
+			goto out;
+
+		chunk = olen - done < (int)block_len ? olen - done : (int)block_len;
+		memcpy (out + done, block, chunk);
+		done += chunk;
+
+		// A(i+1) = HMAC (secret, A(i))
+		memcpy (buf, a, a_len);
+		if (!HMAC (md, secret, secret_len, buf, a_len, a, &a_len))
+			goto out;
+	}
+
+	ret = 1;
+out:
+	OPENSSL_cleanse (buf, sizeof (buf));
+	OPENSSL_cleanse (a, sizeof (a));
+	OPENSSL_cleanse (block, sizeof (block));
+	return ret;
+}
+
+static int
+ktls_set_crypto_info (int s, int direction, int key_len, const unsigned char *key,
+		      const unsigned char *salt, const unsigned char *seq)
+{
+	struct tls12_crypto_info_aes_gcm_128 info128;
+	struct tls12_crypto_info_aes_gcm_256 info256;
+	int ret;
+
+	if (key_len == TLS_CIPHER_AES_GCM_128_KEY_SIZE) {
+		memset (&info128, 0, sizeof (info128));
+		info128.info.version = TLS_1_2_VERSION;
+		info128.info.cipher_type = TLS_CIPHER_AES_GCM_128;
+		memcpy (info128.key, key, TLS_CIPHER_AES_GCM_128_KEY_SIZE);
+		memcpy (info128.salt, salt, TLS_CIPHER_AES_GCM_128_SALT_SIZE);
+		memcpy (info128.iv, seq, TLS_CIPHER_AES_GCM_128_IV_SIZE);
+		memcpy (info128.rec_seq, seq, TLS_CIPHER_AES_GCM_128_REC_SEQ_SIZE);
+		ret = setsockopt (s, SOL_TLS, direction, &info128, sizeof (info128));
+		OPENSSL_cleanse (&info128, sizeof (info128));
+	} else {
+		memset (&info256, 0, sizeof (info256));
+		info256.info.version = TLS_1_2_VERSION;
+		info256.info.cipher_type = TLS_CIPHER_AES_GCM_256;
+		memcpy (info256.key, key, TLS_CIPHER_AES_GCM_256_KEY_SIZE);
+		memcpy (info256.salt, salt, TLS_CIPHER_AES_GCM_256_SALT_SIZE);
+		memcpy (info256.iv, seq, TLS_CIPHER_AES_GCM_256_IV_SIZE);
+		memcpy (info256.rec_seq, seq, TLS_CIPHER_AES_GCM_256_REC_SEQ_SIZE);
+		ret = setsockopt (s, SOL_TLS, direction, &info256, sizeof (info256));
+		OPENSSL_cleanse (&info256, sizeof (info256));
+	}
+
+	return ret == 0;
+}
+
+/*
+ * Hands the record layer over to the kernel after a successful TLS 1.2 AES-GCM
+ * handshake.  Anything else (or a kernel without the "tls" module) silently keeps
+ * using SSL_read() / SSL_write().  Once the kernel owns the transmit side, OpenSSL
+ * can't take over the receive side anymore, so failing to install it fails the
+ * connection.
+ */
+static int
+ktls_enable (NativeOpenSsl *ptr, int s)
+{
+	unsigned char key_block [2 * (32 + 4)];
+	const unsigned char *client_key, *server_key, *client_salt, *server_salt;
+	const EVP_MD *md;
+	SSL *ssl = ptr->ssl;
+	int key_len, ret = 0;
+
+	if (SSL_version (ssl) != TLS1_2_VERSION)
+		return 0;
+
+	switch (EVP_CIPHER_CTX_nid (ssl->enc_write_ctx)) {
+	case NID_aes_128_gcm:
+		key_len = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+		md = EVP_sha256 ();
+		break;
+	case NID_aes_256_gcm:
+		key_len = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+		md = EVP_sha384 ();
+		break;
+	default:
+		return 0;
+	}
+
+	// The kernel can't take over records which OpenSSL has already buffered.
+	if (SSL_pending (ssl) || ssl->s3->rbuf.left || ssl->s3->wbuf.left)
+		return 0;
+
+	if (!ktls_derive_key_block (ptr, md, key_block, 2 * (key_len + 4)))
+		return 0;
+
+	client_key = key_block;
+	server_key = key_block + key_len;
+	client_salt = key_block + 2 * key_len;
+	server_salt = client_salt + 4;
+
+	if (setsockopt (s, SOL_TCP, TCP_ULP, "tls", sizeof ("tls")) < 0)
+		goto out;
+
+	if (!ktls_set_crypto_info (s, TLS_TX, key_len, ptr->is_server ? server_key : client_key,
+				   ptr->is_server ? server_salt : client_salt, ssl->s3->write_sequence))
+		goto out;
+	ptr->ktls_mode |= NATIVE_OPENSSL_KTLS_TX;
+
+	if (!ktls_set_crypto_info (s, TLS_RX, key_len, ptr->is_server ? client_key : server_key,
+				   ptr->is_server ? client_salt : server_salt, ssl->s3->read_sequence)) {
+		ret = NATIVE_OPENSSL_ERROR_KERNEL_TLS;
+		goto out;
+	}
+	ptr->ktls_mode |= NATIVE_OPENSSL_KTLS_RX;
+
+out:
+	OPENSSL_cleanse (key_block, sizeof (key_block));
+	return ret;
+}
+
+static int
+ktls_get_fd (NativeOpenSsl *ptr)
+{
+	return ptr->accepted > 0 ? ptr->accepted : ptr->socket;
+}
+
+static int
+ktls_write (NativeOpenSsl *ptr, const void *buf, int size)
+{
+	int s = ktls_get_fd (ptr);
+	int done = 0;
+	ssize_t ret;
+
+	while (done < size) {
+		ret = send (s, (const char *)buf + done, size - done, 0);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			// Partial write on a non-blocking socket; the I/O thread retries the rest.
+			return done > 0 ? done : -1;
+		}
+		done += ret;
+	}
+
+	return done;
+}
+
+static int
+ktls_send_alert (NativeOpenSsl *ptr, unsigned char level, unsigned char description)
+{
+	char cmsg_buf [CMSG_SPACE (sizeof (unsigned char))];
+	unsigned char alert [2] = { level, description };
+	struct cmsghdr *cmsg;
+	struct msghdr msg;
+	struct iovec iov;
+
+	memset (&msg, 0, sizeof (msg));
+	iov.iov_base = alert;
+	iov.iov_len = sizeof (alert);
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = cmsg_buf;
+	msg.msg_controllen = sizeof (cmsg_buf);
+
+	cmsg = CMSG_FIRSTHDR (&msg);
+	cmsg->cmsg_level = SOL_TLS;
+	cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+	cmsg->cmsg_len = CMSG_LEN (sizeof (unsigned char));
+	*CMSG_DATA (cmsg) = TLS_RECORD_TYPE_ALERT;
+
+	return sendmsg (ktls_get_fd (ptr), &msg, 0) == sizeof (alert);
+}
+
+/*
+ * Returns 0 once the peer's close_notify has been received and -1 on any other
+ * non-application-data record, mirroring SSL_read().
+ */
+static int
+ktls_read (NativeOpenSsl *ptr, void *buf, int size)
+{
+	char cmsg_buf [CMSG_SPACE (sizeof (unsigned char))];
+	struct cmsghdr *cmsg;
+	struct msghdr msg;
+	struct iovec iov;
+	unsigned char record_type;
+	ssize_t ret;
+
+	do {
+		memset (&msg, 0, sizeof (msg));
+		iov.iov_base = buf;
+		iov.iov_len = size;
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = cmsg_buf;
+		msg.msg_controllen = sizeof (cmsg_buf);
+
+		ret = recvmsg (ktls_get_fd (ptr), &msg, 0);
+	} while (ret < 0 && errno == EINTR);
+
+	if (ret <= 0)
+		return (int)ret;
+
+	cmsg = CMSG_FIRSTHDR (&msg);
+	if (!cmsg || cmsg->cmsg_level != SOL_TLS || cmsg->cmsg_type != TLS_GET_RECORD_TYPE)
+		return (int)ret;
+
+	record_type = *CMSG_DATA (cmsg);
+	if (record_type == TLS_RECORD_TYPE_APPLICATION_DATA)
+		return (int)ret;
+
+	if (record_type == TLS_RECORD_TYPE_ALERT && ret == 2 && ((unsigned char *)buf) [1] == SSL_AD_CLOSE_NOTIFY) {
+		ptr->ktls_shutdown |= SSL_RECEIVED_SHUTDOWN;
+		return 0;
+	}
+
+	return -1;
+}
+
+/*
+ * SSL_shutdown() can't be used once the kernel owns the sequence numbers;
+ * same return values: 0 after sending close_notify, 1 once the peer's has
+ * been received as well.
+ */
+static int
+ktls_shutdown (NativeOpenSsl *ptr)
+{
+	char buffer [SSL3_RT_MAX_PLAIN_LENGTH];
+	int ret;
+
+	if (!(ptr->ktls_shutdown & SSL_SENT_SHUTDOWN)) {
+		if (!ktls_send_alert (ptr, SSL3_AL_WARNING, SSL_AD_CLOSE_NOTIFY))
+			return -1;
+		ptr->ktls_shutdown |= SSL_SENT_SHUTDOWN;
+		SSL_set_shutdown (ptr->ssl, SSL_SENT_SHUTDOWN);
+		return (ptr->ktls_shutdown & SSL_RECEIVED_SHUTDOWN) ? 1 : 0;
+	}
+
+	while (!(ptr->ktls_shutdown & SSL_RECEIVED_SHUTDOWN)) {
+		if (ptr->ktls_mode & NATIVE_OPENSSL_KTLS_RX) {
+			ret = ktls_read (ptr, buffer, sizeof (buffer));
+		} else {
+			ret = SSL_read (ptr->ssl, buffer, sizeof (buffer));
+			if (ret <= 0 && (SSL_get_shutdown (ptr->ssl) & SSL_RECEIVED_SHUTDOWN))
+				ptr->ktls_shutdown |= SSL_RECEIVED_SHUTDOWN;
+		}
+		if (ret < 0 || (ret == 0 && !(ptr->ktls_shutdown & SSL_RECEIVED_SHUTDOWN)))
+			return -1;
+	}
+
+	return 1;
+}
+
+#endif
+
+void
+native_openssl_set_kernel_tls (NativeOpenSsl *ptr, int enable)
+{
+	ptr->ktls_requested = enable;
+}
+
+int
+native_openssl_get_kernel_tls (NativeOpenSsl *ptr)
+{
+	return ptr->ktls_mode;
+}
+
+static int
+native_openssl_handshake_finished (NativeOpenSsl *ptr, int s)
+{
+#if HAVE_KERNEL_TLS
+	if (ptr->ktls_requested)
+		return ktls_enable (ptr, s);
+#endif
+	return 0;
+}
+
 int
 native_openssl_shutdown (NativeOpenSsl *ptr)
 {
-	return SSL_shutdown(ptr->ssl);
+	NativeOpenSslMemoryStats *saved;
+	int ret;
+
+#if HAVE_KERNEL_TLS
+	if (ptr->ktls_mode & NATIVE_OPENSSL_KTLS_TX)
+		return ktls_shutdown (ptr);
+#endif
+	saved = memory_enter (ptr, 0);
+	ret = SSL_shutdown(ptr->ssl);
+	memory_leave (ptr, saved);
+	return ret;
 }
 
 void
@@ -162,12 +773,21 @@ native_openssl_destroy (NativeOpenSsl *ptr)
 		EC_KEY_free(ptr->ecdh);
 		ptr->ecdh = NULL;
 	}
+	if (ptr->memory_stats) {
+		memory_release_stats (ptr->memory_stats);
+		ptr->memory_stats = NULL;
+	}
+	if (ptr->session_cache) {
+		native_openssl_session_cache_close (ptr->session_cache);
+		ptr->session_cache = NULL;
+	}
 	free (ptr);
 }
 
 void
 native_openssl_close (NativeOpenSsl *ptr)
 {
+	native_openssl_io_unregister (ptr);
 	if (ptr->accepted > 0) {
 		close (ptr->accepted);
 		ptr->accepted = 0;
@@ -178,13 +798,32 @@ native_openssl_close (NativeOpenSsl *ptr)
 	}
 }
 
+static void
+rearm_quickack (NativeOpenSsl *ptr, BIO *bio)
+{
+#ifdef TCP_QUICKACK
+	int value = 1;
+	int s;
+
+	s = BIO_get_fd (bio, NULL);
+	if (s >= 0 && setsockopt (s, IPPROTO_TCP, TCP_QUICKACK, &value, sizeof (value)) == 0)
+		ptr->quickack_rearms++;
+#endif
+}
+
 static long
-dump_callback (BIO *bio, int cmd, const char *argp, int argi, long argl, long ret)
+socket_bio_callback (BIO *bio, int cmd, const char *argp, int argi, long argl, long ret)
 {
 	NativeOpenSsl *ptr;
 	
 	ptr = (NativeOpenSsl*)BIO_get_callback_arg (bio);
-	if (!ptr || !ptr->debug_callback) return ret;
+	if (!ptr) return ret;
+
+	if (cmd == BIO_CB_READ && (ptr->applied_socket_flags & NATIVE_OPENSSL_SOCKET_QUICKACK) &&
+	    ptr->ssl && SSL_in_init (ptr->ssl))
+		rearm_quickack (ptr, bio);
+
+	if (!ptr->debug_callback) return ret;
 	
 	if (cmd == (BIO_CB_READ|BIO_CB_RETURN))
 		ptr->debug_callback (cmd, argp, argi, (int)ret);
@@ -193,102 +832,819 @@ dump_callback (BIO *bio, int cmd, const char *argp, int argi, long argl, long re
 	return ret;
 }
 
-static void
-message_callback (int write_p, int version, int content_type, const void *buf,
-		  size_t len, SSL *ssl, void *arg)
+static void
+message_callback (int write_p, int version, int content_type, const void *buf,
+		  size_t len, SSL *ssl, void *arg)
+{
+	NativeOpenSsl *ptr = (NativeOpenSsl*)arg;
+	if (ptr->message_callback)
+		ptr->message_callback (write_p, version, content_type, buf, (int)len);
+}
+
+/*
+ * Counts completed handshakes; every one after the first is a renegotiation, no matter
+ * which side started it.  Its latency is measured from the first HANDSHAKE_START (on
+ * the server, that's when the HelloRequest is sent) to HANDSHAKE_DONE.
+ */
+static void
+info_callback (const SSL *ssl, int where, int ret)
+{
+	NativeOpenSsl *ptr = (NativeOpenSsl*)SSL_get_app_data (ssl);
+	long long elapsed;
+
+	if (!ptr)
+		return;
+
+	if (where & SSL_CB_HANDSHAKE_START) {
+		if (ptr->handshakes > 0 && !ptr->renegotiation_start)
+			ptr->renegotiation_start = get_time_usec ();
+	} else if (where & SSL_CB_HANDSHAKE_DONE) {
+		if (ptr->renegotiation_start) {
+			elapsed = get_time_usec () - ptr->renegotiation_start;
+			ptr->renegotiation_start = 0;
+			ptr->renegotiation_usec += elapsed;
+			if (elapsed > ptr->renegotiation_max_usec)
+				ptr->renegotiation_max_usec = elapsed;
+			ptr->renegotiations++;
+		}
+		ptr->handshakes++;
+	}
+}
+
+static void
+native_openssl_init_fd (NativeOpenSsl *ptr, int s)
+{
+	ptr->sbio = BIO_new_socket (s, BIO_NOCLOSE);
+	SSL_set_bio (ptr->ssl, ptr->sbio, ptr->sbio);
+	
+	if (ptr->debug_callback)
+		SSL_set_debug (ptr->ssl, 1);
+
+	if (ptr->debug_callback || (ptr->applied_socket_flags & NATIVE_OPENSSL_SOCKET_QUICKACK)) {
+		BIO_set_callback (ptr->sbio, socket_bio_callback);
+		BIO_set_callback_arg (ptr->sbio, (char *)ptr);
+	}
+	
+	if (ptr->message_callback) {
+		SSL_set_msg_callback (ptr->ssl, message_callback);
+		SSL_set_msg_callback_arg (ptr->ssl, (char*)ptr);
+	}
+}
+
+NativeOpenSsl *
+native_openssl_initialize (int debug, NativeOpenSslProtocol protocol, DebugCallback debug_callback, MessageCallback message_callback)
+{
+	NativeOpenSsl *ptr;
+
+	SSL_library_init ();
+	
+	ptr = calloc (1, sizeof (NativeOpenSsl));
+	ptr->debug = debug;
+	ptr->protocol = protocol;
+	ptr->debug_callback = debug_callback;
+	ptr->message_callback = message_callback;
+	ptr->backlog = 1;
+	ptr->verify_depth = -1;
+
+	if (memory_hooks_installed) {
+		ptr->memory_stats = calloc (1, sizeof (NativeOpenSslMemoryStats));
+		if (ptr->memory_stats)
+			ptr->memory_stats->refcount = 1;
+	}
+
+	return ptr;
+}
+
+static void
+native_openssl_error (NativeOpenSsl *ptr, const char *message)
+{
+	if (!ptr->debug)
+		return;
+
+	BIO *bio_err;
+	bio_err = BIO_new_fp (stderr, BIO_NOCLOSE);
+	printf ("ERROR: %s\n", message);
+	ERR_print_errors (bio_err);
+}
+
+/*
+ * Prepares a finished connection for the next native_openssl_connect() / native_openssl_bind():
+ * the sockets are closed and the SSL object is reset with SSL_clear(), so the context, the
+ * SSL object and its buffers are reused by native_openssl_create_connection() instead of
+ * being freed and allocated again.
+ */
+int
+native_openssl_reset (NativeOpenSsl *ptr)
+{
+	native_openssl_close (ptr);
+
+	ptr->applied_socket_flags = 0;
+	ptr->quickack_rearms = 0;
+	ptr->handshake_usec = 0;
+	ptr->ktls_mode = 0;
+	ptr->ktls_shutdown = 0;
+	ptr->handshakes = 0;
+	ptr->renegotiations = 0;
+	ptr->renegotiation_start = 0;
+	ptr->renegotiation_usec = 0;
+	ptr->renegotiation_max_usec = 0;
+
+	if (!ptr->ssl)
+		return 0;
+
+	// Frees the socket BIO; the session must not be resumed by accident.
+	SSL_set_bio (ptr->ssl, NULL, NULL);
+	ptr->sbio = NULL;
+	SSL_set_session (ptr->ssl, NULL);
+
+	if (!SSL_clear (ptr->ssl)) {
+		SSL_free (ptr->ssl);
+		ptr->ssl = NULL;
+		native_openssl_error (ptr, "Failed to reset connection.");
+		return NATIVE_OPENSSL_ERROR_CREATE_CONNECTION;
+	}
+
+	/*
+	 * SSL_clear() keeps whatever verify mode and callback the SSL object had; make sure
+	 * that they're the current ones, which still exist on the managed side.
+	 */
+	SSL_set_verify (ptr->ssl, ptr->verify_mode, ptr->verify_callback);
+	SSL_set_verify_depth (ptr->ssl, ptr->verify_depth);
+
+	return 0;
+}
+
+void
+native_openssl_get_reuse_stats (NativeOpenSsl *ptr, int *created, int *reused)
+{
+	*created = ptr->ssl_created;
+	*reused = ptr->ssl_reused;
+}
+
+int
+native_openssl_connect (NativeOpenSsl *ptr, const char *host, int port)
+{
+	NativeOpenSslMemoryStats *saved;
+	long long start;
+	int ret, s;
+	
+	s = init_client (ptr, host, port);
+	if (s < 0) {
+		fprintf (stderr, "Connect failed: %d (%s)\n", errno, strerror(errno));
+		return NATIVE_OPENSSL_ERROR_SOCKET;
+	}
+	
+	ptr->socket = s;
+	
+	apply_connected_socket_options (ptr, s);
+	native_openssl_init_fd (ptr, s);
+	
+	start = get_time_usec ();
+	saved = memory_enter (ptr, 1);
+	ret = SSL_connect (ptr->ssl);
+	memory_leave (ptr, saved);
+	ptr->handshake_usec = get_time_usec () - start;
+	if (ret != 1) {
+		native_openssl_error (ptr, "Connect failed");
+		return NATIVE_OPENSSL_ERROR_SSL_CONNECT;
+	}
+	
+	return native_openssl_handshake_finished (ptr, s);
+}
+
+int
+native_openssl_write (NativeOpenSsl *ptr, const void *buf, int offset, int size)
+{
+	NativeOpenSslMemoryStats *saved;
+	int ret;
+
+#if HAVE_KERNEL_TLS
+	if (ptr->ktls_mode & NATIVE_OPENSSL_KTLS_TX)
+		return ktls_write (ptr, buf + offset, size);
+#endif
+	saved = memory_enter (ptr, 0);
+	ret = SSL_write (ptr->ssl, buf + offset, size);
+	memory_leave (ptr, saved);
+	return ret;
+}
+
+int
+native_openssl_read (NativeOpenSsl *ptr, void *buf, int offset, int size)
+{
+	NativeOpenSslMemoryStats *saved;
+	int ret;
+
+#if HAVE_KERNEL_TLS
+	if (ptr->ktls_mode & NATIVE_OPENSSL_KTLS_RX)
+		return ktls_read (ptr, buf + offset, size);
+#endif
+	saved = memory_enter (ptr, 0);
+	ret = SSL_read (ptr->ssl, buf + offset, size);
+	memory_leave (ptr, saved);
+	return ret;
+}
+
+/*
+ * Starts a renegotiation on an established connection.  A client sends its ClientHello
+ * and completes the handshake right away; the server only sends a HelloRequest unless
+ * `wait' is set, otherwise the handshake completes inside the next native_openssl_read()
+ * once the client's ClientHello arrives.  The peer handles the renegotiation transparently
+ * inside its reads, so its reader must keep reading.
+ *
+ * The SSL object must not be used concurrently, so this isn't supported for connections
+ * driven by the I/O thread; with kernel TLS, the keys can't be changed anymore.
+ */
+int
+native_openssl_renegotiate (NativeOpenSsl *ptr, int wait)
+{
+	NativeOpenSslMemoryStats *saved;
+	int ret, err;
+
+	if (ptr->io_callback || ptr->ktls_mode)
+		return NATIVE_OPENSSL_ERROR_RENEGOTIATE;
+
+	saved = memory_enter (ptr, 1);
+	ret = SSL_renegotiate (ptr->ssl);
+	if (ret == 1)
+		ret = SSL_do_handshake (ptr->ssl);
+	if (ret == 1 && wait && ptr->is_server && SSL_renegotiate_pending (ptr->ssl)) {
+		/* The HelloRequest is out; wait for the ClientHello and run the full handshake. */
+		ptr->ssl->state = SSL_ST_ACCEPT;
+		ret = SSL_do_handshake (ptr->ssl);
+	}
+	if (ret != 1 && !wait) {
+		err = SSL_get_error (ptr->ssl, ret);
+		if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE)
+			ret = 1;
+	}
+	memory_leave (ptr, saved);
+
+	if (ret != 1) {
+		native_openssl_error (ptr, "Renegotiation failed.");
+		return NATIVE_OPENSSL_ERROR_RENEGOTIATE;
+	}
+
+	return 0;
+}
+
+void
+native_openssl_get_renegotiation_stats (NativeOpenSsl *ptr, int *count, int *pending,
+					long long *total_usec, long long *max_usec)
+{
+	*count = ptr->renegotiations;
+	*pending = ptr->renegotiation_start != 0;
+	*total_usec = ptr->renegotiation_usec;
+	*max_usec = ptr->renegotiation_max_usec;
+}
+
+/*
+ * Asynchronous I/O: connections registered with native_openssl_io_register() switch their
+ * socket to non-blocking mode and all of their SSL_read() / SSL_write() calls are made from
+ * one shared I/O thread, which poll()s on behalf of all of them.  Completions are reported
+ * through the connection's IoCompletionCallback, so no managed thread has to block while
+ * an operation is pending.
+ */
+
+#define IO_MAX_COMPLETIONS	64
+
+typedef struct {
+	IoCompletionCallback callback;
+	int op;
+	int result;
+} IoCompletion;
+
+static pthread_mutex_t io_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t io_dispatch_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t io_thread;
+static int io_thread_started;
+static int io_dispatching;
+static int io_wakeup_pipe [2] = { -1, -1 };
+static NativeOpenSsl *io_connections;
+
+static int
+io_get_fd (NativeOpenSsl *ptr)
+{
+	return ptr->accepted > 0 ? ptr->accepted : ptr->socket;
+}
+
+static int
+io_set_nonblocking (int fd, int nonblocking)
+{
+	int flags;
+
+	flags = fcntl (fd, F_GETFL);
+	if (flags < 0)
+		return -1;
+	flags = nonblocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+	return fcntl (fd, F_SETFL, flags);
+}
+
+static void
+io_wakeup (void)
+{
+	char c = 0;
+
+	while (write (io_wakeup_pipe [1], &c, 1) < 0 && errno == EINTR)
+		;
+}
+
+static void
+io_dispatch (IoCompletion *completions, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		completions [i].callback (completions [i].op, completions [i].result);
+}
+
+/*
+ * Makes as much progress on @op as possible without blocking.  Returns 1 once the
+ * operation is complete, with the same result that the blocking call would have
+ * returned in *result, and 0 if it has to wait for op->wait_events.
+ */
+static int
+io_try (NativeOpenSsl *ptr, int type, NativeOpenSslIoOp *op, int *result)
+{
+	int ret, err;
+
+	for (;;) {
+		if (type == NATIVE_OPENSSL_IO_READ)
+			ret = native_openssl_read (ptr, op->buf, 0, op->size);
+		else
+			ret = native_openssl_write (ptr, op->buf, op->done, op->size - op->done);
+
+		if (ret > 0) {
+			if (type == NATIVE_OPENSSL_IO_READ) {
+				*result = ret;
+				return 1;
+			}
+			op->done += ret;
+			if (op->done < op->size)
+				continue;
+			*result = op->done;
+			return 1;
+		}
+
+#if HAVE_KERNEL_TLS
+		if (ptr->ktls_mode & (type == NATIVE_OPENSSL_IO_READ ? NATIVE_OPENSSL_KTLS_RX : NATIVE_OPENSSL_KTLS_TX)) {
+			if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+				op->wait_events = type == NATIVE_OPENSSL_IO_READ ? POLLIN : POLLOUT;
+				return 0;
+			}
+			*result = ret;
+			return 1;
+		}
+#endif
+
+		err = SSL_get_error (ptr->ssl, ret);
+		if (err == SSL_ERROR_WANT_READ) {
+			op->wait_events = POLLIN;
+			return 0;
+		} else if (err == SSL_ERROR_WANT_WRITE) {
+			op->wait_events = POLLOUT;
+			return 0;
+		}
+
+		*result = ret;
+		return 1;
+	}
+}
+
+static void *
+io_thread_main (void *arg)
+{
+	IoCompletion completions [IO_MAX_COMPLETIONS];
+	NativeOpenSslIoOp *op;
+	NativeOpenSsl *ptr;
+	struct pollfd *fds = NULL;
+	int capacity = 0, nfds, ncompletions, timeout, result, i;
+	short events;
+	char drain [64];
+
+	for (;;) {
+		pthread_mutex_lock (&io_mutex);
+
+		ncompletions = 0;
+		timeout = -1;
+		nfds = 1;
+
+		for (ptr = io_connections; ptr; ptr = ptr->io_next) {
+			ptr->io_poll_index = -1;
+			events = 0;
+
+			for (i = 0; i < 2; i++) {
+				op = &ptr->io_ops [i];
+				if (!op->pending)
+					continue;
+
+				if (!op->wait_events || (op->revents & (op->wait_events | POLLERR | POLLHUP | POLLNVAL))) {
+					if (ncompletions == IO_MAX_COMPLETIONS) {
+						// Completion buffer is full; come back without waiting.
+						timeout = 0;
+						continue;
+					}
+
+					op->wait_events = 0;
+					op->revents = 0;
+					if (io_try (ptr, i, op, &result)) {
+						op->pending = 0;
+						completions [ncompletions].callback = ptr->io_callback;
+						completions [ncompletions].op = i;
+						completions [ncompletions].result = result;
+						ncompletions++;
+						continue;
+					}
+				}
+
+				events |= op->wait_events;
+			}
+
+			if (!events)
+				continue;
+
+			if (nfds == capacity || !fds) {
+				capacity = capacity ? capacity * 2 : 64;
+				fds = realloc (fds, capacity * sizeof (struct pollfd));
+			}
+
+			ptr->io_poll_index = nfds;
+			fds [nfds].fd = io_get_fd (ptr);
+			fds [nfds].events = events;
+			fds [nfds].revents = 0;
+			nfds++;
+		}
+
+		if (!fds) {
+			capacity = 64;
+			fds = malloc (capacity * sizeof (struct pollfd));
+		}
+		fds [0].fd = io_wakeup_pipe [0];
+		fds [0].events = POLLIN;
+		fds [0].revents = 0;
+
+		io_dispatching = ncompletions > 0;
+		pthread_mutex_unlock (&io_mutex);
+
+		// Callbacks may submit the next operation, so they must run without the lock.
+		if (ncompletions) {
+			io_dispatch (completions, ncompletions);
+			timeout = 0;
+
+			pthread_mutex_lock (&io_mutex);
+			io_dispatching = 0;
+			pthread_cond_broadcast (&io_dispatch_cond);
+			pthread_mutex_unlock (&io_mutex);
+		}
+
+		if (poll (fds, nfds, timeout) < 0 && errno != EINTR)
+			continue;
+
+		if (fds [0].revents & POLLIN) {
+			while (read (io_wakeup_pipe [0], drain, sizeof (drain)) > 0)
+				;
+		}
+
+		/*
+		 * Connections may have been unregistered (and freed) while we were polling,
+		 * so only the ones which are still on the list pick up their events.
+		 */
+		pthread_mutex_lock (&io_mutex);
+		for (ptr = io_connections; ptr; ptr = ptr->io_next) {
+			if (ptr->io_poll_index < 0 || ptr->io_poll_index >= nfds)
+				continue;
+			for (i = 0; i < 2; i++)
+				ptr->io_ops [i].revents = fds [ptr->io_poll_index].revents;
+		}
+		pthread_mutex_unlock (&io_mutex);
+	}
+
+	return NULL;
+}
+
+static int
+io_start_thread (void)
+{
+	if (io_thread_started)
+		return 0;
+
+	if (pipe (io_wakeup_pipe) < 0)
+		return -1;
+	io_set_nonblocking (io_wakeup_pipe [0], 1);
+	io_set_nonblocking (io_wakeup_pipe [1], 1);
+
+	if (pthread_create (&io_thread, NULL, io_thread_main, NULL) != 0) {
+		close (io_wakeup_pipe [0]);
+		close (io_wakeup_pipe [1]);
+		io_wakeup_pipe [0] = io_wakeup_pipe [1] = -1;
+		return -1;
+	}
+
+	pthread_detach (io_thread);
+	io_thread_started = 1;
+	return 0;
+}
+
+/*
+ * Must be called after the handshake; from then on, the connection must only be used
+ * through native_openssl_io_submit() until it is unregistered again.
+ */
+int
+native_openssl_io_register (NativeOpenSsl *ptr, IoCompletionCallback callback)
+{
+	int s = io_get_fd (ptr);
+
+	if (s <= 0 || !ptr->ssl || ptr->io_callback)
+		return NATIVE_OPENSSL_ERROR_ASYNC_IO;
+
+	pthread_mutex_lock (&io_mutex);
+	if (io_start_thread () < 0 || io_set_nonblocking (s, 1) < 0) {
+		pthread_mutex_unlock (&io_mutex);
+		return NATIVE_OPENSSL_ERROR_ASYNC_IO;
+	}
+
+	memset (ptr->io_ops, 0, sizeof (ptr->io_ops));
+	ptr->io_callback = callback;
+	ptr->io_poll_index = -1;
+	ptr->io_next = io_connections;
+	io_connections = ptr;
+	pthread_mutex_unlock (&io_mutex);
+	return 0;
+}
+
+/*
+ * Puts the socket back into blocking mode; operations which are still pending
+ * complete with -1.  Completions which the I/O thread has already picked up are
+ * dispatched before this returns, so the callback isn't used anymore afterwards.
+ */
+void
+native_openssl_io_unregister (NativeOpenSsl *ptr)
+{
+	IoCompletion completions [2];
+	NativeOpenSsl **link;
+	int ncompletions = 0, i;
+
+	if (!ptr->io_callback)
+		return;
+
+	pthread_mutex_lock (&io_mutex);
+	for (link = &io_connections; *link; link = &(*link)->io_next) {
+		if (*link == ptr) {
+			*link = ptr->io_next;
+			break;
+		}
+	}
+
+	for (i = 0; i < 2; i++) {
+		if (!ptr->io_ops [i].pending)
+			continue;
+		ptr->io_ops [i].pending = 0;
+		completions [ncompletions].callback = ptr->io_callback;
+		completions [ncompletions].op = i;
+		completions [ncompletions].result = -1;
+		ncompletions++;
+	}
+
+	ptr->io_callback = NULL;
+	ptr->io_next = NULL;
+	if (io_get_fd (ptr) > 0)
+		io_set_nonblocking (io_get_fd (ptr), 0);
+
+	// The callbacks themselves may unregister, which must not wait for itself.
+	while (io_dispatching && !pthread_equal (pthread_self (), io_thread))
+		pthread_cond_wait (&io_dispatch_cond, &io_mutex);
+	pthread_mutex_unlock (&io_mutex);
+
+	io_wakeup ();
+	io_dispatch (completions, ncompletions);
+}
+
+/*
+ * Starts a read or write of @size bytes at @buf, which must stay valid until the
+ * completion callback has been invoked.  At most one read and one write may be
+ * pending per connection.
+ */
+int
+native_openssl_io_submit (NativeOpenSsl *ptr, int op, void *buf, int size)
+{
+	NativeOpenSslIoOp *io_op;
+
+	if (op != NATIVE_OPENSSL_IO_READ && op != NATIVE_OPENSSL_IO_WRITE)
+		return NATIVE_OPENSSL_ERROR_ASYNC_IO;
+
+	pthread_mutex_lock (&io_mutex);
+	io_op = &ptr->io_ops [op];
+	if (!ptr->io_callback || io_op->pending) {
+		pthread_mutex_unlock (&io_mutex);
+		return NATIVE_OPENSSL_ERROR_ASYNC_IO;
+	}
+
+	io_op->buf = buf;
+	io_op->size = size;
+	io_op->done = 0;
+	io_op->wait_events = 0;
+	io_op->revents = 0;
+	io_op->pending = 1;
+	pthread_mutex_unlock (&io_mutex);
+
+	io_wakeup ();
+	return 0;
+}
+
+void
+native_openssl_set_listen_options (NativeOpenSsl *ptr, int backlog, int reuse_port)
 {
-	NativeOpenSsl *ptr = (NativeOpenSsl*)arg;
-	if (ptr->message_callback)
-		ptr->message_callback (write_p, version, content_type, buf, (int)len);
+	ptr->backlog = backlog > 0 ? backlog : SOMAXCONN;
+	ptr->reuse_port = reuse_port;
 }
 
-static void
-native_openssl_init_fd (NativeOpenSsl *ptr, int s)
+void
+native_openssl_set_socket_options (NativeOpenSsl *ptr, int flags, int send_buffer, int receive_buffer)
 {
-	ptr->sbio = BIO_new_socket (s, BIO_NOCLOSE);
-	SSL_set_bio (ptr->ssl, ptr->sbio, ptr->sbio);
-	
-	if (ptr->debug_callback) {
-		SSL_set_debug (ptr->ssl, 1);
-		BIO_set_callback (ptr->sbio, dump_callback);
-		BIO_set_callback_arg (ptr->sbio, (char *)ptr);
-	}
-	
-	if (ptr->message_callback) {
-		SSL_set_msg_callback (ptr->ssl, message_callback);
-		SSL_set_msg_callback_arg (ptr->ssl, (char*)ptr);
-	}
+	ptr->socket_flags = flags;
+	ptr->send_buffer = send_buffer;
+	ptr->receive_buffer = receive_buffer;
 }
 
-NativeOpenSsl *
-native_openssl_initialize (int debug, NativeOpenSslProtocol protocol, DebugCallback debug_callback, MessageCallback message_callback)
+/*
+ * Reports the options which actually took effect on the connected socket;
+ * the buffer sizes are the values returned by the kernel.
+ */
+int
+native_openssl_get_socket_options (NativeOpenSsl *ptr, int *flags, int *send_buffer, int *receive_buffer)
 {
-	NativeOpenSsl *ptr;
+	socklen_t len;
+	int s;
 
-	SSL_library_init ();
-	
-	ptr = calloc (1, sizeof (NativeOpenSsl));
-	ptr->debug = debug;
-	ptr->protocol = protocol;
-	ptr->debug_callback = debug_callback;
-	ptr->message_callback = message_callback;
-	return ptr;
+	s = ptr->accepted > 0 ? ptr->accepted : ptr->socket;
+	if (s <= 0)
+		return NATIVE_OPENSSL_ERROR_SOCKET;
+
+	*flags = ptr->applied_socket_flags;
+
+	len = sizeof (*send_buffer);
+	if (getsockopt (s, SOL_SOCKET, SO_SNDBUF, send_buffer, &len) < 0)
+		return NATIVE_OPENSSL_ERROR_SOCKET;
+
+	len = sizeof (*receive_buffer);
+	if (getsockopt (s, SOL_SOCKET, SO_RCVBUF, receive_buffer, &len) < 0)
+		return NATIVE_OPENSSL_ERROR_SOCKET;
+
+	return 0;
 }
 
-static void
-native_openssl_error (NativeOpenSsl *ptr, const char *message)
+long long
+native_openssl_get_handshake_time (NativeOpenSsl *ptr)
 {
-	if (!ptr->debug)
-		return;
-
-	BIO *bio_err;
-	bio_err = BIO_new_fp (stderr, BIO_NOCLOSE);
-	printf ("ERROR: %s\n", message);
-	ERR_print_errors (bio_err);
+	return ptr->handshake_usec;
 }
 
+/*
+ * How often TCP_QUICKACK has been re-armed during the handshake(s) on this
+ * connection; stays zero where the option isn't available.
+ */
 int
-native_openssl_connect (NativeOpenSsl *ptr, unsigned char ip[4], int port)
+native_openssl_get_quickack_count (NativeOpenSsl *ptr)
 {
-	int ret, s;
-	
-	s = init_client (ip, port);
-	if (s < 0) {
-		fprintf (stderr, "Connect failed: %d (%s)\n", errno, strerror(errno));
-		return NATIVE_OPENSSL_ERROR_SOCKET;
+	return ptr->quickack_rearms;
+}
+
+/*
+ * Upper bound for the file window which is mapped at a time when the data
+ * has to go through SSL_write().
+ */
+#define SEND_FILE_WINDOW	(4 * 1024 * 1024)
+
+static int
+send_region (NativeOpenSsl *ptr, const unsigned char *data, long long length, long long *done)
+{
+	long long remaining = length;
+	int chunk, ret;
+
+	while (remaining > 0) {
+		chunk = remaining > SEND_FILE_WINDOW ? SEND_FILE_WINDOW : (int)remaining;
+		ret = native_openssl_write (ptr, data, 0, chunk);
+		if (ret != chunk)
+			return NATIVE_OPENSSL_ERROR_SEND_FILE;
+		data += chunk;
+		remaining -= chunk;
+		*done += chunk;
 	}
-	
-	ptr->socket = s;
-	
-	native_openssl_init_fd (ptr, s);
-	
-	ret = SSL_connect (ptr->ssl);
-	if (ret != 1) {
-		native_openssl_error (ptr, "Connect failed");
-		return NATIVE_OPENSSL_ERROR_SSL_CONNECT;
+
+	return 0;
+}
+
+static int
+send_file_mmap (NativeOpenSsl *ptr, int fd, long long offset, long long length, long long *done)
+{
+	long long page_size = sysconf (_SC_PAGESIZE);
+	long long map_offset, delta, window;
+	void *map;
+	int ret;
+
+	while (length > 0) {
+		map_offset = offset & ~(page_size - 1);
+		delta = offset - map_offset;
+		window = length + delta > SEND_FILE_WINDOW ? SEND_FILE_WINDOW : length + delta;
+
+		map = mmap (NULL, window, PROT_READ, MAP_PRIVATE, fd, map_offset);
+		if (map == MAP_FAILED)
+			return NATIVE_OPENSSL_ERROR_SEND_FILE;
+		madvise (map, window, MADV_SEQUENTIAL);
+
+		ret = send_region (ptr, (unsigned char *)map + delta, window - delta, done);
+		munmap (map, window);
+		if (ret)
+			return ret;
+
+		offset += window - delta;
+		length -= window - delta;
 	}
-	
+
 	return 0;
 }
 
+#if HAVE_KERNEL_TLS
+static int
+send_file_kernel (NativeOpenSsl *ptr, int fd, long long offset, long long length, long long *done)
+{
+	off_t off = offset;
+	ssize_t ret;
+	size_t count;
+
+	while (length > 0) {
+		count = length > 0x7ffff000 ? 0x7ffff000 : (size_t)length;
+		ret = sendfile (ktls_get_fd (ptr), fd, &off, count);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		if (ret <= 0)
+			return NATIVE_OPENSSL_ERROR_SEND_FILE;
+		length -= ret;
+		*done += ret;
+	}
+
+	return 0;
+}
+#endif
+
+/*
+ * Streams @length bytes starting at @offset of @fd through the connection without
+ * copying them into managed memory: with kernel TLS, the file is handed to sendfile(),
+ * otherwise it is mapped in bounded windows and passed to SSL_write().
+ *
+ * The range must lie within the file; touching a mapped page past its end would
+ * raise SIGBUS.  The file must not be truncated while it's being sent.
+ */
 int
-native_openssl_write (NativeOpenSsl *ptr, const void *buf, int offset, int size)
+native_openssl_send_file (NativeOpenSsl *ptr, int fd, long long offset, long long length,
+			  long long *bytes_sent, long long *elapsed_usec)
 {
-	return SSL_write (ptr->ssl, buf + offset, size);
+	struct stat st;
+	long long start;
+	int ret;
+
+	*bytes_sent = 0;
+	*elapsed_usec = 0;
+
+	if (offset < 0 || length < 0)
+		return NATIVE_OPENSSL_ERROR_SEND_FILE;
+	if (fstat (fd, &st) < 0 || !S_ISREG (st.st_mode))
+		return NATIVE_OPENSSL_ERROR_SEND_FILE;
+	if (offset > st.st_size || length > st.st_size - offset)
+		return NATIVE_OPENSSL_ERROR_SEND_FILE;
+
+	start = get_time_usec ();
+
+#if HAVE_KERNEL_TLS
+	if (ptr->ktls_mode & NATIVE_OPENSSL_KTLS_TX)
+		ret = send_file_kernel (ptr, fd, offset, length, bytes_sent);
+	else
+#endif
+		ret = send_file_mmap (ptr, fd, offset, length, bytes_sent);
+
+	*elapsed_usec = get_time_usec () - start;
+	return ret;
 }
 
 int
-native_openssl_read (NativeOpenSsl *ptr, void *buf, int offset, int size)
+native_openssl_send_region (NativeOpenSsl *ptr, const void *data, long long length,
+			    long long *bytes_sent, long long *elapsed_usec)
 {
-	return SSL_read (ptr->ssl, buf + offset, size);
+	long long start;
+	int ret;
+
+	*bytes_sent = 0;
+	start = get_time_usec ();
+	ret = send_region (ptr, data, length, bytes_sent);
+	*elapsed_usec = get_time_usec () - start;
+	return ret;
 }
 
 int
-native_openssl_bind (NativeOpenSsl *ptr, unsigned char ip[4], int port)
+native_openssl_bind (NativeOpenSsl *ptr, const char *host, int port)
 {
 	int s;
 	
-	s = init_server (ip, port);
+	s = init_server (ptr, host, port);
 	if (s < 0) {
 		fprintf (stderr, "Bind failed: %d (%s)\n", errno, strerror(errno));
 		return NATIVE_OPENSSL_ERROR_SOCKET;
@@ -301,8 +1657,10 @@ native_openssl_bind (NativeOpenSsl *ptr, unsigned char ip[4], int port)
 int
 native_openssl_accept (NativeOpenSsl *ptr)
 {
-	struct sockaddr_in addr;
-	socklen_t len;
+	struct sockaddr_storage addr;
+	socklen_t len = sizeof (addr);
+	NativeOpenSslMemoryStats *saved;
+	long long start;
 	int ret, s;
 
 	s = accept (ptr->socket, (struct sockaddr *)&addr, &len);
@@ -313,15 +1671,20 @@ native_openssl_accept (NativeOpenSsl *ptr)
 	
 	ptr->accepted = s;
 	
+	apply_connected_socket_options (ptr, s);
 	native_openssl_init_fd (ptr, s);
 	
+	start = get_time_usec ();
+	saved = memory_enter (ptr, 1);
 	ret = SSL_accept (ptr->ssl);
+	memory_leave (ptr, saved);
+	ptr->handshake_usec = get_time_usec () - start;
 	if (ret <= 0) {
 		native_openssl_error(ptr, "Accept failed");
 		return NATIVE_OPENSSL_ERROR_SSL_ACCEPT;
 	}
 	
-	return 0;
+	return native_openssl_handshake_finished (ptr, s);
 }
 
 int
@@ -445,12 +1808,22 @@ void
 native_openssl_set_certificate_verify (NativeOpenSsl *ptr, int mode, VerifyCallback verify_cb,
 				       CertificateVerifyCallback cert_cb, int depth)
 {
+	ptr->verify_mode = mode;
+	ptr->verify_depth = depth;
+	ptr->verify_callback = verify_cb;
+
 	SSL_CTX_set_verify (ptr->ctx, mode, verify_cb);
 	if (cert_cb) {
 		ptr->cert_verify_callback = cert_cb;
 		SSL_CTX_set_cert_verify_callback(ptr->ctx, cert_verify_cb, ptr);
 	}
 	SSL_CTX_set_verify_depth (ptr->ctx, depth);
+
+	// SSL_new() copied the old settings into a reused SSL object.
+	if (ptr->ssl) {
+		SSL_set_verify (ptr->ssl, mode, verify_cb);
+		SSL_set_verify_depth (ptr->ssl, depth);
+	}
 }
 
 void
@@ -471,9 +1844,12 @@ native_openssl_free_private_key (EVP_PKEY *private_key)
 	EVP_PKEY_free (private_key);
 }
 
+static const unsigned char session_id_context[] = "NativeOpenSsl";
+
 int
 native_openssl_create_context (NativeOpenSsl *ptr, short client_p)
 {
+	NativeOpenSslMemoryStats *saved;
 	const SSL_METHOD *method;
 	
 	switch (ptr->protocol) {
@@ -490,13 +1866,21 @@ native_openssl_create_context (NativeOpenSsl *ptr, short client_p)
 
 	ptr->is_server = !client_p;
 	
+	saved = memory_enter (ptr, 0);
 	ptr->ctx = SSL_CTX_new (method);
+	memory_leave (ptr, saved);
 	if (!ptr->ctx) {
 		native_openssl_error(ptr, "Failed to create context.");
 		return NATIVE_OPENSSL_ERROR_CREATE_CONTEXT;
 	}
 
 	SSL_CTX_set_mode(ptr->ctx, SSL_MODE_AUTO_RETRY);
+	if (ptr->lean_mode)
+		SSL_CTX_set_mode (ptr->ctx, SSL_MODE_RELEASE_BUFFERS);
+
+	/* Required for session resumption when client certificates are verified. */
+	if (ptr->is_server)
+		SSL_CTX_set_session_id_context (ptr->ctx, session_id_context, sizeof (session_id_context) - 1);
 
 	return 0;
 
@@ -505,6 +1889,8 @@ native_openssl_create_context (NativeOpenSsl *ptr, short client_p)
 int
 native_openssl_create_connection (NativeOpenSsl *ptr)
 {
+	NativeOpenSslMemoryStats *saved;
+
 	if (ptr->is_server) {
 		if (!ptr->dh_params)
 			ptr->dh_params = get_dh512 ();
@@ -517,18 +1903,552 @@ native_openssl_create_connection (NativeOpenSsl *ptr)
 			SSL_CTX_set_tmp_ecdh (ptr->ctx, ptr->ecdh);
 	}
 
-	ptr->ssl = SSL_new (ptr->ctx);
-	if (!ptr->ssl) {
-		native_openssl_error(ptr, "Failed to create connection.");
-		return NATIVE_OPENSSL_ERROR_CREATE_CONNECTION;
+	if (ptr->ssl) {
+		// Left behind by native_openssl_reset().
+		ptr->ssl_reused++;
+	} else {
+		saved = memory_enter (ptr, 0);
+		ptr->ssl = SSL_new (ptr->ctx);
+		memory_leave (ptr, saved);
+		if (!ptr->ssl) {
+			native_openssl_error(ptr, "Failed to create connection.");
+			return NATIVE_OPENSSL_ERROR_CREATE_CONNECTION;
+		}
+		ptr->ssl_created++;
 	}
 	
 	SSL_set_options(ptr->ssl, SSL_OP_NO_TICKET | SSL_OP_NO_SSLv3 | SSL_OP_NO_SSLv2);
+	SSL_set_app_data (ptr->ssl, ptr);
+	SSL_set_info_callback (ptr->ssl, info_callback);
 
 	return 0;
 	
 }
 
+SSL_SESSION *
+native_openssl_get_session (NativeOpenSsl *ptr)
+{
+	return SSL_get1_session (ptr->ssl);
+}
+
+/*
+ * Must be called between native_openssl_create_connection() and
+ * native_openssl_connect(); SSL_set_session() takes its own reference.
+ */
+int
+native_openssl_set_session (NativeOpenSsl *ptr, SSL_SESSION *session)
+{
+	if (!SSL_set_session (ptr->ssl, session)) {
+		native_openssl_error (ptr, "Failed to set session.");
+		return NATIVE_OPENSSL_ERROR_INVALID_SESSION;
+	}
+
+	return 0;
+}
+
+void
+native_openssl_free_session (SSL_SESSION *session)
+{
+	SSL_SESSION_free (session);
+}
+
+int
+native_openssl_session_reused (NativeOpenSsl *ptr)
+{
+	return SSL_session_reused (ptr->ssl);
+}
+
+/*
+ * Shared memory session cache.
+ *
+ * The segment holds a header followed by fixed-size slots.  Slots are grouped into
+ * buckets of SESSION_CACHE_WAYS; a session id hashes to exactly one bucket, which is
+ * protected by one of SESSION_CACHE_STRIPES process-shared mutexes.  Within a bucket,
+ * expired slots are reused first, otherwise the least recently used one is evicted.
+ *
+ * Expiry uses the wall clock, since the monotonic clock is not comparable between
+ * processes; recency uses a counter in the header.
+ *
+ * Sessions which encode to more than SESSION_CACHE_MAX_DATA bytes - typically those
+ * with a large client certificate chain - are not cached and counted as rejected.
+ */
+
+#define SESSION_CACHE_MAGIC	0x4e4f5353
+#define SESSION_CACHE_VERSION	2
+#define SESSION_CACHE_WAYS	8
+#define SESSION_CACHE_STRIPES	64
+#define SESSION_CACHE_MAX_ID	SSL_MAX_SSL_SESSION_ID_LENGTH
+#define SESSION_CACHE_MAX_DATA	2048
+#define SESSION_CACHE_LOCK_TIMEOUT_MS	1000
+
+typedef struct {
+	unsigned int magic;
+	int version;
+	int buckets;
+	int timeout;
+	long long clock;
+	long long hits;
+	long long misses;
+	long long stores;
+	long long evictions;
+	long long rejected;
+	pthread_mutex_t stripes [SESSION_CACHE_STRIPES];
+} SessionCacheHeader;
+
+typedef struct {
+	long long expires;
+	long long last_used;
+	int id_len;
+	int data_len;
+	unsigned char id [SESSION_CACHE_MAX_ID];
+	unsigned char data [SESSION_CACHE_MAX_DATA];
+} SessionCacheSlot;
+
+struct _NativeOpenSslSessionCache {
+	int refcount;
+	size_t size;
+	SessionCacheHeader *header;
+	SessionCacheSlot *slots;
+};
+
+static size_t
+session_cache_size (int buckets)
+{
+	return sizeof (SessionCacheHeader) + (size_t)buckets * SESSION_CACHE_WAYS * sizeof (SessionCacheSlot);
+}
+
+static int
+session_cache_init_header (SessionCacheHeader *header, int buckets, int timeout)
+{
+	pthread_mutexattr_t attr;
+	int i;
+
+	if (pthread_mutexattr_init (&attr))
+		return 0;
+	pthread_mutexattr_setpshared (&attr, PTHREAD_PROCESS_SHARED);
+#ifdef __linux__
+	pthread_mutexattr_setrobust (&attr, PTHREAD_MUTEX_ROBUST);
+#endif
+
+	header->version = SESSION_CACHE_VERSION;
+	header->buckets = buckets;
+	header->timeout = timeout;
+	for (i = 0; i < SESSION_CACHE_STRIPES; i++)
+		pthread_mutex_init (&header->stripes [i], &attr);
+	pthread_mutexattr_destroy (&attr);
+
+	// Other processes wait for the magic before they touch anything else.
+	__sync_synchronize ();
+	header->magic = SESSION_CACHE_MAGIC;
+	return 1;
+}
+
+// Waits until the creator has sized and initialized the segment; returns the bucket count.
+static int
+session_cache_wait_ready (int fd)
+{
+	SessionCacheHeader *header;
+	struct stat st;
+	int i, buckets = 0;
+
+	for (i = 0; i < 1000; i++) {
+		if (fstat (fd, &st) == 0 && st.st_size >= (off_t)sizeof (SessionCacheHeader)) {
+			header = mmap (NULL, sizeof (SessionCacheHeader), PROT_READ, MAP_SHARED, fd, 0);
+			if (header == MAP_FAILED)
+				return 0;
+			if (header->magic == SESSION_CACHE_MAGIC && header->version == SESSION_CACHE_VERSION)
+				buckets = header->buckets;
+			munmap (header, sizeof (SessionCacheHeader));
+			if (buckets > 0 && st.st_size >= (off_t)session_cache_size (buckets))
+				return buckets;
+		}
+		usleep (1000);
+	}
+
+	return 0;
+}
+
+/*
+ * Opens the segment with the given name, creating it if it doesn't exist yet; slots
+ * and timeout (in seconds) only take effect when it is created.  The name must start
+ * with a slash and should be unique per listening service.
+ */
+NativeOpenSslSessionCache *
+native_openssl_session_cache_open (const char *name, int slots, int timeout)
+{
+	NativeOpenSslSessionCache *cache;
+	void *mapping;
+	int fd, buckets, created = 0;
+	size_t size;
+
+	if (slots <= 0 || timeout <= 0)
+		return NULL;
+
+	buckets = (slots + SESSION_CACHE_WAYS - 1) / SESSION_CACHE_WAYS;
+
+	fd = shm_open (name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd >= 0) {
+		created = 1;
+		if (ftruncate (fd, session_cache_size (buckets)) < 0) {
+			close (fd);
+			shm_unlink (name);
+			return NULL;
+		}
+	} else if (errno == EEXIST) {
+		fd = shm_open (name, O_RDWR, 0600);
+		if (fd < 0)
+			return NULL;
+		buckets = session_cache_wait_ready (fd);
+		if (!buckets) {
+			close (fd);
+			return NULL;
+		}
+	} else {
+		return NULL;
+	}
+
+	size = session_cache_size (buckets);
+	mapping = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close (fd);
+	if (mapping == MAP_FAILED) {
+		if (created)
+			shm_unlink (name);
+		return NULL;
+	}
+
+	if (created && !session_cache_init_header (mapping, buckets, timeout)) {
+		munmap (mapping, size);
+		shm_unlink (name);
+		return NULL;
+	}
+
+	cache = calloc (1, sizeof (NativeOpenSslSessionCache));
+	if (!cache) {
+		munmap (mapping, size);
+		return NULL;
+	}
+
+	cache->refcount = 1;
+	cache->size = size;
+	cache->header = mapping;
+	cache->slots = (SessionCacheSlot *)((char *)mapping + sizeof (SessionCacheHeader));
+	return cache;
+}
+
+void
+native_openssl_session_cache_close (NativeOpenSslSessionCache *cache)
+{
+	if (__sync_sub_and_fetch (&cache->refcount, 1) > 0)
+		return;
+
+	munmap (cache->header, cache->size);
+	free (cache);
+}
+
+// The segment stays around until the last process has closed it.
+int
+native_openssl_session_cache_unlink (const char *name)
+{
+	return shm_unlink (name) == 0 || errno == ENOENT;
+}
+
+static unsigned int
+session_cache_hash (const unsigned char *id, int id_len)
+{
+	unsigned int hash = 2166136261u;
+	int i;
+
+	for (i = 0; i < id_len; i++) {
+		hash ^= id [i];
+		hash *= 16777619u;
+	}
+
+	// FNV-1a alone spreads poorly into the low bits that pick the bucket.
+	hash ^= hash >> 16;
+	hash *= 0x45d9f3bu;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+// Returns NULL if the stripe could not be locked; the caller must then skip the operation.
+static pthread_mutex_t *
+session_cache_lock (NativeOpenSslSessionCache *cache, int bucket)
+{
+	pthread_mutex_t *mutex;
+#ifndef __linux__
+	struct timespec delay = { 0, 1000000 };
+	int i;
+#endif
+
+	mutex = &cache->header->stripes [bucket % SESSION_CACHE_STRIPES];
+#ifdef __linux__
+	/*
+	 * The owner died while holding the lock.  A slot it was writing may be garbage, but
+	 * then the session doesn't decode and the lookup removes it.
+	 */
+	if (pthread_mutex_lock (mutex) == EOWNERDEAD)
+		pthread_mutex_consistent (mutex);
+#else
+	/*
+	 * There are no robust mutexes (nor pthread_mutex_timedlock()) on OS X, so a stripe
+	 * stays locked forever if its owner dies while holding it.  Instead of hanging all
+	 * other workers, give up after SESSION_CACHE_LOCK_TIMEOUT_MS: a cache which can't
+	 * be used just means full handshakes.
+	 */
+	for (i = 0; pthread_mutex_trylock (mutex) != 0; i++) {
+		if (i == SESSION_CACHE_LOCK_TIMEOUT_MS)
+			return NULL;
+		nanosleep (&delay, NULL);
+	}
+#endif
+	return mutex;
+}
+
+static SessionCacheSlot *
+session_cache_find (NativeOpenSslSessionCache *cache, int bucket, const unsigned char *id, int id_len, long long now)
+{
+	SessionCacheSlot *slot;
+	int i;
+
+	for (i = 0; i < SESSION_CACHE_WAYS; i++) {
+		slot = &cache->slots [bucket * SESSION_CACHE_WAYS + i];
+		if (slot->expires > now && slot->id_len == id_len && !memcmp (slot->id, id, id_len))
+			return slot;
+	}
+
+	return NULL;
+}
+
+// Returns zero if the session was not cached, for instance because it is too large.
+int
+native_openssl_session_cache_store (NativeOpenSslSessionCache *cache, const unsigned char *id, int id_len,
+				    const unsigned char *data, int data_len)
+{
+	SessionCacheSlot *slot, *victim = NULL;
+	pthread_mutex_t *mutex;
+	long long now;
+	int bucket, i;
+
+	if (id_len <= 0 || id_len > SESSION_CACHE_MAX_ID || data_len <= 0)
+		return 0;
+	if (data_len > SESSION_CACHE_MAX_DATA) {
+		__sync_add_and_fetch (&cache->header->rejected, 1);
+		return 0;
+	}
+
+	now = time (NULL);
+	bucket = session_cache_hash (id, id_len) % cache->header->buckets;
+	mutex = session_cache_lock (cache, bucket);
+	if (!mutex)
+		return 0;
+
+	victim = session_cache_find (cache, bucket, id, id_len, now);
+	for (i = 0; !victim && i < SESSION_CACHE_WAYS; i++) {
+		slot = &cache->slots [bucket * SESSION_CACHE_WAYS + i];
+		if (slot->expires <= now)
+			victim = slot;
+	}
+	if (!victim) {
+		victim = &cache->slots [bucket * SESSION_CACHE_WAYS];
+		for (i = 1; i < SESSION_CACHE_WAYS; i++) {
+			slot = &cache->slots [bucket * SESSION_CACHE_WAYS + i];
+			if (slot->last_used < victim->last_used)
+				victim = slot;
+		}
+		__sync_add_and_fetch (&cache->header->evictions, 1);
+	}
+
+	victim->expires = now + cache->header->timeout;
+	victim->last_used = __sync_add_and_fetch (&cache->header->clock, 1);
+	victim->id_len = id_len;
+	victim->data_len = data_len;
+	memcpy (victim->id, id, id_len);
+	memcpy (victim->data, data, data_len);
+
+	pthread_mutex_unlock (mutex);
+	__sync_add_and_fetch (&cache->header->stores, 1);
+	return 1;
+}
+
+// Returns the size of the cached data, zero on a miss or -1 if the buffer is too small.
+int
+native_openssl_session_cache_lookup (NativeOpenSslSessionCache *cache, const unsigned char *id, int id_len,
+				     unsigned char *data, int size)
+{
+	SessionCacheSlot *slot;
+	pthread_mutex_t *mutex;
+	int bucket, ret = 0;
+
+	if (id_len <= 0 || id_len > SESSION_CACHE_MAX_ID)
+		return 0;
+
+	bucket = session_cache_hash (id, id_len) % cache->header->buckets;
+	mutex = session_cache_lock (cache, bucket);
+	if (!mutex) {
+		__sync_add_and_fetch (&cache->header->misses, 1);
+		return 0;
+	}
+
+	slot = session_cache_find (cache, bucket, id, id_len, time (NULL));
+	if (slot && slot->data_len > size) {
+		ret = -1;
+	} else if (slot) {
+		slot->last_used = __sync_add_and_fetch (&cache->header->clock, 1);
+		memcpy (data, slot->data, slot->data_len);
+		ret = slot->data_len;
+	}
+
+	pthread_mutex_unlock (mutex);
+	__sync_add_and_fetch (ret > 0 ? &cache->header->hits : &cache->header->misses, 1);
+	return ret;
+}
+
+void
+native_openssl_session_cache_remove (NativeOpenSslSessionCache *cache, const unsigned char *id, int id_len)
+{
+	SessionCacheSlot *slot;
+	pthread_mutex_t *mutex;
+	int bucket;
+
+	if (id_len <= 0 || id_len > SESSION_CACHE_MAX_ID)
+		return;
+
+	bucket = session_cache_hash (id, id_len) % cache->header->buckets;
+	mutex = session_cache_lock (cache, bucket);
+	if (!mutex)
+		return;
+
+	slot = session_cache_find (cache, bucket, id, id_len, time (NULL));
+	if (slot)
+		slot->expires = 0;
+
+	pthread_mutex_unlock (mutex);
+}
+
+// Totals of all processes sharing the segment.
+void
+native_openssl_session_cache_get_stats (NativeOpenSslSessionCache *cache, int *capacity, long long *hits,
+					long long *misses, long long *stores, long long *evictions, long long *rejected)
+{
+	*capacity = cache->header->buckets * SESSION_CACHE_WAYS;
+	*hits = cache->header->hits;
+	*misses = cache->header->misses;
+	*stores = cache->header->stores;
+	*evictions = cache->header->evictions;
+	*rejected = cache->header->rejected;
+}
+
+static int
+session_cache_new_cb (SSL *ssl, SSL_SESSION *session)
+{
+	NativeOpenSsl *ptr = SSL_get_app_data (ssl);
+	unsigned char data [SESSION_CACHE_MAX_DATA], *p = data;
+	const unsigned char *id;
+	unsigned int id_len;
+	int len;
+
+	len = i2d_SSL_SESSION (session, NULL);
+	if (len <= 0)
+		return 0;
+	if (len > SESSION_CACHE_MAX_DATA) {
+		__sync_add_and_fetch (&ptr->session_cache->header->rejected, 1);
+		return 0;
+	}
+
+	i2d_SSL_SESSION (session, &p);
+	id = SSL_SESSION_get_id (session, &id_len);
+	native_openssl_session_cache_store (ptr->session_cache, id, id_len, data, len);
+
+	// We did not keep a reference.
+	return 0;
+}
+
+static SSL_SESSION *
+session_cache_get_cb (SSL *ssl, unsigned char *id, int id_len, int *copy)
+{
+	NativeOpenSsl *ptr = SSL_get_app_data (ssl);
+	unsigned char data [SESSION_CACHE_MAX_DATA];
+	const unsigned char *p = data;
+	SSL_SESSION *session;
+	int len;
+
+	len = native_openssl_session_cache_lookup (ptr->session_cache, id, id_len, data, sizeof (data));
+	if (len <= 0)
+		return NULL;
+
+	session = d2i_SSL_SESSION (NULL, &p, len);
+	if (!session) {
+		native_openssl_session_cache_remove (ptr->session_cache, id, id_len);
+		return NULL;
+	}
+
+	// OpenSSL takes over our reference.
+	*copy = 0;
+	return session;
+}
+
+static void
+session_cache_remove_cb (SSL_CTX *ctx, SSL_SESSION *session)
+{
+	NativeOpenSsl *ptr = SSL_CTX_get_app_data (ctx);
+	const unsigned char *id;
+	unsigned int id_len;
+
+	if (!ptr || !ptr->session_cache)
+		return;
+
+	id = SSL_SESSION_get_id (session, &id_len);
+	native_openssl_session_cache_remove (ptr->session_cache, id, id_len);
+}
+
+/*
+ * Server only: sessions are stored in and looked up from the shared cache instead of
+ * the context's internal one, so it doesn't matter which process a client reconnects to.
+ */
+int
+native_openssl_set_session_cache (NativeOpenSsl *ptr, NativeOpenSslSessionCache *cache)
+{
+	if (ptr->session_cache == cache)
+		return 0;
+	if (!ptr->is_server || !ptr->ctx || ptr->session_cache)
+		return NATIVE_OPENSSL_ERROR_SESSION_CACHE;
+
+	__sync_add_and_fetch (&cache->refcount, 1);
+	ptr->session_cache = cache;
+
+	SSL_CTX_set_app_data (ptr->ctx, ptr);
+	SSL_CTX_set_timeout (ptr->ctx, cache->header->timeout);
+	SSL_CTX_set_session_cache_mode (ptr->ctx, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+	SSL_CTX_sess_set_new_cb (ptr->ctx, session_cache_new_cb);
+	SSL_CTX_sess_set_get_cb (ptr->ctx, session_cache_get_cb);
+	SSL_CTX_sess_set_remove_cb (ptr->ctx, session_cache_remove_cb);
+	return 0;
+}
+
+/*
+ * An idle connection is only healthy if nothing is waiting on the socket:
+ * readable means either EOF or an unexpected record such as close_notify.
+ */
+int
+native_openssl_is_alive (NativeOpenSsl *ptr)
+{
+	struct pollfd pfd;
+	int s;
+
+	s = ptr->accepted > 0 ? ptr->accepted : ptr->socket;
+	if (s <= 0 || !ptr->ssl)
+		return 0;
+
+	if (SSL_get_shutdown (ptr->ssl) || SSL_pending (ptr->ssl))
+		return 0;
+
+	pfd.fd = s;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	return poll (&pfd, 1, 0) == 0;
+}
+
 short
 native_openssl_get_current_cipher (NativeOpenSsl *ptr)
 {
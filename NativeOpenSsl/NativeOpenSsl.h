@@ -21,6 +21,8 @@ typedef int (* VerifyCallback) (int ok, X509_STORE_CTX *ctx);
 
 typedef int (* CertificateVerifyCallback) (X509_STORE_CTX *ctx, X509 *cert);
 
+typedef void (* IoCompletionCallback) (int op, int result);
+
 typedef enum {
 	OK,
 	NATIVE_OPENSSL_ERROR_SOCKET,
@@ -36,7 +38,13 @@ typedef enum {
 	NATIVE_OPENSSL_ERROR_CREATE_CONNECTION,
 	NATIVE_OPENSSL_ERROR_INVALID_CIPHER,
 	NATIVE_OPENSSL_ERROR_UNKNOWN_CURVE_NAME,
-	NATIVE_OPENSSL_ERROR_INVALID_CURVE
+	NATIVE_OPENSSL_ERROR_INVALID_CURVE,
+	NATIVE_OPENSSL_ERROR_SEND_FILE,
+	NATIVE_OPENSSL_ERROR_INVALID_SESSION,
+	NATIVE_OPENSSL_ERROR_ASYNC_IO,
+	NATIVE_OPENSSL_ERROR_RENEGOTIATE,
+	NATIVE_OPENSSL_ERROR_SESSION_CACHE,
+	NATIVE_OPENSSL_ERROR_KERNEL_TLS
 } NativeOpenSslError;
 
 typedef enum {
@@ -45,22 +53,100 @@ typedef enum {
 	NATIVE_OPENSSL_PROTOCOL_TLS12
 } NativeOpenSslProtocol;
 
+typedef enum {
+	NATIVE_OPENSSL_SOCKET_NODELAY	= 1,
+	NATIVE_OPENSSL_SOCKET_FASTOPEN	= 2,
+	NATIVE_OPENSSL_SOCKET_QUICKACK	= 4
+} NativeOpenSslSocketFlags;
+
+typedef enum {
+	NATIVE_OPENSSL_KTLS_TX	= 1,
+	NATIVE_OPENSSL_KTLS_RX	= 2
+} NativeOpenSslKernelTlsMode;
+
+typedef enum {
+	NATIVE_OPENSSL_IO_READ,
+	NATIVE_OPENSSL_IO_WRITE
+} NativeOpenSslIoOpType;
+
+/*
+ * A read or write which has been handed to the I/O thread; wait_events are the
+ * poll() events it is blocked on, or zero if it should be (re)tried right away.
+ */
+typedef struct {
+	int pending;
+	unsigned char *buf;
+	int size;
+	int done;
+	short wait_events;
+	short revents;
+} NativeOpenSslIoOp;
+
+/*
+ * Native memory attributed to a connection by the counting allocator hooks.  Each
+ * allocation holds a reference, so this may outlive the connection itself.
+ */
 typedef struct {
+	int refcount;
+	int in_handshake;
+	long long live_bytes;
+	long long peak_bytes;
+	long long allocations;
+	long long handshake_allocations;
+	long long handshake_bytes;
+} NativeOpenSslMemoryStats;
+
+/*
+ * Session cache in a named shared memory segment, so several worker processes
+ * serving the same port can resume each other's sessions.
+ */
+typedef struct _NativeOpenSslSessionCache NativeOpenSslSessionCache;
+
+typedef struct _NativeOpenSsl NativeOpenSsl;
+
+struct _NativeOpenSsl {
 	int debug;
 	NativeOpenSslProtocol protocol;
 	int is_server;
 	int socket;
 	int accepted;
+	int backlog;
+	int reuse_port;
+	int socket_flags;
+	int applied_socket_flags;
+	int quickack_rearms;
+	int send_buffer;
+	int receive_buffer;
+	long long handshake_usec;
+	int ktls_requested;
+	int ktls_mode;
+	int ktls_shutdown;
+	int lean_mode;
+	int ssl_created;
+	int ssl_reused;
+	int handshakes;
+	int renegotiations;
+	long long renegotiation_start;
+	long long renegotiation_usec;
+	long long renegotiation_max_usec;
+	NativeOpenSslMemoryStats *memory_stats;
+	NativeOpenSslSessionCache *session_cache;
 	SSL_CTX *ctx;
 	SSL *ssl;
 	BIO *sbio;
 	DebugCallback debug_callback;
 	MessageCallback message_callback;
+	int verify_mode;
+	int verify_depth;
 	VerifyCallback verify_callback;
 	CertificateVerifyCallback cert_verify_callback;
 	DH *dh_params;
 	EC_KEY *ecdh;
-} NativeOpenSsl;
+	IoCompletionCallback io_callback;
+	NativeOpenSslIoOp io_ops [2];
+	int io_poll_index;
+	NativeOpenSsl *io_next;
+};
 
 NativeOpenSsl *
 native_openssl_initialize (int debug, NativeOpenSslProtocol protocol, DebugCallback debug_callback, MessageCallback message_callback);
@@ -72,20 +158,75 @@ int
 native_openssl_set_named_curve (NativeOpenSsl *ptr, const char *curve_name);
 
 int
-native_openssl_connect (NativeOpenSsl *ptr, unsigned char ip[4], int port);
+native_openssl_connect (NativeOpenSsl *ptr, const char *host, int port);
+
+void
+native_openssl_set_listen_options (NativeOpenSsl *ptr, int backlog, int reuse_port);
+
+void
+native_openssl_set_socket_options (NativeOpenSsl *ptr, int flags, int send_buffer, int receive_buffer);
+
+int
+native_openssl_get_socket_options (NativeOpenSsl *ptr, int *flags, int *send_buffer, int *receive_buffer);
+
+long long
+native_openssl_get_handshake_time (NativeOpenSsl *ptr);
+
+int
+native_openssl_get_quickack_count (NativeOpenSsl *ptr);
 
 int
-native_openssl_bind (NativeOpenSsl *ptr, unsigned char ip[4], int port);
+native_openssl_bind (NativeOpenSsl *ptr, const char *host, int port);
 
 int
 native_openssl_accept (NativeOpenSsl *ptr);
 
+void
+native_openssl_set_kernel_tls (NativeOpenSsl *ptr, int enable);
+
+int
+native_openssl_get_kernel_tls (NativeOpenSsl *ptr);
+
 int
 native_openssl_write (NativeOpenSsl *ptr, const void *buf, int offset, int size);
 
 int
 native_openssl_read (NativeOpenSsl *ptr, void *buf, int offset, int size);
 
+int
+native_openssl_renegotiate (NativeOpenSsl *ptr, int wait);
+
+void
+native_openssl_get_renegotiation_stats (NativeOpenSsl *ptr, int *count, int *pending,
+					long long *total_usec, long long *max_usec);
+
+int
+native_openssl_install_memory_hooks (void);
+
+int
+native_openssl_get_memory_stats (NativeOpenSsl *ptr, long long *live_bytes, long long *peak_bytes,
+				 long long *allocations, long long *handshake_allocations, long long *handshake_bytes);
+
+void
+native_openssl_set_lean_mode (NativeOpenSsl *ptr, int enable);
+
+int
+native_openssl_io_register (NativeOpenSsl *ptr, IoCompletionCallback callback);
+
+void
+native_openssl_io_unregister (NativeOpenSsl *ptr);
+
+int
+native_openssl_io_submit (NativeOpenSsl *ptr, int op, void *buf, int size);
+
+int
+native_openssl_send_file (NativeOpenSsl *ptr, int fd, long long offset, long long length,
+			  long long *bytes_sent, long long *elapsed_usec);
+
+int
+native_openssl_send_region (NativeOpenSsl *ptr, const void *data, long long length,
+			    long long *bytes_sent, long long *elapsed_usec);
+
 int
 native_openssl_load_certificate_from_pkcs12 (NativeOpenSsl *ptr, const void *buf, int len,
 					     const char *password, int passlen,
@@ -131,12 +272,60 @@ native_openssl_destroy (NativeOpenSsl *ptr);
 void
 native_openssl_close (NativeOpenSsl *ptr);
 
+int
+native_openssl_reset (NativeOpenSsl *ptr);
+
+void
+native_openssl_get_reuse_stats (NativeOpenSsl *ptr, int *created, int *reused);
+
 void
 native_openssl_free_certificate (X509 *certificate);
 
 void
 native_openssl_free_private_key (EVP_PKEY *private_key);
 
+SSL_SESSION *
+native_openssl_get_session (NativeOpenSsl *ptr);
+
+int
+native_openssl_set_session (NativeOpenSsl *ptr, SSL_SESSION *session);
+
+void
+native_openssl_free_session (SSL_SESSION *session);
+
+int
+native_openssl_session_reused (NativeOpenSsl *ptr);
+
+NativeOpenSslSessionCache *
+native_openssl_session_cache_open (const char *name, int slots, int timeout);
+
+void
+native_openssl_session_cache_close (NativeOpenSslSessionCache *cache);
+
+int
+native_openssl_session_cache_unlink (const char *name);
+
+int
+native_openssl_session_cache_store (NativeOpenSslSessionCache *cache, const unsigned char *id, int id_len,
+				    const unsigned char *data, int data_len);
+
+int
+native_openssl_session_cache_lookup (NativeOpenSslSessionCache *cache, const unsigned char *id, int id_len,
+				     unsigned char *data, int size);
+
+void
+native_openssl_session_cache_remove (NativeOpenSslSessionCache *cache, const unsigned char *id, int id_len);
+
+void
+native_openssl_session_cache_get_stats (NativeOpenSslSessionCache *cache, int *capacity, long long *hits,
+					long long *misses, long long *stores, long long *evictions, long long *rejected);
+
+int
+native_openssl_set_session_cache (NativeOpenSsl *ptr, NativeOpenSslSessionCache *cache);
+
+int
+native_openssl_is_alive (NativeOpenSsl *ptr);
+
 short
 native_openssl_get_current_cipher (NativeOpenSsl *ptr);
 